@@ -0,0 +1,222 @@
+/******************************************************************************
+* File Name:   bench_collide.c
+*
+* Description: This file shows the collision benchmark of the host
+*              simulation. A fleet of sensor hubs, configured alike at the
+*              same time, publishes on the advertising bearer, and the
+*              benchmark counts the advertising events which overlap on air
+*              and the messages none of whose transmissions got through.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "mesh_sched.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+// Defaults of the fleet and of the Network Transmit state of its nodes
+#define BENCH_COLLIDE_NODES                     50
+#define BENCH_COLLIDE_TRANSMITS                 3
+#define BENCH_COLLIDE_INTERVAL_MS               20
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t    start;              // Start of the advertising event in usec
+    uint64_t    end;                // End of the advertising event in usec
+    uint32_t    pdu;                // Network PDU of the fleet the event transmits
+    uint8_t     collided;           // The event overlaps another one
+} bench_event_t;
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+static int bench_event_compare(const void *p_a, const void *p_b)
+{
+    const bench_event_t *p_ea = (const bench_event_t *)p_a;
+    const bench_event_t *p_eb = (const bench_event_t *)p_b;
+
+    return (p_ea->start > p_eb->start) - (p_ea->start < p_eb->start);
+}
+
+/* Random advertising delay of the controller, the same for every run */
+static uint32_t bench_adv_delay(uint32_t *p_state)
+{
+    uint32_t x = *p_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x % (SIM_AIR_ADV_DELAY_US + 1);
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opts;
+    sim_tx_t *p_tx;
+    bench_event_t *p_events;
+    uint8_t *p_pdu_ok;
+    uint32_t nodes = BENCH_COLLIDE_NODES;
+    uint32_t transmits = BENCH_COLLIDE_TRANSMITS;
+    uint32_t interval = BENCH_COLLIDE_INTERVAL_MS;
+    uint32_t count, pdus, events, collided, lost, ok;
+    uint32_t rng = 1;
+    uint64_t max_end, air_us;
+    uint32_t i, k, p, e, m;
+    int a;
+
+    // --nodes, --transmits and --transmit-interval are specific to this program
+    for (a = 1; a < argc; )
+    {
+        if ((0 == strcmp(argv[a], "--nodes")) && (a + 1 < argc))
+        {
+            nodes = strtoul(argv[a + 1], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[a], "--transmits")) && (a + 1 < argc))
+        {
+            transmits = strtoul(argv[a + 1], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[a], "--transmit-interval")) && (a + 1 < argc))
+        {
+            interval = strtoul(argv[a + 1], NULL, 0);
+        }
+        else
+        {
+            a++;
+            continue;
+        }
+        memmove(&argv[a], &argv[a + 2], (size_t)(argc - a - 1) * sizeof(char *));
+        argc -= 2;
+    }
+
+    sim_options_init(&opts);
+    if ((sim_options_parse(&opts, argc, argv) != argc) || (0 == nodes) || (0 == transmits))
+    {
+        sim_options_usage(argv[0]);
+        fprintf(stderr, "  --nodes N            sensor hubs of the fleet (default %u)\n", BENCH_COLLIDE_NODES);
+        fprintf(stderr, "  --transmits N        transmissions of every network PDU (default %u)\n", BENCH_COLLIDE_TRANSMITS);
+        fprintf(stderr, "  --transmit-interval MS  interval between the transmissions (default %u)\n", BENCH_COLLIDE_INTERVAL_MS);
+        return 1;
+    }
+    if (0 != sim_fleet_run(&opts, nodes, &p_tx, &count))
+    {
+        return 1;
+    }
+
+    // Every network PDU of a message is sent transmits times, the segments one after another
+    for (pdus = 0, i = 0; i < count; i++)
+    {
+        pdus += sim_air_pdus(p_tx[i].access_len);
+    }
+    events = pdus * transmits;
+    p_events = calloc((events != 0) ? events : 1, sizeof(bench_event_t));
+    p_pdu_ok = calloc((pdus != 0) ? pdus : 1, 1);
+    if ((NULL == p_events) || (NULL == p_pdu_ok))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    air_us = 0;
+    for (e = 0, p = 0, i = 0; i < count; i++)
+    {
+        uint32_t msg_pdus = sim_air_pdus(p_tx[i].access_len);
+        uint32_t event_us = sim_air_event_us(p_tx[i].access_len);
+
+        for (k = 0; k < transmits; k++)
+        {
+            for (m = 0; m < msg_pdus; m++, e++)
+            {
+                p_events[e].start = p_tx[i].time * 1000 + (uint64_t)(k * msg_pdus + m) * interval * 1000 + bench_adv_delay(&rng);
+                p_events[e].end = p_events[e].start + event_us;
+                p_events[e].pdu = p + m;
+            }
+        }
+        p += msg_pdus;
+        air_us += (uint64_t)event_us * msg_pdus * transmits;
+    }
+
+    // An event collides when it starts before an earlier one ends or a later one starts before it ends
+    qsort(p_events, events, sizeof(bench_event_t), bench_event_compare);
+    for (collided = 0, max_end = 0, e = 0; e < events; e++)
+    {
+        p_events[e].collided = (p_events[e].start < max_end) ||
+                               ((e + 1 < events) && (p_events[e + 1].start < p_events[e].end));
+        if (p_events[e].end > max_end)
+        {
+            max_end = p_events[e].end;
+        }
+        if (p_events[e].collided)
+        {
+            collided++;
+        }
+        else
+        {
+            p_pdu_ok[p_events[e].pdu] = 1;
+        }
+    }
+
+    // A message is lost when one of its network PDUs collided in every transmission
+    for (lost = 0, p = 0, i = 0; i < count; i++)
+    {
+        for (ok = 1, m = 0; m < sim_air_pdus(p_tx[i].access_len); m++, p++)
+        {
+            ok &= p_pdu_ok[p];
+        }
+        lost += !ok;
+    }
+
+    printf("fleet                 : %u nodes, %u transmits %u ms apart, jitter up to %u ms\n", nodes, transmits, interval,
+           MESH_SCHED_JITTER_MS);
+    printf("messages              : %u, %u network PDUs\n", count, pdus);
+    printf("advertising events    : %u, %.3f%% of the time on air\n", events,
+           (0 != opts.duration) ? (100.0 * air_us / (opts.duration * 1000.0)) : 0.0);
+    printf("collided events       : %u (%.2f%%)\n", collided, (0 != events) ? (100.0 * collided / events) : 0.0);
+    printf("lost messages         : %u (%.2f%%)\n", lost, (0 != count) ? (100.0 * lost / count) : 0.0);
+
+    free(p_events);
+    free(p_pdu_ok);
+    free(p_tx);
+    return 0;
+}
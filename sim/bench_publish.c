@@ -0,0 +1,313 @@
+/******************************************************************************
+* File Name:   bench_publish.c
+*
+* Description: This file shows the publication-rate benchmark. It replays
+*              sensor traces through the cadence engine and reports published
+*              messages, latency after a trigger threshold crossing, sensor
+*              reads and timer restarts per simulated day.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "mesh_trigger.h"
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t    time;
+    int32_t     value;
+} bench_publish_t;
+
+typedef struct
+{
+    bench_publish_t *publishes;
+    uint32_t        count;
+    uint32_t        capacity;
+    uint32_t        crossings;          // Trigger threshold crossings of the trace
+    uint32_t        missed;             // Crossings not followed by a publish before the end of the run
+    uint64_t        latency_sum;        // Sum of the delays from crossing to publish
+    uint64_t        latency_max;
+} bench_sensor_t;
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static bench_sensor_t bench_sensors[SIM_SENSOR_COUNT];
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Convert a trace sample into the units of the published property, precise temperature keeps them */
+static int32_t bench_to_property(int sensor, int32_t raw, uint8_t prop_value_len)
+{
+    if ((SIM_SENSOR_TEMP == sensor) && (1 == prop_value_len))
+    {
+        // Temperature 8, same conversion as sensor_get_temperature()
+        if (raw < -6400)
+        {
+            return -128;
+        }
+        if (raw >= 6350)
+        {
+            return 127;
+        }
+        return raw / 50;
+    }
+    return raw;
+}
+
+/* Record every published value */
+static void bench_publish_hook(uint8_t element_idx, uint16_t property_id, const uint8_t *p_data, uint8_t len)
+{
+    bench_sensor_t *p_bench;
+    int32_t value = 0;
+    uint8_t i;
+    int s;
+
+    for (s = 0; (s < SIM_SENSOR_COUNT) && (sim_sensor_property_id[s] != property_id); s++)
+        ;
+    if (s == SIM_SENSOR_COUNT)
+    {
+        return;
+    }
+    p_bench = &bench_sensors[s];
+
+    for (i = 0; i < len; i++)
+    {
+        value |= (int32_t)p_data[i] << (8 * i);
+    }
+    if ((SIM_SENSOR_TEMP == s) && (len < 4))
+    {
+        value = (int32_t)((uint32_t)value << (32 - 8 * len)) >> (32 - 8 * len);
+    }
+
+    if (p_bench->count == p_bench->capacity)
+    {
+        p_bench->capacity = p_bench->capacity ? 2 * p_bench->capacity : 1024;
+        p_bench->publishes = realloc(p_bench->publishes, p_bench->capacity * sizeof(bench_publish_t));
+    }
+    p_bench->publishes[p_bench->count].time = sim_now;
+    p_bench->publishes[p_bench->count].value = value;
+    p_bench->count++;
+}
+
+/*
+ * Walk the trace and the published values in time order. A crossing starts when the trace leaves
+ * the trigger window of the last published value, as the firmware computes it, and ends with the
+ * next publish.
+ */
+static void bench_latency(int sensor, const sim_series_t *p_series, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,
+                          uint8_t prop_value_len, uint64_t duration)
+{
+    bench_sensor_t *p_bench = &bench_sensors[sensor];
+    uint64_t span, base, t, crossing = 0;
+    wiced_bool_t pending = WICED_FALSE;
+    mesh_trigger_t trigger;
+    uint32_t i, p = 0;
+    int32_t value;
+
+    if ((0 == p_series->count) || (0 == p_bench->count) ||
+        ((0 == p_cadence->trigger_delta_up) && (0 == p_cadence->trigger_delta_down)))
+    {
+        return;
+    }
+
+    span = p_series->samples[p_series->count - 1].time + 1;
+    mesh_trigger_update(&trigger, p_cadence, p_bench->publishes[0].value);
+    p = 1;
+
+    for (base = 0; base < duration; base += span)
+    {
+        for (i = 0; i < p_series->count; i++)
+        {
+            t = base + p_series->samples[i].time;
+            if (t >= duration)
+            {
+                break;
+            }
+
+            // Publishes up to this sample
+            while ((p < p_bench->count) && (p_bench->publishes[p].time < t))
+            {
+                if (pending)
+                {
+                    uint64_t latency = p_bench->publishes[p].time - crossing;
+                    p_bench->latency_sum += latency;
+                    if (latency > p_bench->latency_max)
+                    {
+                        p_bench->latency_max = latency;
+                    }
+                    pending = WICED_FALSE;
+                }
+                mesh_trigger_update(&trigger, p_cadence, p_bench->publishes[p++].value);
+            }
+
+            value = bench_to_property(sensor, p_series->samples[i].value, prop_value_len);
+            if (!pending && MESH_TRIGGER_CROSSED(&trigger, value))
+            {
+                pending = WICED_TRUE;
+                crossing = t;
+                p_bench->crossings++;
+            }
+        }
+    }
+
+    // Publishes after the last sample
+    if (pending)
+    {
+        if (p < p_bench->count)
+        {
+            uint64_t latency = p_bench->publishes[p].time - crossing;
+            p_bench->latency_sum += latency;
+            if (latency > p_bench->latency_max)
+            {
+                p_bench->latency_max = latency;
+            }
+        }
+        else
+        {
+            p_bench->missed++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[SIM_SENSOR_COUNT] = { "als", "temp" };
+    sim_options_t opts;
+    wiced_bool_t csv = WICED_FALSE;
+    const sim_series_t *p_series;
+    uint8_t element_idx;
+    double days;
+    int i, s;
+
+    // --csv is specific to the benchmark, the other options are shared with the simulation
+    for (i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "--csv"))
+        {
+            csv = WICED_TRUE;
+            memmove(&argv[i], &argv[i + 1], (size_t)(argc - i) * sizeof(char *));
+            argc--;
+            break;
+        }
+    }
+
+    sim_options_init(&opts);
+    if (sim_options_parse(&opts, argc, argv) != argc)
+    {
+        sim_options_usage(argv[0]);
+        fprintf(stderr, "  --csv                print one CSV line per sensor\n");
+        return 1;
+    }
+
+    sim_reset();
+    sim_publish_hook = bench_publish_hook;
+    sim_boot();
+    if (0 != sim_options_apply(&opts))
+    {
+        return 1;
+    }
+    sim_run_until(opts.duration);
+
+    days = (double)opts.duration / SIM_MS_PER_DAY;
+    if (csv)
+    {
+        printf("sensor,publishes_per_day,crossings,missed,latency_avg_ms,latency_max_ms,reads_per_day,timer_restarts_per_day,messages_per_day\n");
+    }
+
+    for (s = 0; s < SIM_SENSOR_COUNT; s++)
+    {
+        bench_sensor_t *p_bench = &bench_sensors[s];
+        uint32_t reads = (SIM_SENSOR_ALS == s) ? sim_stats.lux_reads : sim_stats.temp_reads;
+        uint32_t answered;
+        uint8_t len = 0;
+
+        if (0 != sim_find_sensor(sim_sensor_property_id[s], &element_idx))
+        {
+            continue;
+        }
+        for (i = 0; i < mesh_config.elements[element_idx].sensors_num; i++)
+        {
+            if (mesh_config.elements[element_idx].sensors[i].property_id == sim_sensor_property_id[s])
+            {
+                len = mesh_config.elements[element_idx].sensors[i].prop_value_len;
+            }
+        }
+        p_series = (SIM_SENSOR_ALS == s) ? &sim_lux_series : &sim_temp_series;
+        bench_latency(s, p_series, &opts.cadence[s], len, opts.duration);
+        answered = p_bench->crossings - p_bench->missed;
+
+        if (csv)
+        {
+            printf("%s,%.1f,%u,%u,%.0f,%llu,%.1f,%.1f,%.1f\n", names[s], p_bench->count / days, p_bench->crossings, p_bench->missed,
+                   answered ? (double)p_bench->latency_sum / answered : 0.0, (unsigned long long)p_bench->latency_max,
+                   reads / days, sim_stats.timer_starts / days, sim_stats.publishes / days);
+            continue;
+        }
+        printf("%s\n", names[s]);
+        printf("  published messages  : %u (%.1f/day)\n", p_bench->count, p_bench->count / days);
+        printf("  threshold crossings : %u, %u without publish\n", p_bench->crossings, p_bench->missed);
+        if (0 != answered)
+        {
+            printf("  latency after cross : avg %.0f ms, worst %llu ms\n",
+                   (double)p_bench->latency_sum / answered, (unsigned long long)p_bench->latency_max);
+        }
+        printf("  sensor reads        : %u (%.1f/day)\n", reads, reads / days);
+    }
+    if (!csv)
+    {
+        printf("published messages    : %u (%.1f/day)\n", sim_stats.publishes, sim_stats.publishes / days);
+        printf("timer restarts        : %u (%.1f/day)\n", sim_stats.timer_starts, sim_stats.timer_starts / days);
+        printf("wakeups               : %u (%.1f/day)\n", sim_stats.timer_expiries, sim_stats.timer_expiries / days);
+        printf("sensor interrupts     : %u (%.1f/day)\n", sim_stats.sensor_irqs, sim_stats.sensor_irqs / days);
+        if (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER)
+        {
+            printf("friend polls          : %u (%.1f/day)\n", sim_stats.friend_polls, sim_stats.friend_polls / days);
+            printf("node wakes            : %u (%.1f/day)\n", sim_stats.node_wakes, sim_stats.node_wakes / days);
+            printf("radio wakes           : %u (%.1f/day)\n", sim_stats.radio_wakes, sim_stats.radio_wakes / days);
+            printf("average sleep         : %.0f ms\n", sim_stats.node_wakes ? (double)sim_stats.sleep_ms / sim_stats.node_wakes : 0.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,188 @@
+/******************************************************************************
+* File Name:   bench_stream.c
+*
+* Description: This file shows the sensor stream benchmark. It streams the
+*              sensor traces through the vendor stream model and reports the
+*              bytes on air per sample, against one Sensor Status message per
+*              sample.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "mesh_stream.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+// Default sample interval of the benchmark
+#define BENCH_STREAM_INTERVAL_MS                250
+
+/*
+ * Bytes on air of a network PDU sent once on the advertising bearer, without the lower transport
+ * PDU: preamble 1, access address 4, advertising header 2, AdvA 6, AD length and type 2, CRC 3,
+ * and the network header 9 (IVI/NID, CTL/TTL, SEQ, SRC, DST) with a 4-byte NetMIC.
+ */
+#define BENCH_ADV_OVERHEAD                      18
+#define BENCH_NET_OVERHEAD                      13
+#define BENCH_TRANSMIC_LEN                      4
+#define BENCH_UNSEG_MAX_LEN                     15      // Upper transport PDU of an unsegmented message
+#define BENCH_SEG_LEN                           12      // Upper transport PDU bytes per segment
+
+// Sensor Status: opcode 0x52 and a 2-byte Marshalled Property ID (format A) before the value
+#define BENCH_STATUS_OVERHEAD                   3
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t    messages;           // Stream Data messages
+    uint32_t    samples;            // Samples in the Data messages
+    uint64_t    access_bytes;       // Access message bytes of the Data messages, opcode included
+    uint64_t    air_bytes;          // Bytes on air of the Data messages
+} bench_stream_t;
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static bench_stream_t bench_streams[SIM_SENSOR_COUNT];
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/*
+ * Bytes on air of an access message with a 4-byte TransMIC, sent once: unsegmented up to 11 bytes,
+ * otherwise in segments of 12 bytes with a 4-byte segmentation header. Messages published to a
+ * group are not acknowledged, and the network retransmissions multiply both encodings alike.
+ */
+static uint32_t bench_air_bytes(uint32_t access_len)
+{
+    uint32_t upper = access_len + BENCH_TRANSMIC_LEN;
+    uint32_t segments;
+
+    if (upper <= BENCH_UNSEG_MAX_LEN)
+    {
+        return BENCH_ADV_OVERHEAD + BENCH_NET_OVERHEAD + 1 + upper;
+    }
+    segments = (upper + BENCH_SEG_LEN - 1) / BENCH_SEG_LEN;
+    return segments * (BENCH_ADV_OVERHEAD + BENCH_NET_OVERHEAD + 4) + upper;
+}
+
+/* Count the Data messages of the stream, each varint ends with a byte below 0x80 */
+static void bench_stream_hook(const wiced_bt_mesh_event_t *p_event, const uint8_t *p_data, uint16_t len)
+{
+    bench_stream_t *p_bench;
+    uint16_t i;
+
+    if ((MESH_COMPANY_ID != p_event->company_id) || (MESH_STREAM_MODEL_ID != p_event->model_id) ||
+        (MESH_STREAM_OPCODE_DATA != p_event->opcode) || (0 == len) ||
+        ((p_data[0] & MESH_STREAM_HDR_SENSOR_MASK) >= SIM_SENSOR_COUNT))
+    {
+        return;
+    }
+    p_bench = &bench_streams[p_data[0] & MESH_STREAM_HDR_SENSOR_MASK];
+
+    for (i = 1; i < len; i++)
+    {
+        p_bench->samples += (p_data[i] < 0x80);
+    }
+    p_bench->messages++;
+    p_bench->access_bytes += MESH_STREAM_OPCODE_LEN + len;
+    p_bench->air_bytes += bench_air_bytes(MESH_STREAM_OPCODE_LEN + len);
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[SIM_SENSOR_COUNT] = { "als", "temp" };
+    sim_options_t opts;
+    uint8_t element_idx;
+    uint32_t status_len;
+    double days;
+    int i, s;
+
+    sim_options_init(&opts);
+    if (sim_options_parse(&opts, argc, argv) != argc)
+    {
+        sim_options_usage(argv[0]);
+        return 1;
+    }
+    if (0 == opts.stream_interval)
+    {
+        opts.stream_interval = BENCH_STREAM_INTERVAL_MS;
+    }
+
+    sim_reset();
+    sim_send_hook = bench_stream_hook;
+    sim_boot();
+    if (0 != sim_options_apply(&opts))
+    {
+        return 1;
+    }
+    sim_run_until(opts.duration);
+
+    days = (double)opts.duration / SIM_MS_PER_DAY;
+    printf("sample interval       : %u ms, %u access bytes per message at most\n", opts.stream_interval, MESH_STREAM_MAX_ACCESS_LEN);
+    for (s = 0; s < SIM_SENSOR_COUNT; s++)
+    {
+        bench_stream_t *p_bench = &bench_streams[s];
+
+        if ((0 != sim_find_sensor(sim_sensor_property_id[s], &element_idx)) || (0 == p_bench->samples))
+        {
+            continue;
+        }
+        status_len = BENCH_STATUS_OVERHEAD;
+        for (i = 0; i < mesh_config.elements[element_idx].sensors_num; i++)
+        {
+            if (mesh_config.elements[element_idx].sensors[i].property_id == sim_sensor_property_id[s])
+            {
+                status_len += mesh_config.elements[element_idx].sensors[i].prop_value_len;
+            }
+        }
+
+        printf("%s\n", names[s]);
+        printf("  samples             : %u (%.1f/day)\n", p_bench->samples, p_bench->samples / days);
+        printf("  stream messages     : %u, %.2f samples per message\n", p_bench->messages, (double)p_bench->samples / p_bench->messages);
+        printf("  access bytes/sample : stream %.2f, Sensor Status %u\n", (double)p_bench->access_bytes / p_bench->samples, status_len);
+        printf("  air bytes/sample    : stream %.2f, Sensor Status %u (%.0f%%)\n", (double)p_bench->air_bytes / p_bench->samples,
+               bench_air_bytes(status_len), 100.0 * p_bench->air_bytes / p_bench->samples / bench_air_bytes(status_len));
+    }
+    return 0;
+}
@@ -0,0 +1,350 @@
+/******************************************************************************
+* File Name:   bench_trigger.c
+*
+* Description: This file shows the trigger evaluation benchmark. It replays
+*              sensor traces through the percentage trigger check as the
+*              firmware did it before, with a division per reading, with the
+*              cross-multiplied comparison, and with the precomputed bounds
+*              of mesh_trigger.c, and reports the host time per reading, the
+*              publishes, and the readings each evaluation gets wrong.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim.h"
+#include "mesh_cfg.h"
+#include "mesh_trigger.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Samples of the synthetic signed workload, a triangle from -BENCH_SIGNED_PEAK to BENCH_SIGNED_PEAK
+#define BENCH_SIGNED_PEAK                       100
+
+// Widest fast cadence range of the narrow range check
+#define BENCH_RANGE_MAX_WIDTH                   20
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+/* Trigger state of one replay, as held by the sensor entry */
+typedef struct
+{
+    wiced_bt_mesh_sensor_config_cadence_t   cadence;
+    int32_t                                 sent;
+    mesh_trigger_t                          trigger;
+} bench_state_t;
+
+/* Decide whether a reading is published, and publish it */
+typedef wiced_bool_t (*bench_eval_t)(bench_state_t *p_state, int32_t current);
+
+typedef struct
+{
+    const char      *name;
+    bench_eval_t    eval;
+} bench_method_t;
+
+typedef struct
+{
+    const char      *name;
+    int32_t         *values;
+    uint32_t        count;
+} bench_workload_t;
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* The percentage of the change, divided out for every reading */
+static wiced_bool_t bench_eval_division(bench_state_t *p_state, int32_t current)
+{
+    uint32_t percent;
+
+    if (0 != current)
+    {
+        if ((0 != p_state->cadence.trigger_delta_up) && (current > p_state->sent))
+        {
+            percent = (uint32_t)(current - p_state->sent) * 10000 / (uint32_t)current;
+            if (percent > p_state->cadence.trigger_delta_up)
+            {
+                p_state->sent = current;
+                return WICED_TRUE;
+            }
+        }
+        else if ((0 != p_state->cadence.trigger_delta_down) && (current < p_state->sent))
+        {
+            percent = (uint32_t)(p_state->sent - current) * 10000 / (uint32_t)current;
+            if (percent > p_state->cadence.trigger_delta_down)
+            {
+                p_state->sent = current;
+                return WICED_TRUE;
+            }
+        }
+    }
+    return WICED_FALSE;
+}
+
+/* The change and the delta cross-multiplied in 64 bits for every reading */
+static wiced_bool_t bench_eval_multiply(bench_state_t *p_state, int32_t current)
+{
+    if (0 != current)
+    {
+        if ((0 != p_state->cadence.trigger_delta_up) && (current > p_state->sent))
+        {
+            if ((uint64_t)(uint32_t)(current - p_state->sent) * 10000 >= ((uint64_t)p_state->cadence.trigger_delta_up + 1) * (uint32_t)current)
+            {
+                p_state->sent = current;
+                return WICED_TRUE;
+            }
+        }
+        else if ((0 != p_state->cadence.trigger_delta_down) && (current < p_state->sent))
+        {
+            if ((uint64_t)(uint32_t)(p_state->sent - current) * 10000 >= ((uint64_t)p_state->cadence.trigger_delta_down + 1) * (uint32_t)current)
+            {
+                p_state->sent = current;
+                return WICED_TRUE;
+            }
+        }
+    }
+    return WICED_FALSE;
+}
+
+/* Two comparisons, the bounds are recomputed on publish */
+static wiced_bool_t bench_eval_bounds(bench_state_t *p_state, int32_t current)
+{
+    if (MESH_TRIGGER_CROSSED(&p_state->trigger, current))
+    {
+        p_state->sent = current;
+        mesh_trigger_update(&p_state->trigger, &p_state->cadence, current);
+        return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+/* The definition, in 64 bits: the change in whole 0.01 % of |current| exceeds the delta */
+static wiced_bool_t bench_reference(const bench_state_t *p_state, int32_t current)
+{
+    int64_t change = (int64_t)current - p_state->sent;
+    int64_t base = (current < 0) ? -(int64_t)current : current;
+
+    if ((0 != p_state->cadence.trigger_delta_up) && (change > 0))
+    {
+        return change * 10000 >= ((int64_t)p_state->cadence.trigger_delta_up + 1) * base;
+    }
+    if ((0 != p_state->cadence.trigger_delta_down) && (change < 0))
+    {
+        return -change * 10000 >= ((int64_t)p_state->cadence.trigger_delta_down + 1) * base;
+    }
+    return WICED_FALSE;
+}
+
+static void bench_state_init(bench_state_t *p_state, uint32_t delta, int32_t first)
+{
+    memset(p_state, 0, sizeof(*p_state));
+    p_state->cadence.trigger_type_percentage = WICED_TRUE;
+    p_state->cadence.trigger_delta_up = delta;
+    p_state->cadence.trigger_delta_down = delta;
+    p_state->sent = first;
+    mesh_trigger_update(&p_state->trigger, &p_state->cadence, first);
+}
+
+static uint64_t bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Load a trace, converted into the units of the published property */
+static int bench_workload_load(bench_workload_t *p_workload, const char *name, const char *path, int32_t divisor)
+{
+    sim_series_t series;
+    uint32_t i;
+
+    if (0 != sim_series_load(&series, path))
+    {
+        return -1;
+    }
+    p_workload->name = name;
+    p_workload->count = series.count;
+    p_workload->values = malloc(series.count * sizeof(int32_t));
+    for (i = 0; i < series.count; i++)
+    {
+        p_workload->values[i] = series.samples[i].value / divisor;
+    }
+    sim_series_free(&series);
+    return 0;
+}
+
+/* Replay a workload and print one line for the evaluation */
+static void bench_run(const bench_workload_t *p_workload, const bench_method_t *p_method, uint32_t delta, uint32_t rounds)
+{
+    volatile bench_eval_t eval = p_method->eval;
+    bench_state_t state, check;
+    uint32_t publishes = 0, wrong = 0;
+    uint64_t start, elapsed;
+    uint32_t r, i;
+
+    // Time the replay
+    bench_state_init(&state, delta, p_workload->values[0]);
+    start = bench_ns();
+    for (r = 0; r < rounds; r++)
+    {
+        for (i = 0; i < p_workload->count; i++)
+        {
+            publishes += eval(&state, p_workload->values[i]);
+        }
+    }
+    elapsed = bench_ns() - start;
+
+    // Check every decision against the definition, from the same published value
+    bench_state_init(&state, delta, p_workload->values[0]);
+    for (i = 0; i < p_workload->count; i++)
+    {
+        check = state;
+        if (bench_reference(&check, p_workload->values[i]) != eval(&state, p_workload->values[i]))
+        {
+            wrong++;
+        }
+    }
+
+    printf("%-8s %-10s %8.2f %12u %8u\n", p_workload->name, p_method->name,
+           (double)elapsed / ((uint64_t)rounds * p_workload->count), publishes / rounds, wrong);
+}
+
+/* Check that every narrow fast cadence range with its hysteresis bands has a value which enters it */
+static void bench_ranges(uint32_t delta)
+{
+    wiced_bt_mesh_sensor_config_cadence_t cadence;
+    mesh_trigger_range_t range;
+    uint32_t ranges = 0, never = 0;
+    int32_t low, high, value;
+
+    memset(&cadence, 0, sizeof(cadence));
+    cadence.trigger_type_percentage = WICED_TRUE;
+    cadence.trigger_delta_up = delta;
+    cadence.trigger_delta_down = delta;
+
+    for (low = -BENCH_SIGNED_PEAK; low <= BENCH_SIGNED_PEAK; low++)
+    {
+        for (high = low; high <= low + BENCH_RANGE_MAX_WIDTH; high++)
+        {
+            mesh_trigger_range_update(&range, &cadence, low, high, INT32_MIN, INT32_MAX, MESH_SENSOR_FAST_HYSTERESIS);
+            for (value = low; (value <= high) && !mesh_trigger_in_range(&range, value, WICED_FALSE); value++)
+            {
+            }
+            ranges++;
+            never += (value > high);
+        }
+    }
+    printf("fast ranges up to %u wide never entered: %u of %u\n", BENCH_RANGE_MAX_WIDTH, never, ranges);
+}
+
+int main(int argc, char **argv)
+{
+    static const bench_method_t methods[] =
+    {
+        { "division", bench_eval_division },
+        { "multiply", bench_eval_multiply },
+        { "bounds",   bench_eval_bounds },
+    };
+    const char *lux_path = "traces/office_lux.csv";
+    const char *temp_path = "traces/office_temp.csv";
+    bench_workload_t workloads[3];
+    uint32_t delta = 1000;
+    uint32_t rounds = 1000;
+    uint32_t i, w, m;
+
+    for (i = 1; i < (uint32_t)argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--lux")) && (i + 1 < (uint32_t)argc))
+        {
+            lux_path = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "--temp")) && (i + 1 < (uint32_t)argc))
+        {
+            temp_path = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "--delta")) && (i + 1 < (uint32_t)argc))
+        {
+            delta = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--rounds")) && (i + 1 < (uint32_t)argc))
+        {
+            rounds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr,
+                "usage: %s [options]\n"
+                "  --lux FILE           ambient light trace, CSV of time_ms,lux\n"
+                "  --temp FILE          temperature trace, CSV of time_ms,centi-degC\n"
+                "  --delta N            trigger delta up and down in 0.01 %% (default 1000)\n"
+                "  --rounds N           replays of each trace (default 1000)\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Light in lux, temperature in the 0.5 degC steps of Temperature 8, and a signed sweep through 0
+    if ((0 != bench_workload_load(&workloads[0], "lux", lux_path, 1)) ||
+        (0 != bench_workload_load(&workloads[1], "temp", temp_path, 50)))
+    {
+        return 1;
+    }
+    workloads[2].name = "signed";
+    workloads[2].count = 4 * BENCH_SIGNED_PEAK;
+    workloads[2].values = malloc(workloads[2].count * sizeof(int32_t));
+    for (i = 0; i < workloads[2].count; i++)
+    {
+        workloads[2].values[i] = (i < 2 * BENCH_SIGNED_PEAK) ? (int32_t)i - BENCH_SIGNED_PEAK : 3 * BENCH_SIGNED_PEAK - (int32_t)i;
+    }
+
+    printf("%-8s %-10s %8s %12s %8s\n", "workload", "method", "ns/read", "publishes", "wrong");
+    for (w = 0; w < 3; w++)
+    {
+        for (m = 0; m < sizeof(methods) / sizeof(methods[0]); m++)
+        {
+            bench_run(&workloads[w], &methods[m], delta, rounds);
+        }
+    }
+    bench_ranges(delta);
+    return 0;
+}
@@ -0,0 +1,948 @@
+/******************************************************************************
+* File Name:   fleet_sim.c
+*
+* Description: This file shows the network simulation of a sensor hub fleet.
+*              The hubs of a site, laid out on a grid, publish to a gateway
+*              in a corner over the advertising bearer: the network PDUs
+*              collide at every receiver in range of two transmissions, and
+*              the hubs which have the relay feature relay them hop by hop.
+*              The program reports the channel use, the latency from publish
+*              to the gateway and the dropped messages.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "mesh_cfg.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+// Defaults of the site, of the Network Transmit and Relay Retransmit states and of the publish TTL
+#define FLEET_NODES                             50
+#define FLEET_SPACING_M                         6
+#define FLEET_RANGE_M                           15
+#define FLEET_TRANSMITS                         3
+#define FLEET_TRANSMIT_INTERVAL_MS              20
+#define FLEET_RELAY_TRANSMITS                   2
+#define FLEET_RELAY_INTERVAL_MS                 20
+#define FLEET_TTL                               5
+
+// Receivers scan the advertising channels in turn, this many usec each
+#define FLEET_SCAN_WINDOW_US                    30000
+
+// Network PDUs each node remembers so that it relays a PDU only once
+#define FLEET_NET_CACHE_SIZE                    32
+
+// Receiver of the network PDUs of the fleet, which every node in range receives
+#define FLEET_DST_ALL                           UINT16_MAX
+
+// Friend traffic: transport control PDUs, with a NetMIC 4 bytes longer than that of an access message
+#define FLEET_CONTROL_NETMIC_EXTRA              4
+#define FLEET_POLL_LEN                          2       // Friend Poll: opcode and FSN
+#define FLEET_UPDATE_LEN                        7       // Friend Update: opcode, flags, IV Index and MD
+#define FLEET_QUEUED_ACCESS_LEN                 11      // Queued message, taken as the longest unsegmented access message
+
+// Receive Delay and Receive Window of a friendship when the configuration of the build has none
+#define FLEET_RECEIVE_DELAY_MS                  100
+#define FLEET_RECEIVE_WINDOW_MS                 20
+
+// A grid coordinate is a relay coordinate when it is the first of its share of relay_side shares
+#define FLEET_RELAY_COORD(coord, side, relay_side)  ((0 == (coord)) || \
+                                                     (((coord) * (relay_side)) / (side) != (((coord) - 1) * (relay_side)) / (side)))
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// What an advertising event transmits
+typedef enum
+{
+    FLEET_TX_PUBLISH,               // Network PDU of a message of the fleet
+    FLEET_TX_RELAY,                 // Network PDU of the fleet retransmitted by a relay
+    FLEET_TX_POLL,                  // Friend Poll of a Low Power Node
+    FLEET_TX_UPDATE,                // Friend Update of a Friend, with an empty Friend Queue
+    FLEET_TX_QUEUED                 // Message of the Friend Queue
+} fleet_tx_kind_t;
+
+typedef struct
+{
+    uint64_t    start;              // Start of the advertising event in usec
+    uint64_t    end;                // End of the advertising event in usec
+    uint64_t    poll;               // End of the Friend Poll a Friend Update or queued message answers
+    uint32_t    pdu;                // Network PDU of the fleet the event transmits
+    uint16_t    sender;             // Transmitting node
+    uint16_t    dst;                // Receiving node of Friend traffic, FLEET_DST_ALL otherwise
+    uint8_t     ttl;                // TTL of the transmitted PDU
+    uint8_t     kind;               // fleet_tx_kind_t
+    uint8_t     started;            // On the air, the event is due at its end
+} fleet_tx_t;
+
+typedef struct
+{
+    uint32_t    pdus[FLEET_NET_CACHE_SIZE];
+    uint32_t    next;
+} fleet_cache_t;
+
+typedef struct
+{
+    uint32_t    nodes;
+    uint32_t    relays;             // Nodes which have the Relay state enabled, on a grid over the site
+    uint32_t    spacing;
+    uint32_t    range;
+    uint32_t    transmits;
+    uint32_t    interval;
+    uint32_t    relay_transmits;
+    uint32_t    relay_interval;
+    uint8_t     ttl;
+} fleet_options_t;
+
+// Friendships of the fleet: the Low Power Nodes of every hub, or the Friend of every Low Power Node hub
+typedef struct
+{
+    uint32_t    lpns;               // Low Power Nodes befriended by every hub, 0 unless the build has the Friend feature
+    uint32_t    peers;              // Low Power Nodes or Friends of every hub, which sit next to it
+    uint64_t    poll_interval;      // Poll interval of the Low Power Nodes in usec
+    uint64_t    receive_delay;      // Receive Delay in usec
+    uint64_t    receive_window;     // Receive Window in usec
+    uint64_t    end;                // No polls from here on, in usec
+    uint32_t    msgs_per_hour;      // Messages queued for each Low Power Node
+} fleet_friend_t;
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static fleet_options_t  fleet_opts;
+static fleet_friend_t   fleet_friend;
+static uint32_t         fleet_all;                  // Hubs, the gateway and the peers of the hubs, in this order
+static uint8_t          *fleet_in_range;            // Range matrix of the hubs, the gateway and the peers
+static uint16_t         *fleet_friend_of;           // Friend of a Low Power Node, FLEET_DST_ALL for other nodes
+static uint32_t         *fleet_delivered;           // Queued messages a Low Power Node received
+static uint64_t         *fleet_queue_phase;         // Offset in usec of the queued messages of a Low Power Node
+static uint8_t          *fleet_relay;               // Node relays the PDUs it receives
+static fleet_cache_t    *fleet_cache;               // Network message cache of every node
+static uint64_t         *fleet_node_busy;           // End of the last advertising event of every node
+static uint64_t         *fleet_arrival;             // First arrival of every PDU at the gateway, 0 while missing
+
+// Min-heap of the pending events, on their start time until started and on their end time after
+static fleet_tx_t       *fleet_heap;
+static uint32_t         fleet_heap_count;
+static uint32_t         fleet_heap_size;
+
+// Transmissions started and not yet ended longer ago than the longest event
+static fleet_tx_t       *fleet_air;
+static uint32_t         fleet_air_count;
+static uint32_t         fleet_air_size;
+
+static uint32_t         fleet_rng = 1;
+
+// Counters
+static uint64_t         fleet_air_us;               // Time on air of all transmissions
+static uint64_t         fleet_busy_us;              // Time the gateway hears at least one transmission
+static uint64_t         fleet_busy_until;
+static uint32_t         fleet_tx_origin;
+static uint32_t         fleet_tx_relayed;
+static uint32_t         fleet_rx_ok;
+static uint32_t         fleet_rx_collided;
+static uint32_t         fleet_polls;
+static uint32_t         fleet_polls_lost;           // Friend Polls the Friend did not receive
+static uint32_t         fleet_replies;
+static uint32_t         fleet_replies_lost;         // Friend Updates and queued messages lost or outside the Receive Window
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Random numbers, the same for every run */
+static uint32_t fleet_random(void)
+{
+    fleet_rng ^= fleet_rng << 13;
+    fleet_rng ^= fleet_rng >> 17;
+    fleet_rng ^= fleet_rng << 5;
+    return fleet_rng;
+}
+
+/* Random delay of the controller before an advertising event */
+static uint32_t fleet_adv_delay(void)
+{
+    return fleet_random() % (SIM_AIR_ADV_DELAY_US + 1);
+}
+
+static uint64_t fleet_heap_key(uint32_t i)
+{
+    return fleet_heap[i].started ? fleet_heap[i].end : fleet_heap[i].start;
+}
+
+static void fleet_heap_swap(uint32_t a, uint32_t b)
+{
+    fleet_tx_t tx = fleet_heap[a];
+
+    fleet_heap[a] = fleet_heap[b];
+    fleet_heap[b] = tx;
+}
+
+static void fleet_heap_push(const fleet_tx_t *p_tx)
+{
+    uint32_t i = fleet_heap_count++;
+
+    if (fleet_heap_count > fleet_heap_size)
+    {
+        fleet_heap_size = (0 != fleet_heap_size) ? (2 * fleet_heap_size) : 1024;
+        if (NULL == (fleet_heap = realloc(fleet_heap, fleet_heap_size * sizeof(fleet_tx_t))))
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    fleet_heap[i] = *p_tx;
+    while ((i > 0) && (fleet_heap_key(i) < fleet_heap_key((i - 1) / 2)))
+    {
+        fleet_heap_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void fleet_heap_pop(fleet_tx_t *p_tx)
+{
+    uint32_t i = 0, child;
+
+    *p_tx = fleet_heap[0];
+    fleet_heap[0] = fleet_heap[--fleet_heap_count];
+    while ((child = 2 * i + 1) < fleet_heap_count)
+    {
+        if ((child + 1 < fleet_heap_count) && (fleet_heap_key(child + 1) < fleet_heap_key(child)))
+        {
+            child++;
+        }
+        if (fleet_heap_key(i) <= fleet_heap_key(child))
+        {
+            break;
+        }
+        fleet_heap_swap(i, child);
+        i = child;
+    }
+}
+
+/* Schedule the transmissions of a network PDU after the given time */
+static void fleet_send(uint64_t time, uint16_t sender, uint32_t pdu, uint8_t ttl, uint32_t event_us,
+                       uint32_t transmits, uint32_t interval, uint32_t spread, uint8_t kind)
+{
+    fleet_tx_t tx;
+    uint32_t k;
+
+    for (k = 0; k < transmits; k++)
+    {
+        tx.start = time + (uint64_t)k * spread * interval * 1000 + fleet_adv_delay();
+        tx.end = tx.start + event_us;
+        tx.poll = 0;
+        tx.pdu = pdu;
+        tx.sender = sender;
+        tx.dst = FLEET_DST_ALL;
+        tx.ttl = ttl;
+        tx.kind = kind;
+        tx.started = 0;
+        fleet_heap_push(&tx);
+    }
+}
+
+/* Time on air in usec of one advertising event carrying a transport control PDU of the given length */
+static uint32_t fleet_control_event_us(uint32_t len)
+{
+    uint32_t pdu = SIM_AIR_ADV_OVERHEAD + SIM_AIR_NET_OVERHEAD + FLEET_CONTROL_NETMIC_EXTRA + len;
+
+    return SIM_AIR_CHANNELS * pdu * SIM_AIR_US_PER_BYTE + (SIM_AIR_CHANNELS - 1) * SIM_AIR_CHANNEL_GAP_US;
+}
+
+/* Longest advertising event of the Friend traffic in usec */
+static uint32_t fleet_friend_event_max_us(void)
+{
+    uint32_t event_us = fleet_control_event_us(FLEET_UPDATE_LEN);
+
+    return (sim_air_event_us(FLEET_QUEUED_ACCESS_LEN) > event_us) ? sim_air_event_us(FLEET_QUEUED_ACCESS_LEN) : event_us;
+}
+
+/*
+ * Schedule a PDU of a friendship after the given time. The Friend Poll, the Friend Update and the
+ * queued messages are network PDUs on the advertising bearer with a TTL of 0, sent once.
+ */
+static void fleet_friend_send(uint64_t time, uint16_t sender, uint16_t dst, uint8_t kind, uint64_t poll)
+{
+    fleet_tx_t tx;
+
+    tx.start = time + fleet_adv_delay();
+    tx.end = tx.start + ((FLEET_TX_POLL == kind) ? fleet_control_event_us(FLEET_POLL_LEN) :
+                         (FLEET_TX_UPDATE == kind) ? fleet_control_event_us(FLEET_UPDATE_LEN) :
+                         sim_air_event_us(FLEET_QUEUED_ACCESS_LEN));
+    tx.poll = poll;
+    tx.pdu = 0;
+    tx.sender = sender;
+    tx.dst = dst;
+    tx.ttl = 0;
+    tx.kind = kind;
+    tx.started = 0;
+    fleet_heap_push(&tx);
+}
+
+/* Poll the Friend of a Low Power Node, unless the simulated time is over */
+static void fleet_friend_poll(uint16_t lpn, uint64_t time)
+{
+    if (time < fleet_friend.end)
+    {
+        fleet_friend_send(time, lpn, fleet_friend_of[lpn], FLEET_TX_POLL, 0);
+    }
+}
+
+/* Messages in the Friend Queue of a Low Power Node, which arrive at a steady rate */
+static uint32_t fleet_friend_queued(uint16_t lpn, uint64_t time)
+{
+    uint64_t arrived = (time + fleet_queue_phase[lpn]) * fleet_friend.msgs_per_hour / 3600000000ull;
+
+    return (arrived > fleet_delivered[lpn]) ? (uint32_t)(arrived - fleet_delivered[lpn]) : 0;
+}
+
+/* Remember a PDU in the network message cache of a node, returns 1 when it was known */
+static int fleet_cache_check(uint16_t node, uint32_t pdu)
+{
+    fleet_cache_t *p_cache = &fleet_cache[node];
+    uint32_t i;
+
+    for (i = 0; i < FLEET_NET_CACHE_SIZE; i++)
+    {
+        if (p_cache->pdus[i] == pdu + 1)
+        {
+            return 1;
+        }
+    }
+    p_cache->pdus[p_cache->next] = pdu + 1;
+    p_cache->next = (p_cache->next + 1) % FLEET_NET_CACHE_SIZE;
+    return 0;
+}
+
+/*
+ * A transmission is due: a node sends one advertising event at a time, so an event due while the node
+ * is still sending waits for the end of it and a new advertising delay. Otherwise put it on the air
+ * and count the time the gateway hears the channel busy.
+ */
+static void fleet_tx_start(fleet_tx_t *p_tx)
+{
+    uint32_t gateway = fleet_opts.nodes;
+
+    if (p_tx->start < fleet_node_busy[p_tx->sender])
+    {
+        p_tx->end = p_tx->end - p_tx->start;
+        p_tx->start = fleet_node_busy[p_tx->sender] + fleet_adv_delay();
+        p_tx->end += p_tx->start;
+        fleet_heap_push(p_tx);
+        return;
+    }
+    fleet_node_busy[p_tx->sender] = p_tx->end;
+
+    if (fleet_air_count == fleet_air_size)
+    {
+        fleet_air_size = (0 != fleet_air_size) ? (2 * fleet_air_size) : 64;
+        if (NULL == (fleet_air = realloc(fleet_air, fleet_air_size * sizeof(fleet_tx_t))))
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    fleet_air[fleet_air_count++] = *p_tx;
+
+    fleet_air_us += p_tx->end - p_tx->start;
+    switch (p_tx->kind)
+    {
+    case FLEET_TX_PUBLISH:
+        fleet_tx_origin++;
+        break;
+    case FLEET_TX_RELAY:
+        fleet_tx_relayed++;
+        break;
+    case FLEET_TX_POLL:
+        fleet_polls++;
+        break;
+    default:
+        fleet_replies++;
+        break;
+    }
+    if (fleet_in_range[p_tx->sender * fleet_all + gateway] && (p_tx->end > fleet_busy_until))
+    {
+        fleet_busy_us += p_tx->end - ((p_tx->start > fleet_busy_until) ? p_tx->start : fleet_busy_until);
+        fleet_busy_until = p_tx->end;
+    }
+    p_tx->started = 1;
+    fleet_heap_push(p_tx);
+}
+
+/* Time on air of the copy of an advertising event on one advertising channel */
+static uint64_t fleet_channel_us(const fleet_tx_t *p_tx)
+{
+    return ((p_tx->end - p_tx->start) - (SIM_AIR_CHANNELS - 1) * SIM_AIR_CHANNEL_GAP_US) / SIM_AIR_CHANNELS;
+}
+
+/* Start of the copy of an advertising event on one advertising channel */
+static uint64_t fleet_channel_start(const fleet_tx_t *p_tx, uint32_t channel)
+{
+    return p_tx->start + channel * (fleet_channel_us(p_tx) + SIM_AIR_CHANNEL_GAP_US);
+}
+
+/*
+ * A receiver hears the copy of an advertising event on the channel it scans, unless it was transmitting
+ * itself or heard another copy on that channel overlapping it. Returns 1 when the copy collided.
+ */
+static int fleet_rx_lost(const fleet_tx_t *p_tx, uint32_t r)
+{
+    uint64_t rx_start, rx_end, other_start;
+    uint32_t i, channel;
+    int collided;
+
+    channel = (uint32_t)((p_tx->start / FLEET_SCAN_WINDOW_US + r) % SIM_AIR_CHANNELS);
+    rx_start = fleet_channel_start(p_tx, channel);
+    rx_end = rx_start + fleet_channel_us(p_tx);
+    for (collided = 0, i = 0; (i < fleet_air_count) && !collided; i++)
+    {
+        const fleet_tx_t *p_other = &fleet_air[i];
+
+        if ((p_other->start == p_tx->start) && (p_other->sender == p_tx->sender) && (p_other->pdu == p_tx->pdu))
+        {
+            continue;
+        }
+        if (p_other->sender == r)
+        {
+            collided = (p_other->start < rx_end) && (p_other->end > rx_start);
+        }
+        else if (fleet_in_range[p_other->sender * fleet_all + r])
+        {
+            other_start = fleet_channel_start(p_other, channel);
+            collided = (other_start < rx_end) && (other_start + fleet_channel_us(p_other) > rx_start);
+        }
+    }
+    return collided;
+}
+
+/*
+ * A PDU of a friendship ended. A Friend which receives a Friend Poll answers after the Receive Delay with
+ * the next queued message or a Friend Update. The Low Power Node receives the answer when it starts within
+ * the Receive Window, and polls again right away while messages remain queued, otherwise a poll interval
+ * after the last poll. A lost poll is not repeated before the next one.
+ */
+static void fleet_friend_rx(const fleet_tx_t *p_tx)
+{
+    uint16_t lpn = (FLEET_TX_POLL == p_tx->kind) ? p_tx->sender : p_tx->dst;
+    int received = fleet_in_range[p_tx->sender * fleet_all + p_tx->dst] && !fleet_rx_lost(p_tx, p_tx->dst);
+    uint64_t next;
+
+    if (FLEET_TX_POLL == p_tx->kind)
+    {
+        if (received)
+        {
+            fleet_friend_send(p_tx->end + fleet_friend.receive_delay, p_tx->dst, lpn,
+                              (0 != fleet_friend_queued(lpn, p_tx->end)) ? FLEET_TX_QUEUED : FLEET_TX_UPDATE, p_tx->end);
+            return;
+        }
+        fleet_polls_lost++;
+        fleet_friend_poll(lpn, p_tx->end + fleet_friend.poll_interval);
+        return;
+    }
+
+    next = p_tx->poll + fleet_friend.poll_interval;
+    if (received && (p_tx->start <= p_tx->poll + fleet_friend.receive_delay + fleet_friend.receive_window))
+    {
+        if (FLEET_TX_QUEUED == p_tx->kind)
+        {
+            fleet_delivered[lpn]++;
+            next = (0 != fleet_friend_queued(lpn, p_tx->end)) ? p_tx->end : next;
+        }
+    }
+    else
+    {
+        fleet_replies_lost++;
+    }
+    fleet_friend_poll(lpn, (next > p_tx->end) ? next : p_tx->end);
+}
+
+/*
+ * A transmission ended: every node in range receives the copy on the channel it scans, unless it
+ * collided. The gateway records the first arrival of the PDU, and a relay retransmits a PDU it has not
+ * seen before with the TTL decremented. The PDUs of a friendship are only for their receiver.
+ */
+static void fleet_tx_end(const fleet_tx_t *p_tx, uint32_t event_max_us)
+{
+    uint32_t gateway = fleet_opts.nodes;
+    uint32_t r, i;
+
+    for (r = 0; (FLEET_DST_ALL == p_tx->dst) && (r <= gateway); r++)
+    {
+        if ((r == p_tx->sender) || !fleet_in_range[p_tx->sender * fleet_all + r])
+        {
+            continue;
+        }
+        if (fleet_rx_lost(p_tx, r))
+        {
+            fleet_rx_collided++;
+            continue;
+        }
+        fleet_rx_ok++;
+        if (r == gateway)
+        {
+            if (0 == fleet_arrival[p_tx->pdu])
+            {
+                fleet_arrival[p_tx->pdu] = p_tx->end;
+            }
+        }
+        else if (fleet_relay[r] && (p_tx->ttl >= 2) && !fleet_cache_check((uint16_t)r, p_tx->pdu))
+        {
+            fleet_send(p_tx->end, (uint16_t)r, p_tx->pdu, p_tx->ttl - 1, (uint32_t)(p_tx->end - p_tx->start),
+                       fleet_opts.relay_transmits, fleet_opts.relay_interval, 1, FLEET_TX_RELAY);
+        }
+    }
+    if (FLEET_DST_ALL != p_tx->dst)
+    {
+        fleet_friend_rx(p_tx);
+    }
+
+    // Drop the transmissions which no longer overlap an event ending from now on
+    for (i = 0; i < fleet_air_count; )
+    {
+        if (fleet_air[i].end + event_max_us <= p_tx->end)
+        {
+            fleet_air[i] = fleet_air[--fleet_air_count];
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+/*
+ * Set up the friendships from the features of the build. A hub with the Friend feature befriends the
+ * Low Power Nodes of the --lpns option, up to MESH_FRIEND_MAX_LPN, which poll every --lpn-poll msec and
+ * get the --node-rate messages queued. A Low Power Node hub polls its Friend as the simulation of the
+ * node does. Returns -1 when the nodes do not fit the node index.
+ */
+static int fleet_friend_init(const sim_options_t *p_opts)
+{
+    memset(&fleet_friend, 0, sizeof(fleet_friend));
+    if (0 != (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND))
+    {
+        fleet_friend.lpns = (p_opts->traffic.lpns < mesh_config.friend_cfg.max_lpn_num) ? p_opts->traffic.lpns :
+                            mesh_config.friend_cfg.max_lpn_num;
+        fleet_friend.peers = fleet_friend.lpns;
+        fleet_friend.poll_interval = (uint64_t)p_opts->traffic.lpn_poll * 1000;
+        fleet_friend.msgs_per_hour = p_opts->traffic.node_msgs_per_hour;
+    }
+    else if (0 != (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER))
+    {
+        fleet_friend.peers = 1;
+        fleet_friend.poll_interval = (uint64_t)mesh_config.low_power.poll_timeout * 100000 / MESH_LPN_POLL_TIMEOUT_POLLS;
+    }
+    if (0 == fleet_friend.poll_interval)
+    {
+        fleet_friend.peers = 0;
+    }
+    fleet_friend.receive_delay = 1000ull * ((0 != mesh_config.low_power.receive_delay) ? mesh_config.low_power.receive_delay :
+                                            FLEET_RECEIVE_DELAY_MS);
+    fleet_friend.receive_window = 1000ull * ((0 != mesh_config.friend_cfg.receive_window) ? mesh_config.friend_cfg.receive_window :
+                                             FLEET_RECEIVE_WINDOW_MS);
+    fleet_friend.end = p_opts->duration * 1000;
+
+    fleet_all = (fleet_opts.nodes + 1) + fleet_opts.nodes * fleet_friend.peers;
+    return (fleet_all < FLEET_DST_ALL) ? 0 : -1;
+}
+
+/*
+ * Start the polls of the Low Power Nodes, each at its own time within the first poll interval, and
+ * their queued messages at their own time within the first message interval
+ */
+static void fleet_friend_start(void)
+{
+    uint32_t a;
+
+    for (a = 0; a < fleet_all; a++)
+    {
+        if (FLEET_DST_ALL != fleet_friend_of[a])
+        {
+            if (0 != fleet_friend.msgs_per_hour)
+            {
+                fleet_queue_phase[a] = fleet_random() % (3600000000ull / fleet_friend.msgs_per_hour);
+            }
+            fleet_friend_poll((uint16_t)a, fleet_random() % fleet_friend.poll_interval);
+        }
+    }
+}
+
+/*
+ * Lay the nodes out on a square grid and put the gateway half a spacing outside its first corner. The
+ * Low Power Nodes or the Friend of a hub sit at the hub. The positions are in half meters.
+ */
+static int fleet_topology(void)
+{
+    uint32_t n = fleet_all;
+    uint32_t gateway = fleet_opts.nodes;
+    uint32_t side = 1;
+    uint32_t relay_side = 0;
+    uint32_t relays, hub;
+    int64_t *p_x = calloc(n, sizeof(int64_t));
+    int64_t *p_y = calloc(n, sizeof(int64_t));
+    int64_t range = 2 * (int64_t)fleet_opts.range;
+    uint32_t a, b;
+
+    fleet_in_range = calloc((size_t)n * n, 1);
+    fleet_relay = calloc(n, 1);
+    fleet_cache = calloc(n, sizeof(fleet_cache_t));
+    fleet_node_busy = calloc(n, sizeof(uint64_t));
+    fleet_friend_of = calloc(n, sizeof(uint16_t));
+    fleet_delivered = calloc(n, sizeof(uint32_t));
+    fleet_queue_phase = calloc(n, sizeof(uint64_t));
+    if ((NULL == p_x) || (NULL == p_y) || (NULL == fleet_in_range) || (NULL == fleet_relay) || (NULL == fleet_cache) ||
+        (NULL == fleet_node_busy) || (NULL == fleet_friend_of) || (NULL == fleet_delivered) || (NULL == fleet_queue_phase))
+    {
+        free(p_x);
+        free(p_y);
+        return -1;
+    }
+    while (side * side < fleet_opts.nodes)
+    {
+        side++;
+    }
+    while (relay_side * relay_side < fleet_opts.relays)
+    {
+        relay_side++;
+    }
+
+    // The relays sit on a coarser grid starting at the corner of the gateway, and relay only when the build has the feature
+    for (relays = 0, a = 0; a < fleet_opts.nodes; a++)
+    {
+        p_x[a] = 2 * (int64_t)(a % side) * fleet_opts.spacing;
+        p_y[a] = 2 * (int64_t)(a / side) * fleet_opts.spacing;
+
+        fleet_relay[a] = (0 != (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_RELAY)) && (0 != relay_side) &&
+                         FLEET_RELAY_COORD(a % side, side, relay_side) && FLEET_RELAY_COORD(a / side, side, relay_side);
+        relays += fleet_relay[a];
+    }
+    fleet_opts.relays = relays;
+    p_x[gateway] = -(int64_t)fleet_opts.spacing;
+    p_y[gateway] = -(int64_t)fleet_opts.spacing;
+
+    // A peer is a Low Power Node of its hub, or the Friend of its Low Power Node hub
+    for (a = 0; a < n; a++)
+    {
+        fleet_friend_of[a] = FLEET_DST_ALL;
+    }
+    for (a = gateway + 1; a < n; a++)
+    {
+        hub = (a - gateway - 1) / fleet_friend.peers;
+        p_x[a] = p_x[hub];
+        p_y[a] = p_y[hub];
+        if (0 != fleet_friend.lpns)
+        {
+            fleet_friend_of[a] = (uint16_t)hub;
+        }
+        else
+        {
+            fleet_friend_of[hub] = (uint16_t)a;
+        }
+    }
+
+    for (a = 0; a < n; a++)
+    {
+        for (b = 0; b < n; b++)
+        {
+            fleet_in_range[a * n + b] = ((p_x[a] - p_x[b]) * (p_x[a] - p_x[b]) + (p_y[a] - p_y[b]) * (p_y[a] - p_y[b]) <= range * range);
+        }
+    }
+    free(p_x);
+    free(p_y);
+    return 0;
+}
+
+static int fleet_tx_compare(const void *p_a, const void *p_b)
+{
+    const sim_tx_t *p_ta = (const sim_tx_t *)p_a;
+    const sim_tx_t *p_tb = (const sim_tx_t *)p_b;
+
+    if (p_ta->time != p_tb->time)
+    {
+        return (p_ta->time > p_tb->time) ? 1 : -1;
+    }
+    return (int)p_ta->node - (int)p_tb->node;
+}
+
+static int fleet_latency_compare(const void *p_a, const void *p_b)
+{
+    uint64_t a = *(const uint64_t *)p_a;
+    uint64_t b = *(const uint64_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+/* Latency percentile in msec of the sorted latencies in usec */
+static double fleet_percentile(const uint64_t *p_latency, uint32_t count, uint32_t percent)
+{
+    return (0 != count) ? (p_latency[((uint64_t)(count - 1) * percent) / 100] / 1000.0) : 0.0;
+}
+
+/* Parse the options of the network, returns 0 when the argument is not one of them */
+static int fleet_option(int *p_argc, char **argv, int i)
+{
+    static const struct { const char *name; uint32_t *p_value; } options[] =
+    {
+        { "--nodes",                &fleet_opts.nodes },
+        { "--relays",               &fleet_opts.relays },
+        { "--spacing",              &fleet_opts.spacing },
+        { "--range",                &fleet_opts.range },
+        { "--transmits",            &fleet_opts.transmits },
+        { "--transmit-interval",    &fleet_opts.interval },
+        { "--relay-transmits",      &fleet_opts.relay_transmits },
+        { "--relay-interval",       &fleet_opts.relay_interval },
+    };
+    uint32_t o;
+
+    if (i + 1 >= *p_argc)
+    {
+        return 0;
+    }
+    if (0 == strcmp(argv[i], "--ttl"))
+    {
+        fleet_opts.ttl = (uint8_t)strtoul(argv[i + 1], NULL, 0);
+    }
+    else
+    {
+        for (o = 0; (o < sizeof(options) / sizeof(options[0])) && (0 != strcmp(argv[i], options[o].name)); o++)
+            ;
+        if (o == sizeof(options) / sizeof(options[0]))
+        {
+            return 0;
+        }
+        *options[o].p_value = strtoul(argv[i + 1], NULL, 0);
+    }
+    memmove(&argv[i], &argv[i + 2], (size_t)(*p_argc - i - 1) * sizeof(char *));
+    *p_argc -= 2;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opts;
+    sim_tx_t *p_tx;
+    uint32_t *p_first_pdu;
+    uint64_t *p_latency;
+    fleet_tx_t tx;
+    wiced_bool_t csv = WICED_FALSE;
+    uint32_t count, pdus, msg_pdus, event_us, event_max_us, delivered, p, m, i;
+    uint64_t arrival, next_msg;
+    int a;
+
+    fleet_opts.nodes = FLEET_NODES;
+    fleet_opts.relays = UINT32_MAX;
+    fleet_opts.spacing = FLEET_SPACING_M;
+    fleet_opts.range = FLEET_RANGE_M;
+    fleet_opts.transmits = FLEET_TRANSMITS;
+    fleet_opts.interval = FLEET_TRANSMIT_INTERVAL_MS;
+    fleet_opts.relay_transmits = FLEET_RELAY_TRANSMITS;
+    fleet_opts.relay_interval = FLEET_RELAY_INTERVAL_MS;
+    fleet_opts.ttl = FLEET_TTL;
+
+    // The network options and --csv are specific to this program, the other options are shared with the simulation
+    for (a = 1; a < argc; )
+    {
+        if (0 == strcmp(argv[a], "--csv"))
+        {
+            csv = WICED_TRUE;
+            memmove(&argv[a], &argv[a + 1], (size_t)(argc - a) * sizeof(char *));
+            argc--;
+        }
+        else if (!fleet_option(&argc, argv, a))
+        {
+            a++;
+        }
+    }
+    if (fleet_opts.relays > fleet_opts.nodes)
+    {
+        fleet_opts.relays = fleet_opts.nodes;
+    }
+
+    sim_options_init(&opts);
+    if ((sim_options_parse(&opts, argc, argv) != argc) || (0 == fleet_opts.nodes) || (fleet_opts.nodes >= UINT16_MAX) ||
+        (0 == fleet_opts.transmits) || (0 == fleet_opts.ttl))
+    {
+        sim_options_usage(argv[0]);
+        fprintf(stderr, "  --nodes N            sensor hubs of the site, on a square grid (default %u)\n", FLEET_NODES);
+        fprintf(stderr, "  --spacing M          distance between neighboring hubs in meters (default %u)\n", FLEET_SPACING_M);
+        fprintf(stderr, "  --range M            radio range in meters (default %u)\n", FLEET_RANGE_M);
+        fprintf(stderr, "  --relays N           hubs with the relay enabled, on a square grid over the site (default all)\n");
+        fprintf(stderr, "  --ttl N              publish TTL (default %u)\n", FLEET_TTL);
+        fprintf(stderr, "  --transmits N        transmissions of every network PDU (default %u)\n", FLEET_TRANSMITS);
+        fprintf(stderr, "  --transmit-interval MS  interval between the transmissions (default %u)\n", FLEET_TRANSMIT_INTERVAL_MS);
+        fprintf(stderr, "  --relay-transmits N  transmissions of every relayed network PDU (default %u)\n", FLEET_RELAY_TRANSMITS);
+        fprintf(stderr, "  --relay-interval MS  interval between the relay transmissions (default %u)\n", FLEET_RELAY_INTERVAL_MS);
+        fprintf(stderr, "  --csv                print one CSV line\n");
+        return 1;
+    }
+    if (0 != fleet_friend_init(&opts))
+    {
+        fprintf(stderr, "too many nodes with their Low Power Nodes or Friends\n");
+        return 1;
+    }
+    if ((0 != fleet_topology()) || (0 != sim_fleet_run(&opts, fleet_opts.nodes, &p_tx, &count)))
+    {
+        return 1;
+    }
+
+    // Number the network PDUs of the messages in the order they are sent
+    qsort(p_tx, count, sizeof(sim_tx_t), fleet_tx_compare);
+    p_first_pdu = calloc((size_t)count + 1, sizeof(uint32_t));
+    p_latency = calloc((0 != count) ? count : 1, sizeof(uint64_t));
+    for (pdus = 0, event_max_us = 0, i = 0; (NULL != p_first_pdu) && (i < count); i++)
+    {
+        p_first_pdu[i] = pdus;
+        pdus += sim_air_pdus(p_tx[i].access_len);
+        event_us = sim_air_event_us(p_tx[i].access_len);
+        event_max_us = (event_us > event_max_us) ? event_us : event_max_us;
+    }
+    fleet_arrival = calloc((0 != pdus) ? pdus : 1, sizeof(uint64_t));
+    if ((NULL == p_first_pdu) || (NULL == p_latency) || (NULL == fleet_arrival))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    p_first_pdu[count] = pdus;
+    if ((0 != fleet_friend.peers) && (fleet_friend_event_max_us() > event_max_us))
+    {
+        event_max_us = fleet_friend_event_max_us();
+    }
+    fleet_friend_start();
+
+    // The messages are sent in time order, each segment of a message transmits times after the other
+    for (i = 0; (i < count) || (0 != fleet_heap_count); )
+    {
+        next_msg = (i < count) ? p_tx[i].time * 1000 : UINT64_MAX;
+        if ((0 == fleet_heap_count) || (next_msg <= fleet_heap_key(0)))
+        {
+            msg_pdus = p_first_pdu[i + 1] - p_first_pdu[i];
+            event_us = sim_air_event_us(p_tx[i].access_len);
+            for (m = 0; m < msg_pdus; m++)
+            {
+                fleet_cache_check(p_tx[i].node, p_first_pdu[i] + m);
+                fleet_send(next_msg + (uint64_t)m * fleet_opts.interval * 1000, p_tx[i].node, p_first_pdu[i] + m, fleet_opts.ttl,
+                           event_us, fleet_opts.transmits, fleet_opts.interval, msg_pdus, FLEET_TX_PUBLISH);
+            }
+            i++;
+            continue;
+        }
+        fleet_heap_pop(&tx);
+        if (tx.started)
+        {
+            fleet_tx_end(&tx, event_max_us);
+        }
+        else
+        {
+            fleet_tx_start(&tx);
+        }
+    }
+
+    // A message arrives with the last of its network PDUs, and is dropped when one of them never arrives
+    for (delivered = 0, i = 0; i < count; i++)
+    {
+        for (arrival = 0, p = p_first_pdu[i]; p < p_first_pdu[i + 1]; p++)
+        {
+            if (0 == fleet_arrival[p])
+            {
+                break;
+            }
+            arrival = (fleet_arrival[p] > arrival) ? fleet_arrival[p] : arrival;
+        }
+        if (p == p_first_pdu[i + 1])
+        {
+            p_latency[delivered++] = arrival - p_tx[i].time * 1000;
+        }
+    }
+    qsort(p_latency, delivered, sizeof(uint64_t), fleet_latency_compare);
+
+    if (csv)
+    {
+        printf("nodes,relays,range_m,spacing_m,ttl,messages,dropped,channel_busy_pct,air_pct,relayed_tx,rx_collided_pct,latency_p50_ms,latency_p90_ms,latency_p99_ms,latency_max_ms,friend_polls,friend_lost\n");
+        printf("%u,%u,%u,%u,%u,%u,%u,%.3f,%.3f,%u,%.2f,%.1f,%.1f,%.1f,%.1f,%u,%u\n", fleet_opts.nodes,
+               fleet_opts.relays,
+               fleet_opts.range, fleet_opts.spacing, fleet_opts.ttl, count, count - delivered,
+               100.0 * fleet_busy_us / (opts.duration * 1000.0), 100.0 * fleet_air_us / (opts.duration * 1000.0), fleet_tx_relayed,
+               (0 != fleet_rx_ok + fleet_rx_collided) ? (100.0 * fleet_rx_collided / (fleet_rx_ok + fleet_rx_collided)) : 0.0,
+               fleet_percentile(p_latency, delivered, 50), fleet_percentile(p_latency, delivered, 90),
+               fleet_percentile(p_latency, delivered, 99), fleet_percentile(p_latency, delivered, 100),
+               fleet_polls, fleet_polls_lost + fleet_replies_lost);
+    }
+    else
+    {
+        printf("site                  : %u nodes %u m apart, range %u m, gateway in a corner\n", fleet_opts.nodes,
+               fleet_opts.spacing, fleet_opts.range);
+        printf("features              : relay %s, proxy %s, friend %s, low power %s\n",
+               (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_RELAY) ? "yes" : "no",
+               (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_GATT_PROXY_SERVER) ? "yes" : "no",
+               (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND) ? "yes" : "no",
+               (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER) ? "yes" : "no");
+        printf("network               : %u relays, TTL %u, %u transmits %u ms apart, %u relay transmits %u ms apart\n",
+               fleet_opts.relays, fleet_opts.ttl,
+               fleet_opts.transmits, fleet_opts.interval, fleet_opts.relay_transmits, fleet_opts.relay_interval);
+        printf("messages              : %u, %u network PDUs\n", count, pdus);
+        printf("dropped messages      : %u (%.2f%%)\n", count - delivered, (0 != count) ? (100.0 * (count - delivered) / count) : 0.0);
+        printf("advertising events    : %u sent, %u relayed\n", fleet_tx_origin, fleet_tx_relayed);
+        printf("channel use           : %.3f%% busy at the gateway, %.3f%% air time of all nodes\n",
+               100.0 * fleet_busy_us / (opts.duration * 1000.0), 100.0 * fleet_air_us / (opts.duration * 1000.0));
+        printf("receptions            : %u, %u lost to collisions (%.2f%%)\n", fleet_rx_ok, fleet_rx_collided,
+               (0 != fleet_rx_ok + fleet_rx_collided) ? (100.0 * fleet_rx_collided / (fleet_rx_ok + fleet_rx_collided)) : 0.0);
+        if (0 != fleet_friend.peers)
+        {
+            printf("friendships           : %u per hub, %s, poll every %llu ms\n", fleet_friend.peers,
+                   (0 != fleet_friend.lpns) ? "hubs befriend Low Power Nodes" : "hubs poll their Friend",
+                   (unsigned long long)(fleet_friend.poll_interval / 1000));
+            printf("friend traffic        : %u polls, %u lost; %u replies, %u lost or late\n", fleet_polls, fleet_polls_lost,
+                   fleet_replies, fleet_replies_lost);
+        }
+        if (0 != delivered)
+        {
+            printf("latency to gateway    : p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+                   fleet_percentile(p_latency, delivered, 50), fleet_percentile(p_latency, delivered, 90),
+                   fleet_percentile(p_latency, delivered, 99), fleet_percentile(p_latency, delivered, 100));
+        }
+    }
+
+    free(p_tx);
+    free(p_first_pdu);
+    free(p_latency);
+    return 0;
+}
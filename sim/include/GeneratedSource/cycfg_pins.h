@@ -0,0 +1,4 @@
+/*
+ * Host simulation stand-in for the generated pin configuration.
+ */
+#include "wiced_sim.h"
@@ -0,0 +1,4 @@
+/*
+ * Host simulation stand-in for the WICED header of the same name.
+ */
+#include "wiced_sim.h"
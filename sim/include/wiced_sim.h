@@ -0,0 +1,504 @@
+/******************************************************************************
+* File Name:   wiced_sim.h
+*
+* Description: This file has the host simulation stand-ins for the WICED
+*              types and APIs used by the sensor hub application.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WICED_SIM_H_
+#define WICED_SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/******************************************************************************
+ *                              Basic types
+ ******************************************************************************/
+typedef uint8_t     wiced_bool_t;
+typedef uint8_t     UINT8;
+typedef uint16_t    UINT16;
+typedef uint32_t    UINT32;
+typedef uint8_t     wiced_bt_device_address_t[6];
+
+#define WICED_TRUE                              1
+#define WICED_FALSE                             0
+
+typedef enum
+{
+    WICED_SUCCESS = 0,
+    WICED_ERROR   = 1,
+    WICED_BADARG  = 5,
+} wiced_result_t;
+
+#define STREAM_TO_UINT16(u16, p)                {u16 = (uint16_t)((*(p)) + ((*((p) + 1)) << 8)); (p) += 2;}
+#define UINT16_TO_STREAM(p, u16)                {*(p)++ = (uint8_t)(u16); *(p)++ = (uint8_t)((u16) >> 8);}
+
+/******************************************************************************
+ *                              Trace
+ ******************************************************************************/
+void sim_trace(const char *fmt, ...);
+#define WICED_BT_TRACE(...)                     sim_trace(__VA_ARGS__)
+
+/******************************************************************************
+ *                              Transport
+ ******************************************************************************/
+wiced_result_t wiced_transport_send_data(uint16_t type, uint8_t *p_data, uint16_t data_size);
+
+// Host clock in nsec standing in for the cycle counter, MESH_PROBE_CYCLES=sim_probe_cycles
+uint32_t sim_probe_cycles(void);
+
+/******************************************************************************
+ *                              Timers
+ ******************************************************************************/
+typedef uintptr_t TIMER_PARAM_TYPE;
+typedef void (*wiced_timer_callback_t)(TIMER_PARAM_TYPE arg);
+
+typedef enum
+{
+    WICED_SECONDS_TIMER = 1,
+    WICED_MILLI_SECONDS_TIMER,
+    WICED_SECONDS_PERIODIC_TIMER,
+    WICED_MILLI_SECONDS_PERIODIC_TIMER,
+} wiced_timer_type_t;
+
+typedef struct wiced_timer
+{
+    wiced_timer_callback_t  cback;
+    TIMER_PARAM_TYPE        arg;
+    wiced_timer_type_t      type;
+    uint64_t                deadline;
+    wiced_bool_t            in_use;
+    struct wiced_timer      *p_next;
+} wiced_timer_t;
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t TimerCb, TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type);
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout);
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer);
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer);
+wiced_result_t wiced_deinit_timer(wiced_timer_t *p_timer);
+
+/******************************************************************************
+ *                              Sleep
+ ******************************************************************************/
+#define WICED_SLEEP_NOT_ALLOWED                 0
+#define WICED_SLEEP_ALLOWED_WITHOUT_SHUTDOWN    1
+#define WICED_SLEEP_ALLOWED_WITH_SHUTDOWN       2
+#define WICED_SLEEP_MAX_TIME_TO_SLEEP           0xFFFFFFFF
+#define WICED_SLEEP_WAKE_SOURCE_GPIO            4
+
+typedef enum
+{
+    WICED_SLEEP_POLL_SLEEP_PERMISSION,
+    WICED_SLEEP_POLL_TIME_TO_SLEEP,
+} wiced_sleep_poll_type_t;
+
+typedef enum
+{
+    WICED_SLEEP_MODE_NO_TRANSPORT,
+    WICED_SLEEP_MODE_TRANSPORT,
+} wiced_sleep_mode_type_t;
+
+typedef enum
+{
+    WICED_SLEEP_WAKE_ACTIVE_LOW,
+    WICED_SLEEP_WAKE_ACTIVE_HIGH,
+} wiced_sleep_wake_type_t;
+
+typedef uint32_t (*wiced_sleep_allow_check_callback)(wiced_sleep_poll_type_t type);
+
+typedef struct
+{
+    wiced_sleep_mode_type_t             sleep_mode;
+    wiced_sleep_wake_type_t             host_wake_mode;
+    wiced_sleep_wake_type_t             device_wake_mode;
+    uint8_t                             device_wake_source;
+    uint32_t                            device_wake_gpio_num;
+    wiced_sleep_allow_check_callback    sleep_permit_handler;
+} wiced_sleep_config_t;
+
+wiced_result_t wiced_sleep_configure(wiced_sleep_config_t *p_sleep_config);
+
+/******************************************************************************
+ *                              NVRAM
+ ******************************************************************************/
+#define WICED_NVRAM_VSID_START                  0x200
+#define WICED_NVRAM_VSID_END                    0x3FFF
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+void wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status);
+
+/******************************************************************************
+ *                              Platform, GPIO, PWM, ADC
+ ******************************************************************************/
+#define WICED_HAL_GPIO_PIN_UNUSED               0xFF
+#define WICED_GPIO                              0
+#define WICED_PWM0                              1
+#define LED1                                    26
+#define I2C_SCL                                 28
+#define I2C_SDA                                 29
+#define PWM0                                    0
+#define PMU_CLK                                 0
+#define WICED_ACLK1                             1
+#define WICED_ACLK_FREQ_24_MHZ                  1
+#define ADC_INPUT_P8                            8
+
+typedef struct
+{
+    uint32_t init_count;
+    uint32_t toggle_count;
+} wiced_pwm_config_t;
+
+void wiced_hal_gpio_select_function(uint32_t pin, uint32_t function);
+void wiced_hal_gpio_set_pin_output(uint32_t pin, uint32_t val);
+wiced_bool_t wiced_hal_aclk_enable(uint32_t frequency, uint32_t clkSrc, uint32_t baseClk);
+wiced_bool_t wiced_hal_pwm_get_params(uint32_t clock_frequency_in, uint32_t duty_cycle, uint32_t pwm_frequency_out, wiced_pwm_config_t *params_out);
+wiced_bool_t wiced_hal_pwm_start(uint8_t channel, uint32_t clkSrc, uint32_t toggleCount, uint32_t initCount, wiced_bool_t invert);
+wiced_bool_t wiced_hal_pwm_enable(uint8_t channel);
+wiced_bool_t wiced_hal_pwm_disable(uint8_t channel);
+
+/******************************************************************************
+ *                              Sensor drivers
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t scl_pin;
+    uint8_t sda_pin;
+    uint8_t irq_pin;
+} max44009_user_set_t;
+
+typedef struct
+{
+    uint8_t high_pin;
+} thermistor_cfg_t;
+
+void max44009_init(max44009_user_set_t *max44009_usr_set, void (*user_fn)(void *, uint8_t), void *usr_data);
+uint8_t wiced_hal_i2c_write(uint8_t *p_data, uint16_t length, uint8_t slave);
+uint8_t wiced_hal_i2c_combined_read(uint8_t *p_tx_data, uint8_t tx_data_len, uint8_t *p_rx_data, uint16_t rx_data_len, uint8_t slave);
+uint32_t max44009_read_ambient_light(void);
+void thermistor_init(void);
+int16_t thermistor_read(thermistor_cfg_t *p_cfg);
+
+/******************************************************************************
+ *                              BLE / GATT configuration
+ ******************************************************************************/
+#define APPEARANCE_SENSOR_GENERIC               0x0540
+#define BTM_BLE_ADVERT_TYPE_NAME_COMPLETE       0x09
+#define BTM_BLE_ADVERT_TYPE_APPEARANCE          0x19
+
+typedef uint16_t wiced_bt_gatt_appearance_t;
+typedef uint8_t wiced_bt_device_address_t[6];
+
+typedef struct
+{
+    uint8_t     advert_type;
+    uint16_t    len;
+    uint8_t     *p_data;
+} wiced_bt_ble_advert_elem_t;
+
+typedef struct
+{
+    uint8_t *device_name;
+    struct
+    {
+        wiced_bt_gatt_appearance_t appearance;
+    } gatt_cfg;
+} wiced_bt_cfg_settings_t;
+
+void wiced_bt_dev_read_local_addr(wiced_bt_device_address_t bd_addr);
+
+/******************************************************************************
+ *                              Mesh core
+ ******************************************************************************/
+#define MESH_COMPANY_ID_BT_SIG                          0x0000
+#define WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV          0x1100
+#define WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SETUP_SRV    0x1101
+
+#define WICED_BT_MESH_CORE_FEATURE_BIT_RELAY            0x0001
+#define WICED_BT_MESH_CORE_FEATURE_BIT_GATT_PROXY_SERVER 0x0002
+#define WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND           0x0004
+#define WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER        0x0008
+
+#define MESH_ELEM_LOC_MAIN                              0x0000
+#define MESH_DEFAULT_TRANSITION_TIME_IN_MS              0
+#define WICED_BT_MESH_ON_POWER_UP_STATE_RESTORE         2
+
+#define WICED_BT_MESH_PROPERTY_DEVICE_MANUFACTURER_NAME         0x0011
+#define WICED_BT_MESH_PROPERTY_DEVICE_MODEL_NUMBER              0x0019
+#define WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL      0x004E
+#define WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE      0x004F
+#define WICED_BT_MESH_PROPERTY_TOTAL_DEVICE_RUNTIME             0x006E
+#define WICED_BT_MESH_PROPERTY_PRECISE_PRESENT_AMBIENT_TEMPERATURE  0x0075
+
+#define WICED_BT_MESH_PROPERTY_LEN_DEVICE_MANUFACTURER_NAME     36
+#define WICED_BT_MESH_PROPERTY_LEN_DEVICE_MODEL_NUMBER          24
+#define WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_LIGHT_LEVEL  3
+#define WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_TEMPERATURE  1
+#define WICED_BT_MESH_PROPERTY_LEN_TOTAL_DEVICE_RUNTIME         3
+#define WICED_BT_MESH_PROPERTY_LEN_PRECISE_PRESENT_AMBIENT_TEMPERATURE  2
+
+#define CONVERT_TOLERANCE_PERCENTAGE_TO_MESH(x)         ((uint16_t)((x) * 4095 / 100))
+#define WICED_BT_MESH_SENSOR_SAMPLING_FUNCTION_UNKNOWN  0
+#define WICED_BT_MESH_SENSOR_VAL_UNKNOWN                0
+#define WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE 3
+#define WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN            8
+
+typedef struct wiced_bt_mesh_event wiced_bt_mesh_event_t;
+typedef wiced_bool_t (*wiced_bt_mesh_core_received_msg_handler_t)(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+typedef struct
+{
+    uint16_t                                    company_id;
+    uint16_t                                    model_id;
+    wiced_bt_mesh_core_received_msg_handler_t   p_message_handler;
+    void                                        *p_scene_store_handler;
+    void                                        *p_scene_recall_handler;
+} wiced_bt_mesh_core_config_model_t;
+
+wiced_bool_t wiced_bt_mesh_model_sensor_server_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+wiced_bool_t wiced_bt_mesh_model_sensor_setup_server_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+#define WICED_BT_MESH_DEVICE \
+    { MESH_COMPANY_ID_BT_SIG, 0x0000, NULL, NULL, NULL }
+#define WICED_BT_MESH_MODEL_SENSOR_SERVER \
+    { MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV, wiced_bt_mesh_model_sensor_server_message_handler, NULL, NULL }, \
+    { MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SETUP_SRV, wiced_bt_mesh_model_sensor_setup_server_message_handler, NULL, NULL }
+
+typedef struct
+{
+    uint16_t    positive_tolerance;
+    uint16_t    negative_tolerance;
+    uint8_t     sampling_function;
+    uint8_t     measurement_period;
+    uint8_t     update_interval;
+} wiced_bt_mesh_sensor_config_descriptor_t;
+
+typedef struct
+{
+    uint16_t        fast_cadence_period_divisor;
+    wiced_bool_t    trigger_type_percentage;
+    uint32_t        trigger_delta_down;
+    uint32_t        trigger_delta_up;
+    uint32_t        min_interval;
+    uint32_t        fast_cadence_low;
+    uint32_t        fast_cadence_high;
+} wiced_bt_mesh_sensor_config_cadence_t;
+
+typedef struct
+{
+    uint16_t    setting_property_id;
+    uint8_t     access;
+    uint8_t     value_len;
+    uint8_t     *val;
+} wiced_bt_mesh_sensor_config_setting_t;
+
+typedef struct
+{
+    uint8_t     raw_valuex[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+    uint8_t     column_width[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+    uint8_t     raw_valuey[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+} wiced_bt_mesh_sensor_config_column_data_t;
+
+typedef struct
+{
+    uint16_t                                    property_id;
+    uint8_t                                     prop_value_len;
+    wiced_bt_mesh_sensor_config_descriptor_t    descriptor;
+    uint8_t                                     *data;
+    wiced_bt_mesh_sensor_config_cadence_t       cadence;
+    uint8_t                                     num_series;
+    wiced_bt_mesh_sensor_config_column_data_t   *series_columns;
+    uint8_t                                     num_settings;
+    wiced_bt_mesh_sensor_config_setting_t       *settings;
+} wiced_bt_mesh_core_config_sensor_t;
+
+typedef struct
+{
+    uint16_t    id;
+    uint8_t     type;
+    uint8_t     user_access;
+    uint16_t    max_len;
+    uint8_t     *value;
+} wiced_bt_mesh_core_config_property_t;
+
+typedef struct
+{
+    uint16_t                                location;
+    uint32_t                                default_transition_time;
+    uint8_t                                 onpowerup_state;
+    uint16_t                                default_level;
+    uint16_t                                range_min;
+    uint16_t                                range_max;
+    uint8_t                                 move_rollover;
+    uint8_t                                 properties_num;
+    wiced_bt_mesh_core_config_property_t    *properties;
+    uint8_t                                 sensors_num;
+    wiced_bt_mesh_core_config_sensor_t      *sensors;
+    uint8_t                                 models_num;
+    wiced_bt_mesh_core_config_model_t       *models;
+} wiced_bt_mesh_core_config_element_t;
+
+typedef struct
+{
+    uint16_t    receive_window;
+    uint16_t    cache_buf_len;
+    uint16_t    max_lpn_num;
+} wiced_bt_mesh_core_config_friend_t;
+
+typedef struct
+{
+    uint8_t     rssi_factor;
+    uint8_t     receive_window_factor;
+    uint8_t     min_cache_size_log;
+    uint8_t     receive_delay;
+    uint32_t    poll_timeout;
+} wiced_bt_mesh_core_config_low_power_t;
+
+typedef struct
+{
+    uint16_t                                company_id;
+    uint16_t                                product_id;
+    uint16_t                                vendor_id;
+    uint16_t                                replay_cache_size;
+    uint16_t                                features;
+    wiced_bt_mesh_core_config_friend_t      friend_cfg;
+    wiced_bt_mesh_core_config_low_power_t   low_power;
+    wiced_bool_t                            gatt_client_only;
+    uint8_t                                 elements_num;
+    wiced_bt_mesh_core_config_element_t     *elements;
+} wiced_bt_mesh_core_config_t;
+
+struct wiced_bt_mesh_event
+{
+    uint16_t    company_id;
+    uint16_t    model_id;
+    uint16_t    opcode;
+    uint8_t     element_idx;
+    uint16_t    src;
+    uint16_t    dst;
+    uint16_t    app_key_idx;
+    uint8_t     ttl;
+    uint8_t     retrans_cnt;
+    uint8_t     retrans_time;
+    uint8_t     reply;
+};
+
+// Friend and replay protection counters of the simulated core.  The WICED mesh core does not
+// provide them, so the application reads them only in the host build, see mesh_capacity.h.
+typedef struct
+{
+    uint16_t    friend_lpn_count;           // Low Power Nodes with an established friendship
+    uint16_t    friend_cache_used;          // Bytes of the Friend cache in use
+    uint16_t    friend_cache_peak;          // Most bytes of the Friend cache in use since the reset
+    uint32_t    friend_cache_drops;         // Messages discarded from a full Friend Queue
+    uint32_t    friend_rejects;             // Friend Requests refused with every friendship in use
+    uint32_t    replay_evictions;           // Replay protection entries taken over by another source
+} sim_core_capacity_t;
+
+uint32_t wiced_bt_mesh_core_get_tick_count(void);
+void sim_core_capacity_get(sim_core_capacity_t *p_capacity);
+void sim_core_capacity_reset(void);
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx);
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_reply_event(wiced_bt_mesh_event_t *p_event);
+void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event);
+wiced_result_t wiced_bt_mesh_core_send(wiced_bt_mesh_event_t *p_event, const uint8_t *p_data, uint16_t len, void *complete_callback);
+wiced_bool_t wiced_bt_mesh_set_raw_scan_response_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data);
+
+/******************************************************************************
+ *                              Sensor server model
+ ******************************************************************************/
+#define WICED_BT_MESH_SENSOR_GET                        0x10
+#define WICED_BT_MESH_SENSOR_COLUMN_GET                 0x11
+#define WICED_BT_MESH_SENSOR_SERIES_GET                 0x12
+#define WICED_BT_MESH_SENSOR_CADENCE_SET                0x13
+#define WICED_BT_MESH_SENSOR_SETTING_SET                0x14
+
+typedef struct
+{
+    uint16_t    property_id;
+} wiced_bt_mesh_sensor_get_t;
+
+typedef struct
+{
+    uint16_t    property_id;
+    uint8_t     prop_value_len;
+    uint8_t     raw_valuex[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+} wiced_bt_mesh_sensor_column_get_data_t;
+
+typedef struct
+{
+    uint16_t    property_id;
+    uint8_t     prop_value_len;
+    uint8_t     start_index;
+    uint8_t     raw_valuex1[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+    uint8_t     raw_valuex2[WICED_BT_MESH_MAX_SENSOR_PAYLOAD_LEN];
+} wiced_bt_mesh_sensor_series_get_data_t;
+
+typedef void (wiced_bt_mesh_sensor_server_report_handler_t)(uint16_t event, uint8_t element_idx, void *p_get, void *p_ref_data);
+typedef void (wiced_bt_mesh_sensor_server_config_change_handler_t)(uint8_t element_idx, uint16_t event, uint16_t property_id, uint16_t setting_property_id);
+
+void wiced_bt_mesh_model_sensor_server_init(uint8_t element_idx, wiced_bt_mesh_sensor_server_report_handler_t *p_report_callback,
+                                            wiced_bt_mesh_sensor_server_config_change_handler_t *p_config_change_callback, wiced_bool_t is_provisioned);
+void wiced_bt_mesh_model_sensor_server_data(uint8_t element_idx, uint16_t property_id, wiced_bt_mesh_event_t *p_ref_data);
+
+/******************************************************************************
+ *                              Mesh application library
+ ******************************************************************************/
+typedef void (*wiced_bt_mesh_app_init_t)(wiced_bool_t is_provisioned);
+typedef uint32_t (*wiced_bt_mesh_app_proc_rx_cmd_t)(uint16_t opcode, uint8_t *p_data, uint32_t length);
+typedef void (*wiced_bt_mesh_app_lpn_sleep_t)(uint32_t duration);
+typedef void (*wiced_bt_mesh_app_factory_reset_t)(void);
+typedef wiced_bool_t (*wiced_bt_mesh_app_notify_period_set_t)(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint32_t period);
+
+typedef struct
+{
+    wiced_bt_mesh_app_init_t                p_app_init;
+    void                                    *p_app_hardware_init;
+    void                                    *p_app_gatt_conn_status;
+    void                                    *p_app_attention;
+    wiced_bt_mesh_app_notify_period_set_t   p_app_notify_period_set;
+    wiced_bt_mesh_app_proc_rx_cmd_t         p_app_proc_rx_cmd;
+    wiced_bt_mesh_app_lpn_sleep_t           p_app_lpn_sleep;
+    wiced_bt_mesh_app_factory_reset_t       p_app_factory_reset;
+} wiced_bt_mesh_app_func_table_t;
+
+extern wiced_bt_mesh_core_config_t mesh_config;
+extern wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table;
+
+#endif /* WICED_SIM_H_ */
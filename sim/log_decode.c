@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   log_decode.c
+*
+* Description: This file shows the host decoder of the binary application
+*              log. It reads the log records sent with MESH_LOG_BINARY and
+*              prints them with the format strings of mesh_log_fmt.h.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "mesh_hci.h"
+#include "mesh_log.h"
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+// Format strings by message ID, the firmware keeps only the IDs
+static const char *log_formats[] =
+{
+#define MESH_LOG_FMT(id, format)                format,
+#include "mesh_log_fmt.h"
+#undef MESH_LOG_FMT
+};
+
+static const char *log_levels[] = { "NONE ", "ERROR", "WARN ", "INFO ", "DEBUG" };
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Little endian field of a record */
+static uint32_t log_field(const uint8_t *p, int len)
+{
+    uint32_t value = 0;
+
+    while (len--)
+    {
+        value = (value << 8) | p[len];
+    }
+    return value;
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t record[MESH_LOG_RECORD_MAX_LEN];
+    uint32_t args[MESH_LOG_MAX_ARGS];
+    uint32_t id, tick, records = 0;
+    uint8_t level, nargs, i;
+    FILE *fp = stdin;
+
+    if ((argc > 2) || ((2 == argc) && (0 == strcmp(argv[1], "--help"))))
+    {
+        fprintf(stderr, "usage: %s [FILE]\n"
+                        "  Decode the binary log records in FILE, or stdin, as written by the simulation\n"
+                        "  with --log or captured from the WICED HCI events %04x.\n", argv[0], HCI_CONTROL_SENSOR_HUB_EVENT_LOG);
+        return 1;
+    }
+    if ((2 == argc) && (NULL == (fp = fopen(argv[1], "rb"))))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    while (1 == fread(record, MESH_LOG_RECORD_HEADER_LEN, 1, fp))
+    {
+        id = log_field(&record[0], 2);
+        level = record[2] >> 4;
+        nargs = record[2] & 0x0F;
+        tick = log_field(&record[3], 4);
+
+        if ((nargs > MESH_LOG_MAX_ARGS) ||
+            ((0 != nargs) && (1 != fread(&record[MESH_LOG_RECORD_HEADER_LEN], 4 * nargs, 1, fp))))
+        {
+            fprintf(stderr, "truncated or corrupt record %u\n", records);
+            return 1;
+        }
+        memset(args, 0, sizeof(args));
+        for (i = 0; i < nargs; i++)
+        {
+            args[i] = log_field(&record[MESH_LOG_RECORD_HEADER_LEN + 4 * i], 4);
+        }
+        records++;
+
+        printf("[%10u] %s ", tick, (level <= MESH_LOG_LEVEL_DEBUG) ? log_levels[level] : "?    ");
+        if (id >= MESH_LOG_ID_COUNT)
+        {
+            printf("unknown message %u, decoder older than the firmware?\n", id);
+            continue;
+        }
+        // Messages are single lines, the leading newline of the banner is dropped
+        printf(log_formats[id] + ('\n' == log_formats[id][0]), args[0], args[1], args[2], args[3], args[4], args[5]);
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+################################################################################
+# \file ram_report.awk
+# \version 1.0
+#
+# \brief
+# Memory report of the application objects, from the output of 'size -A'.
+# Sections are sorted into code, constants left in flash, initialized data
+# copied to RAM and zeroed RAM. Run with 'make ram'.
+#
+################################################################################
+# \copyright
+# Copyright 2018-2021, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+# 
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# 
+#     http://www.apache.org/licenses/LICENSE-2.0
+# 
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+function flush()
+{
+    if (object != "")
+    {
+        printf "%-32s %8d %8d %8d %8d %8d\n", object, code, rodata, data, bss, data + bss
+        total_code += code; total_rodata += rodata; total_data += data; total_bss += bss
+    }
+    code = rodata = data = bss = 0
+}
+
+BEGIN {
+    printf "%-32s %8s %8s %8s %8s %8s\n", "object", "code", "const", "data", "bss", "ram"
+}
+
+# Header line of each object: "<path>  :"
+/^[^ ].*:$/ && $1 != "section" {
+    flush()
+    object = $1
+    sub(/^.*\/app\//, "", object)
+    next
+}
+
+# Relocated constants (.data.rel.ro) stay read-only, the firmware keeps them in flash
+$1 ~ /^\.text/                 { code += $2; next }
+$1 ~ /^\.rodata/                { rodata += $2; next }
+$1 ~ /^\.data\.rel\.ro/         { rodata += $2; next }
+$1 ~ /^\.data/                  { data += $2; next }
+$1 ~ /^\.bss/ || $1 == "COMMON" { bss += $2; next }
+
+END {
+    flush()
+    printf "%-32s %8d %8d %8d %8d %8d\n", "total", total_code, total_rodata, total_data, total_bss, total_data + total_bss
+}
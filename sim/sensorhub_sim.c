@@ -0,0 +1,296 @@
+/******************************************************************************
+* File Name:   sensorhub_sim.c
+*
+* Description: This file shows the sensor hub simulation program. It boots
+*              the application on the virtual clock, replays sensor traces
+*              and reports publish counts and CPU time per simulated hour.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "mesh_server.h"
+#include "mesh_probe.h"
+#include "mesh_capacity.h"
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Decode a little endian column field, the temperatures are the only signed properties */
+static int32_t sensorhub_column_value(const uint8_t *p_raw, const wiced_bt_mesh_core_config_sensor_t *p_config)
+{
+    uint32_t raw = 0;
+    uint8_t shift = (uint8_t)(32 - 8 * p_config->prop_value_len);
+    int i;
+
+    for (i = p_config->prop_value_len - 1; i >= 0; i--)
+    {
+        raw = (raw << 8) | p_raw[i];
+    }
+    if ((WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE == p_config->property_id) ||
+        (WICED_BT_MESH_PROPERTY_PRECISE_PRESENT_AMBIENT_TEMPERATURE == p_config->property_id))
+    {
+        return ((int32_t)(raw << shift)) >> shift;
+    }
+    return (int32_t)raw;
+}
+
+/* Pull the history of every sensor with one Sensor Series Get each and print the columns */
+static void sensorhub_print_series(void)
+{
+    const wiced_bt_mesh_core_config_sensor_t *p_config;
+    uint8_t e, i, c;
+
+    for (e = 0; e < mesh_config.elements_num; e++)
+    {
+        for (i = 0; i < mesh_config.elements[e].sensors_num; i++)
+        {
+            p_config = &mesh_config.elements[e].sensors[i];
+            sim_sensor_series_get(e, p_config->property_id);
+            printf("series of property %04x, %u columns (age: average)\n", p_config->property_id, p_config->num_series);
+            for (c = 0; c < p_config->num_series; c++)
+            {
+                printf("  %3d: %d\n", sensorhub_column_value(p_config->series_columns[c].raw_valuex, p_config),
+                       sensorhub_column_value(p_config->series_columns[c].raw_valuey, p_config));
+            }
+        }
+    }
+}
+
+/* A client polls every sensor with a Sensor Get each interval */
+static void sensorhub_run_polled(uint64_t end, uint64_t interval)
+{
+    const wiced_bt_mesh_core_config_element_t *p_element;
+    uint64_t t;
+    uint8_t e, i;
+
+    for (t = interval; t <= end; t += interval)
+    {
+        sim_run_until(t);
+        for (e = 0; e < mesh_config.elements_num; e++)
+        {
+            p_element = &mesh_config.elements[e];
+            for (i = 0; i < p_element->sensors_num; i++)
+            {
+                sim_sensor_get(e, p_element->sensors[i].property_id);
+            }
+        }
+    }
+    sim_run_until(end);
+}
+
+/* Print the read cache counters of every sensor */
+static void sensorhub_print_cache(void)
+{
+    const wiced_bt_mesh_core_config_element_t *p_element;
+    uint32_t hits, misses;
+    uint8_t e, i;
+
+    for (e = 0; e < mesh_config.elements_num; e++)
+    {
+        p_element = &mesh_config.elements[e];
+        for (i = 0; i < p_element->sensors_num; i++)
+        {
+            if (mesh_sensor_get_cache_stats(e, p_element->sensors[i].property_id, &hits, &misses))
+            {
+                printf("read cache %04x    : %u hits, %u misses (%.1f%% hits)\n", p_element->sensors[i].property_id,
+                       hits, misses, (0 == hits + misses) ? 0.0 : 100.0 * hits / (hits + misses));
+            }
+        }
+    }
+}
+
+/* Read out the pipeline probes over WICED HCI, as a host tool would, and print them */
+static void sensorhub_print_probes(void)
+{
+    static const char *names[] = { "cadence", "als read", "temp read", "decide", "publish", "get" };
+    uint32_t field[4];
+    const uint8_t *p;
+    uint16_t i;
+    int j, k;
+
+    sim_hci_event_len = 0;
+    if (!sim_hci_command(HCI_CONTROL_SENSOR_HUB_COMMAND_PROBE_GET, NULL, 0) ||
+        (HCI_CONTROL_SENSOR_HUB_EVENT_PROBE_STATS != sim_hci_event_opcode))
+    {
+        printf("probes              : not built, use APP_DEFINES=\"-DMESH_PROBE_ENABLE=1 -DMESH_PROBE_CYCLES=sim_probe_cycles\"\n");
+        return;
+    }
+    printf("probes (host ns)    : count, min, max, mean\n");
+    for (i = 0; i + MESH_PROBE_HCI_STATS_LEN <= sim_hci_event_len; i += MESH_PROBE_HCI_STATS_LEN)
+    {
+        p = &sim_hci_event[i];
+        for (j = 0; j < 4; j++)
+        {
+            field[j] = 0;
+            for (k = 3; k >= 0; k--)
+            {
+                field[j] = (field[j] << 8) | p[1 + 4 * j + k];
+            }
+        }
+        printf("  %-17s : %u, %u, %u, %u\n", (p[0] < sizeof(names) / sizeof(names[0])) ? names[p[0]] : "?",
+               field[0], field[1], field[2], field[3]);
+    }
+}
+
+/* Read out the Friend and replay protection statistics over WICED HCI and print them */
+static void sensorhub_print_capacity(void)
+{
+    uint32_t field[MESH_CAPACITY_FIELD_COUNT];
+    int i, k;
+
+    sim_hci_event_len = 0;
+    if (!sim_hci_command(HCI_CONTROL_SENSOR_HUB_COMMAND_CAPACITY_GET, NULL, 0) ||
+        (HCI_CONTROL_SENSOR_HUB_EVENT_CAPACITY_STATS != sim_hci_event_opcode) ||
+        (MESH_CAPACITY_HCI_STATS_LEN != sim_hci_event_len))
+    {
+        return;
+    }
+    for (i = 0; i < MESH_CAPACITY_FIELD_COUNT; i++)
+    {
+        field[i] = 0;
+        for (k = 3; k >= 0; k--)
+        {
+            field[i] = (field[i] << 8) | sim_hci_event[4 * i + k];
+        }
+    }
+    printf("friendships         : %u of %u, %u Friend Requests refused\n", field[MESH_CAPACITY_FIELD_LPN_COUNT],
+           field[MESH_CAPACITY_FIELD_LPN_MAX], field[MESH_CAPACITY_FIELD_FRIEND_REJECTS]);
+    printf("friend cache        : %u bytes, %u in use, peak %u, %u messages dropped\n", field[MESH_CAPACITY_FIELD_CACHE_LEN],
+           field[MESH_CAPACITY_FIELD_CACHE_USED], field[MESH_CAPACITY_FIELD_CACHE_PEAK], field[MESH_CAPACITY_FIELD_CACHE_DROPS]);
+    printf("replay protection   : %u entries, %u evictions\n", field[MESH_CAPACITY_FIELD_REPLAY_SIZE],
+           field[MESH_CAPACITY_FIELD_REPLAY_EVICTIONS]);
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opts;
+    wiced_bool_t series = WICED_FALSE;
+    wiced_bool_t probes = WICED_FALSE;
+    uint64_t get_interval = 0;
+    double hours;
+    int i;
+
+    // --series, --probes and --get-interval are specific to this program, the other options are shared with the benchmark
+    for (i = 1; i < argc; )
+    {
+        if (0 == strcmp(argv[i], "--series"))
+        {
+            series = WICED_TRUE;
+            memmove(&argv[i], &argv[i + 1], (size_t)(argc - i) * sizeof(char *));
+            argc--;
+        }
+        else if (0 == strcmp(argv[i], "--probes"))
+        {
+            probes = WICED_TRUE;
+            memmove(&argv[i], &argv[i + 1], (size_t)(argc - i) * sizeof(char *));
+            argc--;
+        }
+        else if ((0 == strcmp(argv[i], "--get-interval")) && (i + 1 < argc))
+        {
+            get_interval = strtoul(argv[i + 1], NULL, 0);
+            memmove(&argv[i], &argv[i + 2], (size_t)(argc - i - 1) * sizeof(char *));
+            argc -= 2;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    sim_options_init(&opts);
+    if (sim_options_parse(&opts, argc, argv) != argc)
+    {
+        sim_options_usage(argv[0]);
+        fprintf(stderr, "  --series             pull the sensor history with Sensor Series Get at the end\n");
+        fprintf(stderr, "  --probes             read out the publish path probes over WICED HCI at the end\n");
+        fprintf(stderr, "  --get-interval MS    a client polls every sensor with Sensor Get at this interval\n");
+        return 1;
+    }
+
+    sim_reset();
+    sim_boot();
+    if (0 != sim_options_apply(&opts))
+    {
+        return 1;
+    }
+    if (0 != get_interval)
+    {
+        sensorhub_run_polled(opts.duration, get_interval);
+    }
+    else
+    {
+        sim_run_until(opts.duration);
+    }
+    if (series)
+    {
+        sensorhub_print_series();
+    }
+
+    hours = (double)opts.duration / SIM_MS_PER_HOUR;
+    printf("simulated hours     : %.2f\n", hours);
+    printf("publishes           : %u (%.1f/h)\n", sim_stats.publishes, sim_stats.publishes / hours);
+    printf("status replies      : %u\n", sim_stats.status_replies);
+    if (0 != sim_stats.model_messages)
+    {
+        printf("vendor messages     : %u (%.1f/h)\n", sim_stats.model_messages, sim_stats.model_messages / hours);
+    }
+    printf("ALS reads           : %u (%.1f/h)\n", sim_stats.lux_reads, sim_stats.lux_reads / hours);
+    printf("thermistor reads    : %u (%.1f/h)\n", sim_stats.temp_reads, sim_stats.temp_reads / hours);
+    printf("timer starts        : %u (%.1f/h)\n", sim_stats.timer_starts, sim_stats.timer_starts / hours);
+    printf("wakeups             : %u (%.1f/h)\n", sim_stats.timer_expiries, sim_stats.timer_expiries / hours);
+    printf("sensor interrupts   : %u (%.1f/h)\n", sim_stats.sensor_irqs, sim_stats.sensor_irqs / hours);
+    printf("NVRAM writes        : %u\n", sim_stats.nvram_writes);
+    if ((0 != sim_stats.publishes) || (0 != sim_stats.status_replies))
+    {
+        printf("first status        : %llu ms\n", (unsigned long long)sim_stats.first_status_time);
+    }
+    printf("CPU time            : %.3f ms (%.3f ms/h)\n", sim_stats.cpu_ns / 1e6, sim_stats.cpu_ns / 1e6 / hours);
+    sensorhub_print_cache();
+    if ((0 != opts.traffic.lpns) || (0 != opts.traffic.senders))
+    {
+        sensorhub_print_capacity();
+    }
+    if (probes)
+    {
+        sensorhub_print_probes();
+    }
+    return 0;
+}
@@ -0,0 +1,216 @@
+/******************************************************************************
+* File Name:   sim.h
+*
+* Description: This file has the interface of the host simulation of the
+*              sensor hub: virtual clock, sensor trace replay, mesh stand-ins
+*              and statistics.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "wiced_sim.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+#define SIM_MS_PER_HOUR                         (60u * 60u * 1000u)
+#define SIM_MS_PER_DAY                          (24u * SIM_MS_PER_HOUR)
+
+// Sensor values used when no trace is loaded
+#define SIM_DEFAULT_LUX                         300
+#define SIM_DEFAULT_TEMP_CENTI_C                2150
+
+// Largest WICED HCI event kept for the host
+#define SIM_HCI_EVENT_MAX                       256
+
+// Nodes of a fleet simulated at the same time, each in its own process
+#define SIM_FLEET_BATCH                         32
+
+/*
+ * Advertising bearer: a network PDU takes the advertising and network overhead of 18 and 13 bytes
+ * around the lower transport PDU, and an advertising event sends it on the three advertising
+ * channels one after another, after a random delay of up to 10 ms.
+ */
+#define SIM_AIR_ADV_OVERHEAD                    18
+#define SIM_AIR_NET_OVERHEAD                    13
+#define SIM_AIR_TRANSMIC_LEN                    4
+#define SIM_AIR_UNSEG_MAX_LEN                   15      // Upper transport PDU of an unsegmented message
+#define SIM_AIR_SEG_LEN                         12      // Upper transport PDU bytes per segment
+#define SIM_AIR_US_PER_BYTE                     8
+#define SIM_AIR_CHANNELS                        3
+#define SIM_AIR_CHANNEL_GAP_US                  150
+#define SIM_AIR_ADV_DELAY_US                    10000
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+/* One recorded sample, value is in lux or 0.01 degC */
+typedef struct
+{
+    uint64_t    time;
+    int32_t     value;
+} sim_sample_t;
+
+/* Recorded sensor trace, the value holds until the next sample */
+typedef struct
+{
+    sim_sample_t    *samples;
+    uint32_t        count;
+} sim_series_t;
+
+typedef struct
+{
+    uint32_t    publishes;              // Sensor Status messages published
+    uint32_t    status_replies;         // Sensor Status messages sent in reply to a Get
+    uint32_t    lux_reads;              // Reads of the ambient light sensor
+    uint32_t    temp_reads;             // Reads of the thermistor
+    uint32_t    timer_starts;           // Hardware timer (re)starts
+    uint32_t    timer_expiries;         // Hardware timer expiries, i.e. wakeups
+    uint32_t    sensor_irqs;            // Sensor interrupts, i.e. wakeups not caused by a timer
+    uint32_t    nvram_writes;           // NVRAM write operations
+    uint32_t    friend_polls;           // Polls of the friend, on a Low Power Node
+    uint32_t    node_wakes;             // Distinct times the Low Power Node woke up
+    uint32_t    radio_wakes;            // Distinct times the Low Power Node used the radio, to poll or send
+    uint64_t    sleep_ms;               // Time the sleep permit handler let the Low Power Node sleep
+    uint32_t    model_messages;         // Messages sent by the vendor models
+    uint64_t    first_status_time;      // Time of the first Sensor Status, published or replied
+    uint64_t    cpu_ns;                 // Host CPU time spent in application code
+} sim_stats_t;
+
+/* A message sent by a node of a fleet */
+typedef struct
+{
+    uint64_t    time;                   // Time in msec the node handed the message to the mesh core
+    uint16_t    node;                   // Node index in the fleet
+    uint16_t    access_len;             // Access message length, opcode included
+} sim_tx_t;
+
+/* Sensors of the hub, as addressed by the simulation options */
+enum
+{
+    SIM_SENSOR_ALS,
+    SIM_SENSOR_TEMP,
+    SIM_SENSOR_COUNT
+};
+
+/* Traffic of the other nodes of the mesh, as seen by the mesh core of the hub */
+typedef struct
+{
+    uint32_t    lpns;                   // Low Power Nodes asking the hub for friendship
+    uint32_t    lpn_poll;               // Poll interval in msec of the Low Power Nodes
+    uint32_t    senders;                // Nodes sending application messages to the hub
+    uint32_t    node_msgs_per_hour;     // Messages for each Low Power Node and from each sender
+} sim_traffic_t;
+
+/* Options shared by the simulation programs */
+typedef struct
+{
+    const char                              *lux_path;
+    const char                              *temp_path;
+    uint64_t                                duration;                   // Simulated time in msec
+    uint32_t                                publish_period;             // Publish period in msec of the sensor elements
+    wiced_bt_mesh_sensor_config_cadence_t   cadence[SIM_SENSOR_COUNT];  // Cadence set to each sensor
+    uint32_t                                noise[SIM_SENSOR_COUNT];    // Amplitude of the read noise of each sensor
+    const char                              *log_path;                  // Binary log records are written here
+    sim_traffic_t                           traffic;                    // Traffic of the other nodes
+    uint32_t                                stream_interval;            // Sample interval set to the sensor stream, 0 leaves it stopped
+    uint32_t                                stream_samples;             // Samples per stream message, 0 for as many as fit
+    const char                              *stream_path;               // Messages of the sensor stream are written here
+    wiced_bool_t                            verbose;
+} sim_options_t;
+
+typedef void (*sim_publish_hook_t)(uint8_t element_idx, uint16_t property_id, const uint8_t *p_data, uint8_t len);
+typedef void (*sim_send_hook_t)(const wiced_bt_mesh_event_t *p_event, const uint8_t *p_data, uint16_t len);
+typedef void (*sim_tx_hook_t)(uint16_t access_len);
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+extern uint64_t             sim_now;
+extern sim_stats_t          sim_stats;
+extern sim_series_t         sim_lux_series;
+extern sim_series_t         sim_temp_series;
+extern wiced_bool_t         sim_verbose;
+extern uint32_t             sim_noise[SIM_SENSOR_COUNT];
+extern const uint16_t       sim_sensor_property_id[SIM_SENSOR_COUNT];
+extern sim_publish_hook_t   sim_publish_hook;
+extern sim_send_hook_t      sim_send_hook;
+extern sim_tx_hook_t        sim_tx_hook;
+extern uint16_t             sim_hci_event_opcode;
+extern uint16_t             sim_hci_event_len;
+extern uint8_t              sim_hci_event[SIM_HCI_EVENT_MAX];
+extern FILE                 *sim_log_file;
+extern FILE                 *sim_stream_file;
+extern sim_traffic_t        sim_traffic;
+extern wiced_bt_device_address_t sim_bd_addr;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+int sim_series_load(sim_series_t *p_series, const char *path);
+void sim_series_free(sim_series_t *p_series);
+int32_t sim_series_value_at(const sim_series_t *p_series, uint64_t time, int32_t default_value);
+
+void sim_reset(void);
+void sim_boot(void);
+void sim_run_until(uint64_t end);
+int sim_traffic_start(const sim_traffic_t *p_traffic);
+void sim_noise_seed(uint32_t seed);
+uint64_t sim_next_timer_deadline(void);
+
+void sim_set_publish_period(uint8_t element_idx, uint32_t period);
+void sim_set_cadence(uint8_t element_idx, uint16_t property_id, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence);
+void sim_sensor_get(uint8_t element_idx, uint16_t property_id);
+void sim_sensor_series_get(uint8_t element_idx, uint16_t property_id);
+wiced_bool_t sim_model_message(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t opcode, uint8_t *p_data, uint16_t len);
+int sim_find_sensor(uint16_t property_id, uint8_t *p_element_idx);
+wiced_bool_t sim_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length);
+
+int sim_fleet_run(const sim_options_t *p_opts, uint32_t nodes, sim_tx_t **pp_tx, uint32_t *p_count);
+uint32_t sim_air_pdus(uint16_t access_len);
+uint32_t sim_air_event_us(uint16_t access_len);
+
+void sim_options_init(sim_options_t *p_opts);
+int sim_options_parse(sim_options_t *p_opts, int argc, char **argv);
+void sim_options_usage(const char *prog);
+int sim_options_apply(const sim_options_t *p_opts);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,275 @@
+/******************************************************************************
+* File Name:   sim_fleet.c
+*
+* Description: This file shows the fleet runner of the host simulation. Every
+*              node of a fleet runs its own copy of the application in a
+*              child process, from the same options but with its own device
+*              address and read noise, and hands back the messages it sent.
+*              The advertising bearer model turns the messages into
+*              advertising events.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static sim_tx_t     *sim_fleet_tx = NULL;       // Messages sent by the node of this process
+static uint32_t     sim_fleet_count = 0;
+static uint32_t     sim_fleet_size = 0;
+static uint16_t     sim_fleet_node = 0;
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Append a message to an array grown as needed, returns -1 when out of memory */
+static int sim_fleet_append(sim_tx_t **pp_tx, uint32_t *p_count, uint32_t *p_size, const sim_tx_t *p_tx)
+{
+    sim_tx_t *p_new;
+
+    if (*p_count == *p_size)
+    {
+        *p_size = (0 != *p_size) ? (2 * *p_size) : 1024;
+        if (NULL == (p_new = realloc(*pp_tx, *p_size * sizeof(sim_tx_t))))
+        {
+            return -1;
+        }
+        *pp_tx = p_new;
+    }
+    (*pp_tx)[(*p_count)++] = *p_tx;
+    return 0;
+}
+
+/* Record a message of the node of this process */
+static void sim_fleet_tx_hook(uint16_t access_len)
+{
+    sim_tx_t tx = { sim_now, sim_fleet_node, access_len };
+
+    if (0 != sim_fleet_append(&sim_fleet_tx, &sim_fleet_count, &sim_fleet_size, &tx))
+    {
+        fprintf(stderr, "node %u: out of memory\n", sim_fleet_node);
+        _exit(1);
+    }
+}
+
+/* Write all bytes to a pipe */
+static int sim_fleet_write(int fd, const void *p_data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)p_data;
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if ((n = write(fd, p, len)) <= 0)
+        {
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* Read all bytes from a pipe, returns -1 at the end of the data */
+static int sim_fleet_read(int fd, void *p_data, size_t len)
+{
+    uint8_t *p = (uint8_t *)p_data;
+    ssize_t n;
+
+    while (len > 0)
+    {
+        if ((n = read(fd, p, len)) <= 0)
+        {
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/*
+ * Child process of a node: boot the node, configure it as the provisioning client configured all
+ * nodes at the same time, run it and write the count and the messages it sent to the pipe
+ */
+static void sim_fleet_node_run(const sim_options_t *p_opts, uint16_t node, int fd)
+{
+    sim_reset();
+    sim_fleet_node = node;
+    sim_bd_addr[4] = (uint8_t)(node >> 8);
+    sim_bd_addr[5] = (uint8_t)node;
+    sim_noise_seed(node + 1u);
+    sim_tx_hook = sim_fleet_tx_hook;
+    sim_boot();
+    if (0 != sim_options_apply(p_opts))
+    {
+        _exit(1);
+    }
+    sim_run_until(p_opts->duration);
+
+    if ((0 != sim_fleet_write(fd, &sim_fleet_count, sizeof(sim_fleet_count))) ||
+        (0 != sim_fleet_write(fd, sim_fleet_tx, sim_fleet_count * sizeof(sim_tx_t))))
+    {
+        _exit(1);
+    }
+    _exit(0);
+}
+
+/* Kill the nodes of a batch started so far, wait for them and close their pipes */
+static void sim_fleet_abort(const pid_t *p_pids, const int *p_fds, uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        kill(p_pids[i], SIGKILL);
+        close(p_fds[i]);
+    }
+    for (i = 0; i < n; i++)
+    {
+        waitpid(p_pids[i], NULL, 0);
+    }
+}
+
+/**
+ * Run the nodes of a fleet, SIM_FLEET_BATCH at a time, and collect the messages they sent, in node
+ * order and in time order for each node
+ *
+ * @param[in] p_opts            : Options every node runs with
+ * @param[in] nodes             : Number of nodes
+ * @param[out] pp_tx            : Messages, to be freed by the caller
+ * @param[out] p_count          : Number of messages
+ * @return                      : 0 on success
+ */
+int sim_fleet_run(const sim_options_t *p_opts, uint32_t nodes, sim_tx_t **pp_tx, uint32_t *p_count)
+{
+    int fds[SIM_FLEET_BATCH];
+    pid_t pids[SIM_FLEET_BATCH];
+    uint32_t size = 0;
+    uint32_t first, n, count, i;
+    sim_tx_t tx;
+    int pipe_fds[2];
+    int status;
+    int result = 0;
+
+    *pp_tx = NULL;
+    *p_count = 0;
+    fflush(NULL);
+
+    for (first = 0; first < nodes; first += SIM_FLEET_BATCH)
+    {
+        for (n = 0; (n < SIM_FLEET_BATCH) && (first + n < nodes); n++)
+        {
+            if (0 != pipe(pipe_fds))
+            {
+                perror("pipe");
+                sim_fleet_abort(pids, fds, n);
+                return -1;
+            }
+            if (0 == (pids[n] = fork()))
+            {
+                close(pipe_fds[0]);
+                sim_fleet_node_run(p_opts, (uint16_t)(first + n), pipe_fds[1]);
+            }
+            close(pipe_fds[1]);
+            fds[n] = pipe_fds[0];
+            if (pids[n] < 0)
+            {
+                perror("fork");
+                close(fds[n]);
+                sim_fleet_abort(pids, fds, n);
+                return -1;
+            }
+        }
+
+        // A node blocks on a full pipe until its turn comes, the nodes do not depend on each other
+        for (i = 0; i < n; i++)
+        {
+            if (0 != sim_fleet_read(fds[i], &count, sizeof(count)))
+            {
+                result = -1;
+            }
+            while ((0 == result) && (count-- > 0))
+            {
+                if ((0 != sim_fleet_read(fds[i], &tx, sizeof(tx))) || (0 != sim_fleet_append(pp_tx, p_count, &size, &tx)))
+                {
+                    result = -1;
+                }
+            }
+            close(fds[i]);
+            if ((waitpid(pids[i], &status, 0) < 0) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+            {
+                result = -1;
+            }
+        }
+        if (0 != result)
+        {
+            fprintf(stderr, "fleet nodes %u to %u failed\n", first, first + n - 1);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Network PDUs of an access message with a 4-byte TransMIC: unsegmented up to 11 bytes, otherwise segments */
+uint32_t sim_air_pdus(uint16_t access_len)
+{
+    uint32_t upper = access_len + SIM_AIR_TRANSMIC_LEN;
+
+    return (upper <= SIM_AIR_UNSEG_MAX_LEN) ? 1 : ((upper + SIM_AIR_SEG_LEN - 1) / SIM_AIR_SEG_LEN);
+}
+
+/* Time on air in usec of one advertising event carrying the longest network PDU of an access message */
+uint32_t sim_air_event_us(uint16_t access_len)
+{
+    uint32_t upper = access_len + SIM_AIR_TRANSMIC_LEN;
+    uint32_t pdu = SIM_AIR_ADV_OVERHEAD + SIM_AIR_NET_OVERHEAD +
+                   ((upper <= SIM_AIR_UNSEG_MAX_LEN) ? (1 + upper) : (4 + SIM_AIR_SEG_LEN));
+
+    return SIM_AIR_CHANNELS * pdu * SIM_AIR_US_PER_BYTE + (SIM_AIR_CHANNELS - 1) * SIM_AIR_CHANNEL_GAP_US;
+}
+
+/*END of FILE */
@@ -0,0 +1,303 @@
+/******************************************************************************
+* File Name:   sim_options.c
+*
+* Description: This file shows the command line options shared by the host
+*              simulation programs.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "mesh_stream.h"
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+void sim_options_init(sim_options_t *p_opts)
+{
+    int i;
+
+    memset(p_opts, 0, sizeof(*p_opts));
+    p_opts->duration = SIM_MS_PER_HOUR;
+    p_opts->traffic.lpn_poll = 10000;
+    p_opts->traffic.node_msgs_per_hour = 60;
+    for (i = 0; i < SIM_SENSOR_COUNT; i++)
+    {
+        // Same as the default cadence in mesh_cfg.c
+        p_opts->cadence[i].fast_cadence_period_divisor = 1;
+        p_opts->cadence[i].min_interval = 1 << 0x0C;
+    }
+}
+
+void sim_options_usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --lux FILE           ambient light trace, CSV of time_ms,lux\n"
+        "  --temp FILE          temperature trace, CSV of time_ms,centi-degC\n"
+        "  --hours N | --days N simulated time (default 1 hour)\n"
+        "  --period MS          publish period of the sensor server models\n"
+        "  --sensor als|temp|all  sensor the following cadence options apply to (default all)\n"
+        "  --min-interval MS    cadence minimum interval\n"
+        "  --delta-up N         status trigger delta up\n"
+        "  --delta-down N       status trigger delta down\n"
+        "  --percent            trigger deltas are in 0.01 %%\n"
+        "  --divisor N          fast cadence period divisor\n"
+        "  --fast-low N         fast cadence low\n"
+        "  --fast-high N        fast cadence high\n"
+        "  --noise N            add uniform noise of +/-N to every sensor read\n"
+        "  --log FILE           write the binary log records to FILE, see log_decode (MESH_LOG_BINARY builds)\n"
+        "  --lpns N             Low Power Nodes asking the hub for friendship\n"
+        "  --lpn-poll MS        poll interval of the Low Power Nodes (default 10000)\n"
+        "  --senders N          nodes sending application messages to the hub\n"
+        "  --node-rate N        messages per hour for each Low Power Node and from each sender (default 60)\n"
+        "  --stream-interval MS a client starts the sensor stream at this sample interval (MESH_SENSOR_STREAM builds)\n"
+        "  --stream-samples N   most samples per stream message (default as many as fit)\n"
+        "  --stream FILE        write the sensor stream messages to FILE, see stream_decode\n"
+        "  --verbose            print the application trace\n", prog);
+}
+
+/* Parse the shared options, returns the index of the first unknown argument or -1 on error */
+int sim_options_parse(sim_options_t *p_opts, int argc, char **argv)
+{
+    int first = 0, last = SIM_SENSOR_COUNT - 1;
+    int i, s;
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        uint32_t num = (NULL != val) ? (uint32_t)strtol(val, NULL, 0) : 0;
+
+        if (0 == strcmp(opt, "--verbose"))
+        {
+            p_opts->verbose = WICED_TRUE;
+            continue;
+        }
+        if (0 == strcmp(opt, "--percent"))
+        {
+            for (s = first; s <= last; s++)
+            {
+                p_opts->cadence[s].trigger_type_percentage = WICED_TRUE;
+            }
+            continue;
+        }
+        if (NULL == val)
+        {
+            return i;
+        }
+
+        if (0 == strcmp(opt, "--lux"))
+        {
+            p_opts->lux_path = val;
+        }
+        else if (0 == strcmp(opt, "--temp"))
+        {
+            p_opts->temp_path = val;
+        }
+        else if (0 == strcmp(opt, "--log"))
+        {
+            p_opts->log_path = val;
+        }
+        else if (0 == strcmp(opt, "--stream"))
+        {
+            p_opts->stream_path = val;
+        }
+        else if (0 == strcmp(opt, "--stream-interval"))
+        {
+            p_opts->stream_interval = num;
+        }
+        else if (0 == strcmp(opt, "--stream-samples"))
+        {
+            p_opts->stream_samples = num;
+        }
+        else if (0 == strcmp(opt, "--hours"))
+        {
+            p_opts->duration = (uint64_t)strtod(val, NULL) * SIM_MS_PER_HOUR;
+        }
+        else if (0 == strcmp(opt, "--days"))
+        {
+            p_opts->duration = (uint64_t)(strtod(val, NULL) * SIM_MS_PER_DAY);
+        }
+        else if (0 == strcmp(opt, "--lpns"))
+        {
+            p_opts->traffic.lpns = num;
+        }
+        else if (0 == strcmp(opt, "--lpn-poll"))
+        {
+            p_opts->traffic.lpn_poll = num;
+        }
+        else if (0 == strcmp(opt, "--senders"))
+        {
+            p_opts->traffic.senders = num;
+        }
+        else if (0 == strcmp(opt, "--node-rate"))
+        {
+            p_opts->traffic.node_msgs_per_hour = num;
+        }
+        else if (0 == strcmp(opt, "--period"))
+        {
+            p_opts->publish_period = num;
+        }
+        else if (0 == strcmp(opt, "--sensor"))
+        {
+            if (0 == strcmp(val, "als"))
+            {
+                first = last = SIM_SENSOR_ALS;
+            }
+            else if (0 == strcmp(val, "temp"))
+            {
+                first = last = SIM_SENSOR_TEMP;
+            }
+            else if (0 == strcmp(val, "all"))
+            {
+                first = 0;
+                last = SIM_SENSOR_COUNT - 1;
+            }
+            else
+            {
+                fprintf(stderr, "unknown sensor %s\n", val);
+                return -1;
+            }
+        }
+        else
+        {
+            for (s = first; s <= last; s++)
+            {
+                wiced_bt_mesh_sensor_config_cadence_t *p_cadence = &p_opts->cadence[s];
+
+                if (0 == strcmp(opt, "--min-interval"))
+                {
+                    p_cadence->min_interval = num;
+                }
+                else if (0 == strcmp(opt, "--delta-up"))
+                {
+                    p_cadence->trigger_delta_up = num;
+                }
+                else if (0 == strcmp(opt, "--delta-down"))
+                {
+                    p_cadence->trigger_delta_down = num;
+                }
+                else if (0 == strcmp(opt, "--divisor"))
+                {
+                    p_cadence->fast_cadence_period_divisor = (uint16_t)num;
+                }
+                else if (0 == strcmp(opt, "--fast-low"))
+                {
+                    p_cadence->fast_cadence_low = num;
+                }
+                else if (0 == strcmp(opt, "--fast-high"))
+                {
+                    p_cadence->fast_cadence_high = num;
+                }
+                else if (0 == strcmp(opt, "--noise"))
+                {
+                    p_opts->noise[s] = num;
+                }
+                else
+                {
+                    return i;
+                }
+            }
+        }
+        i++;
+    }
+    return argc;
+}
+
+/* Load the traces and configure the booted node as a provisioning client would */
+int sim_options_apply(const sim_options_t *p_opts)
+{
+    uint8_t set[MESH_STREAM_STATUS_LEN];
+    uint8_t element_idx, last_element = 0xFF;
+    int s;
+
+    sim_verbose = p_opts->verbose;
+    memcpy(sim_noise, p_opts->noise, sizeof(sim_noise));
+    if ((NULL != p_opts->lux_path) && (0 != sim_series_load(&sim_lux_series, p_opts->lux_path)))
+    {
+        return -1;
+    }
+    if ((NULL != p_opts->temp_path) && (0 != sim_series_load(&sim_temp_series, p_opts->temp_path)))
+    {
+        return -1;
+    }
+    if ((NULL != p_opts->log_path) && (NULL == (sim_log_file = fopen(p_opts->log_path, "wb"))))
+    {
+        perror(p_opts->log_path);
+        return -1;
+    }
+    if ((NULL != p_opts->stream_path) && (NULL == (sim_stream_file = fopen(p_opts->stream_path, "wb"))))
+    {
+        perror(p_opts->stream_path);
+        return -1;
+    }
+    if (0 != sim_traffic_start(&p_opts->traffic))
+    {
+        return -1;
+    }
+
+    for (s = 0; s < SIM_SENSOR_COUNT; s++)
+    {
+        if (0 != sim_find_sensor(sim_sensor_property_id[s], &element_idx))
+        {
+            continue;
+        }
+        sim_set_cadence(element_idx, sim_sensor_property_id[s], &p_opts->cadence[s]);
+        if (element_idx != last_element)
+        {
+            sim_set_publish_period(element_idx, p_opts->publish_period);
+            last_element = element_idx;
+        }
+    }
+
+    if (0 != p_opts->stream_interval)
+    {
+        set[0] = (uint8_t)p_opts->stream_interval;
+        set[1] = (uint8_t)(p_opts->stream_interval >> 8);
+        set[2] = (uint8_t)p_opts->stream_samples;
+        if (!sim_model_message(0, MESH_COMPANY_ID, MESH_STREAM_MODEL_ID, MESH_STREAM_OPCODE_SET, set, sizeof(set)))
+        {
+            fprintf(stderr, "no sensor stream model, build with APP_DEFINES=-DMESH_SENSOR_STREAM=1\n");
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+/******************************************************************************
+* File Name:   stream_decode.c
+*
+* Description: This file shows the host decoder of the vendor sensor stream.
+*              It reads the stream messages captured by the simulation with
+*              --stream, or by a client, and prints one time-stamped line per
+*              sample.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh_stream.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+// Capture record: tick count (uint32), opcode, parameter length, then the parameters
+#define STREAM_RECORD_HEADER_LEN                6
+#define STREAM_MAX_PARAMS_LEN                   255
+
+// Sensors told apart by the header of a Data message
+#define STREAM_MAX_SENSORS                      (MESH_STREAM_HDR_SENSOR_MASK + 1)
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/*
+ * Decode the samples of a Data message, returns the number of samples or -1 when a varint runs
+ * past the end of the message
+ */
+static int stream_decode_data(const uint8_t *p_data, int len, int32_t *p_values)
+{
+    uint32_t zigzag;
+    int32_t value = 0;
+    int pos = 1, count = 0, shift;
+
+    while (pos < len)
+    {
+        zigzag = 0;
+        shift = 0;
+        do
+        {
+            if ((pos >= len) || (shift > 28))
+            {
+                return -1;
+            }
+            zigzag |= (uint32_t)(p_data[pos] & 0x7F) << shift;
+            shift += 7;
+        } while (p_data[pos++] & 0x80);
+
+        // The first sample is the value, the others the difference to the sample before
+        value += (int32_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+        p_values[count++] = value;
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t record[STREAM_RECORD_HEADER_LEN + STREAM_MAX_PARAMS_LEN];
+    int32_t values[STREAM_MAX_PARAMS_LEN];
+    int next_seq[STREAM_MAX_SENSORS];
+    uint32_t tick, interval = 0, last_time;
+    uint32_t messages = 0, samples = 0, lost = 0;
+    uint8_t opcode, len, sensor, seq;
+    FILE *fp = stdin;
+    int i, count;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--interval")) && (i + 1 < argc))
+        {
+            interval = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((i + 1 == argc) && ('-' != argv[i][0]))
+        {
+            if (NULL == (fp = fopen(argv[i], "rb")))
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--interval MS] [FILE]\n"
+                            "  Decode the sensor stream messages in FILE, or stdin, as written by the simulation\n"
+                            "  with --stream. The sample interval is taken from the Stream Status messages, or\n"
+                            "  from --interval until the first one. Prints time_ms,sensor,value per sample.\n", argv[0]);
+            return 1;
+        }
+    }
+    memset(next_seq, -1, sizeof(next_seq));
+
+    printf("time_ms,sensor,value\n");
+    while (1 == fread(record, STREAM_RECORD_HEADER_LEN, 1, fp))
+    {
+        tick = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+        opcode = record[4];
+        len = record[5];
+        if ((0 != len) && (1 != fread(&record[STREAM_RECORD_HEADER_LEN], len, 1, fp)))
+        {
+            fprintf(stderr, "truncated record at %u ms\n", tick);
+            return 1;
+        }
+
+        if ((MESH_STREAM_OPCODE_STATUS == opcode) && (MESH_STREAM_STATUS_LEN == len))
+        {
+            interval = record[STREAM_RECORD_HEADER_LEN] | (record[STREAM_RECORD_HEADER_LEN + 1] << 8);
+            continue;
+        }
+        if ((MESH_STREAM_OPCODE_DATA != opcode) || (0 == len))
+        {
+            continue;
+        }
+
+        count = stream_decode_data(&record[STREAM_RECORD_HEADER_LEN], len, values);
+        if (count < 0)
+        {
+            fprintf(stderr, "corrupt Data message at %u ms\n", tick);
+            return 1;
+        }
+        sensor = record[STREAM_RECORD_HEADER_LEN] & MESH_STREAM_HDR_SENSOR_MASK;
+        seq = (record[STREAM_RECORD_HEADER_LEN] >> MESH_STREAM_HDR_SEQ_SHIFT) & MESH_STREAM_HDR_SEQ_MASK;
+        if ((next_seq[sensor] >= 0) && (seq != next_seq[sensor]))
+        {
+            lost += (seq - next_seq[sensor]) & MESH_STREAM_HDR_SEQ_MASK;
+        }
+        next_seq[sensor] = (seq + 1) & MESH_STREAM_HDR_SEQ_MASK;
+
+        // The last sample is taken when the message is sent, or one interval before if it was held back
+        last_time = tick - ((record[STREAM_RECORD_HEADER_LEN] & MESH_STREAM_HDR_HELD) ? interval : 0);
+        for (i = 0; i < count; i++)
+        {
+            printf("%u,%u,%d\n", last_time - (uint32_t)(count - 1 - i) * interval, sensor, values[i]);
+        }
+        messages++;
+        samples += count;
+    }
+
+    fprintf(stderr, "%u messages, %u samples, %u messages lost\n", messages, samples, lost);
+    return 0;
+}
@@ -0,0 +1,1141 @@
+/******************************************************************************
+* File Name:   wiced_sim.c
+*
+* Description: This file shows the host implementation of the WICED APIs used
+*              by the sensor hub application. Time is a virtual clock
+*              advanced by the simulation, sensors replay recorded traces.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sim.h"
+#include "mesh_hci.h"
+#include "mesh_cfg.h"
+#include "mesh_stream.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+#define SIM_NVRAM_ENTRIES                       32
+#define SIM_NVRAM_ENTRY_SIZE                    256
+#define SIM_EVENT_POOL                          4
+
+// MAX44009 model: continuous conversions, threshold interrupt registers
+#define SIM_MAX44009_ADDRESS                    0x4A
+#define SIM_MAX44009_PERIOD_MS                  800
+#define SIM_MAX44009_REG_INT_STATUS             0x00
+#define SIM_MAX44009_REG_INT_ENABLE             0x01
+#define SIM_MAX44009_REG_THRESHOLD_UPPER        0x05
+#define SIM_MAX44009_REG_THRESHOLD_LOWER        0x06
+#define SIM_MAX44009_REGS                       8
+
+// Mesh core model of the Friend feature and replay protection
+#define SIM_TRAFFIC_MAX_NODES                   256
+#define SIM_FRIEND_MSG_SIZE                     32      // Friend cache bytes per message, see MESH_FRIEND_CACHE_MSG_SIZE
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t    vs_id;
+    uint16_t    len;
+    uint8_t     data[SIM_NVRAM_ENTRY_SIZE];
+} sim_nvram_entry_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static uint64_t sim_cpu_now(void);
+static sim_nvram_entry_t *sim_nvram_find(uint16_t vs_id);
+static int32_t sim_noise_sample(uint32_t amplitude);
+static wiced_bool_t sim_max44009_irq_armed(void);
+static void sim_max44009_convert(void);
+static uint64_t sim_traffic_next(void);
+static void sim_traffic_run(void);
+static void sim_lpn_wake(wiced_bool_t radio);
+static void sim_lpn_idle(void);
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+uint64_t            sim_now = 0;
+sim_stats_t         sim_stats;
+sim_series_t        sim_lux_series;
+sim_series_t        sim_temp_series;
+wiced_bool_t        sim_verbose = WICED_FALSE;
+sim_publish_hook_t  sim_publish_hook = NULL;
+sim_send_hook_t     sim_send_hook = NULL;
+sim_tx_hook_t       sim_tx_hook = NULL;
+uint32_t            sim_noise[SIM_SENSOR_COUNT];
+uint16_t            sim_hci_event_opcode = 0;
+uint16_t            sim_hci_event_len = 0;
+uint8_t             sim_hci_event[SIM_HCI_EVENT_MAX];
+FILE                *sim_log_file = NULL;
+FILE                *sim_stream_file = NULL;
+
+const uint16_t sim_sensor_property_id[SIM_SENSOR_COUNT] =
+{
+    MESH_ALS_SENSOR_PROPERTY,
+    MESH_TEMP_SENSOR_PROPERTY,
+};
+
+sim_traffic_t       sim_traffic;
+
+wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
+
+// Device address of the hub, the fleet simulation gives each node its own
+wiced_bt_device_address_t sim_bd_addr = { 0x00, 0xA0, 0x50, 0x00, 0x00, 0x01 };
+
+static wiced_timer_t        *sim_timers = NULL;     // All initialized timers
+static sim_nvram_entry_t    sim_nvram[SIM_NVRAM_ENTRIES];
+static wiced_bt_mesh_event_t sim_events[SIM_EVENT_POOL];
+static uint8_t              sim_event_next = 0;
+static wiced_bool_t         sim_series_reply = WICED_FALSE;   // The library is answering a Sensor Series Get
+static uint8_t              sim_max44009_regs[SIM_MAX44009_REGS];
+static void                 (*sim_max44009_irq_fn)(void *, uint8_t) = NULL;
+static void                 *sim_max44009_irq_data = NULL;
+static uint8_t              sim_max44009_irq_pin = 0;
+static uint32_t             sim_noise_state = 1;    // Noise generator, reset with the simulation for repeatable runs
+
+// Node traffic: next message and poll of each Low Power Node, next message of each sender
+static uint64_t             sim_lpn_next_msg[SIM_TRAFFIC_MAX_NODES];
+static uint64_t             sim_lpn_next_poll[SIM_TRAFFIC_MAX_NODES];
+static uint64_t             sim_sender_next[SIM_TRAFFIC_MAX_NODES];
+static wiced_bool_t         sim_lpn_friend[SIM_TRAFFIC_MAX_NODES];     // Friendship established
+static uint16_t             sim_lpn_queued[SIM_TRAFFIC_MAX_NODES];     // Messages in the Friend Queue
+static uint16_t             sim_replay_src[SIM_TRAFFIC_MAX_NODES];     // Replay protection list, most recent source first
+static uint16_t             sim_replay_len = 0;
+static sim_core_capacity_t  sim_core_statistics;
+
+// Low Power Node model: polls of the friend of the hub, wakes and sleep of the hub
+static uint64_t             sim_friend_poll_next = UINT64_MAX;
+static uint32_t             sim_friend_poll_interval = 0;          // 0 unless the hub is a Low Power Node
+static wiced_sleep_config_t *sim_sleep_config = NULL;
+static uint64_t             sim_wake_tick = UINT64_MAX;            // Last wake, events of the same msec share it
+static uint64_t             sim_radio_tick = UINT64_MAX;
+static uint64_t             sim_sleep_from = 0;                    // Start of the sleep the handler permitted
+static uint64_t             sim_sleep_allowed = 0;                 // Length of that sleep in msec, 0 if awake
+
+static wiced_bt_mesh_sensor_server_report_handler_t         *sim_report_cb = NULL;
+static wiced_bt_mesh_sensor_server_config_change_handler_t  *sim_config_cb = NULL;
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Trace is printed only in verbose mode, formatting is skipped otherwise */
+void sim_trace(const char *fmt, ...)
+{
+    va_list args;
+
+    if (!sim_verbose)
+    {
+        return;
+    }
+    printf("[%10llu] ", (unsigned long long)sim_now);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+uint64_t sim_cpu_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t sim_probe_cycles(void)
+{
+    return (uint32_t)sim_cpu_now();
+}
+
+/******************************************************************************
+ *                              WICED HCI
+ ******************************************************************************/
+
+/* Keep the last event sent to the host, log records go to the log file */
+wiced_result_t wiced_transport_send_data(uint16_t type, uint8_t *p_data, uint16_t data_size)
+{
+    if (data_size > sizeof(sim_hci_event))
+    {
+        return WICED_BADARG;
+    }
+    if (HCI_CONTROL_SENSOR_HUB_EVENT_LOG == type)
+    {
+        if (NULL != sim_log_file)
+        {
+            fwrite(p_data, 1, data_size, sim_log_file);
+        }
+        return WICED_SUCCESS;
+    }
+    sim_hci_event_opcode = type;
+    sim_hci_event_len = data_size;
+    memcpy(sim_hci_event, p_data, data_size);
+    return WICED_SUCCESS;
+}
+
+/* The host sends a command, returns whether the application processed it */
+wiced_bool_t sim_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    if (NULL == wiced_bt_mesh_app_func_table.p_app_proc_rx_cmd)
+    {
+        return WICED_FALSE;
+    }
+    return wiced_bt_mesh_app_func_table.p_app_proc_rx_cmd(opcode, p_data, length) ? WICED_TRUE : WICED_FALSE;
+}
+
+/******************************************************************************
+ *                              Sensor traces
+ ******************************************************************************/
+
+/* Load a "time_ms,value" CSV trace. Lines starting with '#' and a header are skipped. */
+int sim_series_load(sim_series_t *p_series, const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char line[128];
+    unsigned long long time;
+    long value;
+    uint32_t capacity = 0;
+
+    p_series->samples = NULL;
+    p_series->count = 0;
+    if (NULL == fp)
+    {
+        fprintf(stderr, "cannot open trace %s\n", path);
+        return -1;
+    }
+
+    while (NULL != fgets(line, sizeof(line), fp))
+    {
+        if (2 != sscanf(line, "%llu,%ld", &time, &value))
+        {
+            continue;
+        }
+        if (p_series->count == capacity)
+        {
+            capacity = capacity ? 2 * capacity : 1024;
+            p_series->samples = realloc(p_series->samples, capacity * sizeof(sim_sample_t));
+        }
+        p_series->samples[p_series->count].time = time;
+        p_series->samples[p_series->count].value = (int32_t)value;
+        p_series->count++;
+    }
+    fclose(fp);
+
+    if (0 == p_series->count)
+    {
+        fprintf(stderr, "trace %s has no samples\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+void sim_series_free(sim_series_t *p_series)
+{
+    free(p_series->samples);
+    p_series->samples = NULL;
+    p_series->count = 0;
+}
+
+/* Value of the trace at a given time, the trace repeats once it ends */
+int32_t sim_series_value_at(const sim_series_t *p_series, uint64_t time, int32_t default_value)
+{
+    uint64_t span;
+    uint32_t lo = 0, hi;
+
+    if (0 == p_series->count)
+    {
+        return default_value;
+    }
+
+    span = p_series->samples[p_series->count - 1].time + 1;
+    time %= span;
+
+    // Last sample not after the requested time
+    hi = p_series->count;
+    while (hi - lo > 1)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (p_series->samples[mid].time <= time)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return p_series->samples[lo].value;
+}
+
+/******************************************************************************
+ *                              Timers
+ ******************************************************************************/
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t TimerCb, TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type)
+{
+    wiced_timer_t *p;
+
+    p_timer->cback = TimerCb;
+    p_timer->arg = cBackparam;
+    p_timer->type = type;
+    p_timer->in_use = WICED_FALSE;
+
+    for (p = sim_timers; p != NULL; p = p->p_next)
+    {
+        if (p == p_timer)
+        {
+            return WICED_SUCCESS;
+        }
+    }
+    p_timer->p_next = sim_timers;
+    sim_timers = p_timer;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout)
+{
+    uint64_t scale = ((WICED_SECONDS_TIMER == p_timer->type) || (WICED_SECONDS_PERIODIC_TIMER == p_timer->type)) ? 1000 : 1;
+
+    p_timer->deadline = sim_now + scale * timeout;
+    p_timer->in_use = WICED_TRUE;
+    sim_stats.timer_starts++;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer)
+{
+    p_timer->in_use = WICED_FALSE;
+    return WICED_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer)
+{
+    return p_timer->in_use;
+}
+
+wiced_result_t wiced_deinit_timer(wiced_timer_t *p_timer)
+{
+    wiced_timer_t **pp;
+
+    for (pp = &sim_timers; *pp != NULL; pp = &(*pp)->p_next)
+    {
+        if (*pp == p_timer)
+        {
+            *pp = p_timer->p_next;
+            break;
+        }
+    }
+    p_timer->in_use = WICED_FALSE;
+    return WICED_SUCCESS;
+}
+
+/* Virtual time of the earliest running timer, UINT64_MAX if none */
+uint64_t sim_next_timer_deadline(void)
+{
+    uint64_t next = UINT64_MAX;
+    wiced_timer_t *p;
+
+    for (p = sim_timers; p != NULL; p = p->p_next)
+    {
+        if (p->in_use && (p->deadline < next))
+        {
+            next = p->deadline;
+        }
+    }
+    return next;
+}
+
+/* Advance the virtual clock up to end, running every timer expiring on the way */
+void sim_run_until(uint64_t end)
+{
+    wiced_timer_t *p, *p_first;
+    uint64_t start, conversion, traffic;
+
+    for (;;)
+    {
+        p_first = NULL;
+        for (p = sim_timers; p != NULL; p = p->p_next)
+        {
+            if (p->in_use && (p->deadline <= end) && ((NULL == p_first) || (p->deadline < p_first->deadline)))
+            {
+                p_first = p;
+            }
+        }
+
+        // Conversions of the light sensor only matter while its interrupt is armed
+        if (sim_max44009_irq_armed())
+        {
+            conversion = (sim_now / SIM_MAX44009_PERIOD_MS + 1) * SIM_MAX44009_PERIOD_MS;
+            if ((conversion <= end) && ((NULL == p_first) || (conversion < p_first->deadline)))
+            {
+                sim_now = conversion;
+                start = sim_cpu_now();
+                sim_max44009_convert();
+                sim_stats.cpu_ns += sim_cpu_now() - start;
+                sim_lpn_idle();
+                continue;
+            }
+        }
+
+        // Polls of the friend of a Low Power Node hub, served before the timers of the same msec
+        if ((sim_friend_poll_next <= end) && ((NULL == p_first) || (sim_friend_poll_next <= p_first->deadline)))
+        {
+            sim_now = sim_friend_poll_next;
+            sim_friend_poll_next += sim_friend_poll_interval;
+            sim_stats.friend_polls++;
+            sim_lpn_wake(WICED_TRUE);
+            sim_lpn_idle();
+            continue;
+        }
+
+        // Messages of the other nodes
+        traffic = sim_traffic_next();
+        if ((traffic <= end) && ((NULL == p_first) || (traffic < p_first->deadline)))
+        {
+            sim_now = traffic;
+            sim_traffic_run();
+            continue;
+        }
+
+        if (NULL == p_first)
+        {
+            break;
+        }
+
+        if (p_first->deadline > sim_now)
+        {
+            sim_now = p_first->deadline;
+        }
+        if ((WICED_SECONDS_PERIODIC_TIMER == p_first->type) || (WICED_MILLI_SECONDS_PERIODIC_TIMER == p_first->type))
+        {
+            p_first->deadline += (WICED_SECONDS_PERIODIC_TIMER == p_first->type) ? 1000 : 1;
+        }
+        else
+        {
+            p_first->in_use = WICED_FALSE;
+        }
+
+        sim_stats.timer_expiries++;
+        sim_lpn_wake(WICED_FALSE);
+        start = sim_cpu_now();
+        p_first->cback(p_first->arg);
+        sim_stats.cpu_ns += sim_cpu_now() - start;
+        sim_lpn_idle();
+    }
+    if (end > sim_now)
+    {
+        sim_now = end;
+    }
+}
+
+/******************************************************************************
+ *                              NVRAM
+ ******************************************************************************/
+sim_nvram_entry_t *sim_nvram_find(uint16_t vs_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < SIM_NVRAM_ENTRIES; i++)
+    {
+        if ((0 != sim_nvram[i].len) && (sim_nvram[i].vs_id == vs_id))
+        {
+            return &sim_nvram[i];
+        }
+    }
+    return NULL;
+}
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    sim_nvram_entry_t *p_entry = sim_nvram_find(vs_id);
+    uint32_t i;
+
+    for (i = 0; (NULL == p_entry) && (i < SIM_NVRAM_ENTRIES); i++)
+    {
+        if (0 == sim_nvram[i].len)
+        {
+            p_entry = &sim_nvram[i];
+        }
+    }
+    if ((NULL == p_entry) || (0 == data_length) || (data_length > SIM_NVRAM_ENTRY_SIZE))
+    {
+        *p_status = WICED_BADARG;
+        return 0;
+    }
+
+    sim_stats.nvram_writes++;
+    p_entry->vs_id = vs_id;
+    p_entry->len = data_length;
+    memcpy(p_entry->data, p_data, data_length);
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    sim_nvram_entry_t *p_entry = sim_nvram_find(vs_id);
+
+    if (NULL == p_entry)
+    {
+        *p_status = WICED_BADARG;
+        return 0;
+    }
+    if (data_length > p_entry->len)
+    {
+        data_length = p_entry->len;
+    }
+    memcpy(p_data, p_entry->data, data_length);
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+void wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status)
+{
+    sim_nvram_entry_t *p_entry = sim_nvram_find(vs_id);
+
+    if (NULL != p_entry)
+    {
+        p_entry->len = 0;
+    }
+    if (NULL != p_status)
+    {
+        *p_status = WICED_SUCCESS;
+    }
+}
+
+/******************************************************************************
+ *                              Platform and sensor drivers
+ ******************************************************************************/
+void wiced_hal_gpio_select_function(uint32_t pin, uint32_t function) { }
+void wiced_hal_gpio_set_pin_output(uint32_t pin, uint32_t val) { }
+wiced_bool_t wiced_hal_aclk_enable(uint32_t frequency, uint32_t clkSrc, uint32_t baseClk) { return WICED_TRUE; }
+wiced_bool_t wiced_hal_pwm_start(uint8_t channel, uint32_t clkSrc, uint32_t toggleCount, uint32_t initCount, wiced_bool_t invert) { return WICED_TRUE; }
+wiced_bool_t wiced_hal_pwm_enable(uint8_t channel) { return WICED_TRUE; }
+wiced_bool_t wiced_hal_pwm_disable(uint8_t channel) { return WICED_TRUE; }
+
+wiced_bool_t wiced_hal_pwm_get_params(uint32_t clock_frequency_in, uint32_t duty_cycle, uint32_t pwm_frequency_out, wiced_pwm_config_t *params_out)
+{
+    params_out->init_count = 0;
+    params_out->toggle_count = 0;
+    return WICED_TRUE;
+}
+
+void max44009_init(max44009_user_set_t *max44009_usr_set, void (*user_fn)(void *, uint8_t), void *usr_data)
+{
+    sim_max44009_irq_fn = user_fn;
+    sim_max44009_irq_data = usr_data;
+    sim_max44009_irq_pin = max44009_usr_set->irq_pin;
+}
+
+uint8_t wiced_hal_i2c_write(uint8_t *p_data, uint16_t length, uint8_t slave)
+{
+    if ((SIM_MAX44009_ADDRESS == slave) && (2 == length) && (p_data[0] < SIM_MAX44009_REGS))
+    {
+        sim_max44009_regs[p_data[0]] = p_data[1];
+    }
+    return 0;
+}
+
+uint8_t wiced_hal_i2c_combined_read(uint8_t *p_tx_data, uint8_t tx_data_len, uint8_t *p_rx_data, uint16_t rx_data_len, uint8_t slave)
+{
+    if ((SIM_MAX44009_ADDRESS == slave) && (1 == tx_data_len) && (1 == rx_data_len) && (p_tx_data[0] < SIM_MAX44009_REGS))
+    {
+        p_rx_data[0] = sim_max44009_regs[p_tx_data[0]];
+        // Reading the interrupt status clears it
+        if (SIM_MAX44009_REG_INT_STATUS == p_tx_data[0])
+        {
+            sim_max44009_regs[SIM_MAX44009_REG_INT_STATUS] = 0;
+        }
+    }
+    return 0;
+}
+
+/* The interrupt output is in use when the application registered a handler and enabled it */
+wiced_bool_t sim_max44009_irq_armed(void)
+{
+    return (NULL != sim_max44009_irq_fn) && (0 != sim_max44009_regs[SIM_MAX44009_REG_INT_ENABLE]);
+}
+
+/* One conversion of the sensor, raises the interrupt when the light level is outside the window */
+void sim_max44009_convert(void)
+{
+    uint8_t upper = sim_max44009_regs[SIM_MAX44009_REG_THRESHOLD_UPPER];
+    uint8_t lower = sim_max44009_regs[SIM_MAX44009_REG_THRESHOLD_LOWER];
+    uint64_t upper_mlux = (uint64_t)(((upper & 0x0F) << 4) | 0x0F) * 45 << (upper >> 4);
+    uint64_t lower_mlux = (uint64_t)((lower & 0x0F) << 4) * 45 << (lower >> 4);
+    uint64_t mlux;
+    int32_t lux;
+
+    if (0 != sim_max44009_regs[SIM_MAX44009_REG_INT_STATUS])
+    {
+        return;
+    }
+    lux = sim_series_value_at(&sim_lux_series, sim_now, SIM_DEFAULT_LUX) + sim_noise_sample(sim_noise[SIM_SENSOR_ALS]);
+    mlux = (uint64_t)((lux < 0) ? 0 : lux) * 1000;
+    if ((mlux > upper_mlux) || (mlux < lower_mlux))
+    {
+        sim_max44009_regs[SIM_MAX44009_REG_INT_STATUS] = 1;
+        sim_stats.sensor_irqs++;
+        sim_max44009_irq_fn(sim_max44009_irq_data, sim_max44009_irq_pin);
+    }
+}
+
+uint32_t max44009_read_ambient_light(void)
+{
+    int32_t lux = sim_series_value_at(&sim_lux_series, sim_now, SIM_DEFAULT_LUX) + sim_noise_sample(sim_noise[SIM_SENSOR_ALS]);
+
+    sim_stats.lux_reads++;
+    return (uint32_t)((lux < 0) ? 0 : lux);
+}
+
+void thermistor_init(void) { }
+
+/* Uniform noise in [-amplitude, amplitude] from a fixed-seed xorshift generator */
+int32_t sim_noise_sample(uint32_t amplitude)
+{
+    if (0 == amplitude)
+    {
+        return 0;
+    }
+    sim_noise_state ^= sim_noise_state << 13;
+    sim_noise_state ^= sim_noise_state >> 17;
+    sim_noise_state ^= sim_noise_state << 5;
+    return (int32_t)(sim_noise_state % (2 * amplitude + 1)) - (int32_t)amplitude;
+}
+
+/* Seed the read noise, nodes of a fleet each draw their own */
+void sim_noise_seed(uint32_t seed)
+{
+    sim_noise_state = (0 != seed) ? seed : 1;
+}
+
+int16_t thermistor_read(thermistor_cfg_t *p_cfg)
+{
+    sim_stats.temp_reads++;
+    return (int16_t)(sim_series_value_at(&sim_temp_series, sim_now, SIM_DEFAULT_TEMP_CENTI_C) + sim_noise_sample(sim_noise[SIM_SENSOR_TEMP]));
+}
+
+/******************************************************************************
+ *                              Mesh core and models
+ ******************************************************************************/
+uint32_t wiced_bt_mesh_core_get_tick_count(void)
+{
+    return (uint32_t)sim_now;
+}
+
+/* Copy of the counters, with the occupancy of the Friend cache in bytes */
+void sim_core_capacity_get(sim_core_capacity_t *p_capacity)
+{
+    *p_capacity = sim_core_statistics;
+}
+
+void sim_core_capacity_reset(void)
+{
+    sim_core_statistics.friend_cache_peak  = sim_core_statistics.friend_cache_used;
+    sim_core_statistics.friend_cache_drops = 0;
+    sim_core_statistics.friend_rejects     = 0;
+    sim_core_statistics.replay_evictions   = 0;
+}
+
+/* Virtual time of the next message or poll of the other nodes, UINT64_MAX if none */
+uint64_t sim_traffic_next(void)
+{
+    uint64_t next = UINT64_MAX;
+    uint32_t n;
+
+    for (n = 0; n < sim_traffic.lpns; n++)
+    {
+        next = (sim_lpn_next_msg[n] < next) ? sim_lpn_next_msg[n] : next;
+        next = (sim_lpn_next_poll[n] < next) ? sim_lpn_next_poll[n] : next;
+    }
+    for (n = 0; n < sim_traffic.senders; n++)
+    {
+        next = (sim_sender_next[n] < next) ? sim_sender_next[n] : next;
+    }
+    return next;
+}
+
+/*
+ * Run the node traffic due at sim_now, as the mesh core would see it. A message for a Low Power
+ * Node goes to its Friend Queue, which holds an equal share of the Friend cache and discards its
+ * oldest message when full; a poll empties the queue. A Low Power Node without friendship asks
+ * for one at its poll interval. A message from a sender takes the replay protection entry of the
+ * least recent source when its own source has none.
+ */
+void sim_traffic_run(void)
+{
+    uint32_t msg_interval = SIM_MS_PER_HOUR / sim_traffic.node_msgs_per_hour;
+    uint16_t capacity = 0;
+    uint16_t i;
+    uint32_t n;
+
+    if (0 != mesh_config.friend_cfg.max_lpn_num)
+    {
+        capacity = (uint16_t)(mesh_config.friend_cfg.cache_buf_len / mesh_config.friend_cfg.max_lpn_num / SIM_FRIEND_MSG_SIZE);
+    }
+
+    for (n = 0; n < sim_traffic.lpns; n++)
+    {
+        if (sim_lpn_next_msg[n] == sim_now)
+        {
+            sim_lpn_next_msg[n] += msg_interval;
+            // The message for a Low Power Node without friendship is not stored
+            if (sim_lpn_friend[n] && (sim_lpn_queued[n] >= capacity))
+            {
+                sim_core_statistics.friend_cache_drops++;
+            }
+            else if (sim_lpn_friend[n])
+            {
+                sim_lpn_queued[n]++;
+                sim_core_statistics.friend_cache_used += SIM_FRIEND_MSG_SIZE;
+                if (sim_core_statistics.friend_cache_used > sim_core_statistics.friend_cache_peak)
+                {
+                    sim_core_statistics.friend_cache_peak = sim_core_statistics.friend_cache_used;
+                }
+            }
+        }
+        if (sim_lpn_next_poll[n] == sim_now)
+        {
+            sim_lpn_next_poll[n] += sim_traffic.lpn_poll;
+            if (sim_lpn_friend[n])
+            {
+                sim_core_statistics.friend_cache_used -= sim_lpn_queued[n] * SIM_FRIEND_MSG_SIZE;
+                sim_lpn_queued[n] = 0;
+            }
+            else if (sim_core_statistics.friend_lpn_count < mesh_config.friend_cfg.max_lpn_num)
+            {
+                sim_lpn_friend[n] = WICED_TRUE;
+                sim_core_statistics.friend_lpn_count++;
+            }
+            else
+            {
+                sim_core_statistics.friend_rejects++;
+            }
+        }
+    }
+
+    for (n = 0; n < sim_traffic.senders; n++)
+    {
+        if (sim_sender_next[n] != sim_now)
+        {
+            continue;
+        }
+        sim_sender_next[n] += msg_interval;
+
+        for (i = 0; (i < sim_replay_len) && (sim_replay_src[i] != n + 1); i++)
+            ;
+        if (i == sim_replay_len)
+        {
+            if (sim_replay_len < mesh_config.replay_cache_size)
+            {
+                sim_replay_len++;
+            }
+            else
+            {
+                sim_core_statistics.replay_evictions++;
+                i--;
+            }
+        }
+        memmove(&sim_replay_src[1], &sim_replay_src[0], i * sizeof(sim_replay_src[0]));
+        sim_replay_src[0] = (uint16_t)(n + 1);
+    }
+}
+
+void wiced_bt_dev_read_local_addr(wiced_bt_device_address_t bd_addr)
+{
+    memcpy(bd_addr, sim_bd_addr, sizeof(wiced_bt_device_address_t));
+}
+
+wiced_bool_t wiced_bt_mesh_set_raw_scan_response_data(uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data)
+{
+    return WICED_TRUE;
+}
+
+wiced_bool_t wiced_bt_mesh_model_sensor_server_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    return WICED_FALSE;
+}
+
+wiced_bool_t wiced_bt_mesh_model_sensor_setup_server_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    return WICED_FALSE;
+}
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_event(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t dst, uint16_t app_key_idx)
+{
+    wiced_bt_mesh_event_t *p_event = &sim_events[sim_event_next++ % SIM_EVENT_POOL];
+
+    memset(p_event, 0, sizeof(*p_event));
+    p_event->element_idx = element_idx;
+    p_event->company_id = company_id;
+    p_event->model_id = model_id;
+    p_event->dst = dst;
+    p_event->app_key_idx = app_key_idx;
+    return p_event;
+}
+
+wiced_bt_mesh_event_t *wiced_bt_mesh_create_reply_event(wiced_bt_mesh_event_t *p_event)
+{
+    p_event->dst = p_event->src;
+    p_event->reply = WICED_TRUE;
+    return p_event;
+}
+
+void wiced_bt_mesh_release_event(wiced_bt_mesh_event_t *p_event) { }
+
+/* Messages of the sensor stream go to the stream file as records of tick, opcode, length and parameters */
+wiced_result_t wiced_bt_mesh_core_send(wiced_bt_mesh_event_t *p_event, const uint8_t *p_data, uint16_t len, void *complete_callback)
+{
+    uint32_t tick = (uint32_t)sim_now;
+    uint8_t header[6];
+    int i;
+
+    sim_stats.model_messages++;
+    sim_lpn_wake(WICED_TRUE);
+    if (NULL != sim_send_hook)
+    {
+        sim_send_hook(p_event, p_data, len);
+    }
+    if (NULL != sim_tx_hook)
+    {
+        // A vendor opcode takes 3 bytes, the opcodes of the SIG models used here 1 or 2
+        sim_tx_hook((uint16_t)(len + ((MESH_COMPANY_ID_BT_SIG != p_event->company_id) ? 3 : ((p_event->opcode < 0x80) ? 1 : 2))));
+    }
+    if ((NULL != sim_stream_file) && (MESH_COMPANY_ID == p_event->company_id) && (MESH_STREAM_MODEL_ID == p_event->model_id))
+    {
+        for (i = 0; i < 4; i++)
+        {
+            header[i] = (uint8_t)(tick >> (8 * i));
+        }
+        header[4] = (uint8_t)p_event->opcode;
+        header[5] = (uint8_t)len;
+        fwrite(header, 1, sizeof(header), sim_stream_file);
+        fwrite(p_data, 1, len, sim_stream_file);
+    }
+    return WICED_SUCCESS;
+}
+
+void wiced_bt_mesh_model_sensor_server_init(uint8_t element_idx, wiced_bt_mesh_sensor_server_report_handler_t *p_report_callback,
+                                            wiced_bt_mesh_sensor_server_config_change_handler_t *p_config_change_callback, wiced_bool_t is_provisioned)
+{
+    sim_report_cb = p_report_callback;
+    sim_config_cb = p_config_change_callback;
+}
+
+/* The library marshals the values of the sensors from mesh_config, property 0 sends all sensors of the element */
+void wiced_bt_mesh_model_sensor_server_data(uint8_t element_idx, uint16_t property_id, wiced_bt_mesh_event_t *p_ref_data)
+{
+    wiced_bt_mesh_core_config_element_t *p_element = &mesh_config.elements[element_idx];
+    uint16_t access_len;
+    uint8_t i;
+
+    if ((0 == sim_stats.publishes) && (0 == sim_stats.status_replies))
+    {
+        sim_stats.first_status_time = sim_now;
+    }
+    if (NULL == p_ref_data)
+    {
+        sim_stats.publishes++;
+    }
+    else
+    {
+        sim_stats.status_replies++;
+    }
+    sim_lpn_wake(WICED_TRUE);
+
+    // A Sensor Series Status carries the columns, not the present values
+    if (sim_series_reply)
+    {
+        return;
+    }
+
+    // Sensor Status opcode, then a Marshalled Property ID of 2 bytes (format A) before each value
+    access_len = 1;
+    for (i = 0; i < p_element->sensors_num; i++)
+    {
+        if ((0 == property_id) || (p_element->sensors[i].property_id == property_id))
+        {
+            access_len += 2 + p_element->sensors[i].prop_value_len;
+            if (NULL != sim_publish_hook)
+            {
+                sim_publish_hook(element_idx, p_element->sensors[i].property_id, p_element->sensors[i].data, p_element->sensors[i].prop_value_len);
+            }
+        }
+    }
+    if (NULL != sim_tx_hook)
+    {
+        sim_tx_hook(access_len);
+    }
+}
+
+/******************************************************************************
+ *                              Sleep
+ ******************************************************************************/
+wiced_result_t wiced_sleep_configure(wiced_sleep_config_t *p_sleep_config)
+{
+    sim_sleep_config = p_sleep_config;
+    return WICED_SUCCESS;
+}
+
+/* An event wakes the Low Power Node hub, the radio is up for a poll or a message */
+void sim_lpn_wake(wiced_bool_t radio)
+{
+    if (0 == sim_friend_poll_interval)
+    {
+        return;
+    }
+    if (0 != sim_sleep_allowed)
+    {
+        sim_stats.sleep_ms += ((sim_now - sim_sleep_from) < sim_sleep_allowed) ? (sim_now - sim_sleep_from) : sim_sleep_allowed;
+        sim_sleep_allowed = 0;
+    }
+    if (sim_now != sim_wake_tick)
+    {
+        sim_wake_tick = sim_now;
+        sim_stats.node_wakes++;
+    }
+    if (radio && (sim_now != sim_radio_tick))
+    {
+        sim_radio_tick = sim_now;
+        sim_stats.radio_wakes++;
+    }
+}
+
+/* The mesh core of a Low Power Node hub is idle until its next poll, ask the application how long to sleep */
+void sim_lpn_idle(void)
+{
+    uint64_t start;
+
+    if (0 == sim_friend_poll_interval)
+    {
+        return;
+    }
+    start = sim_cpu_now();
+    if (NULL != wiced_bt_mesh_app_func_table.p_app_lpn_sleep)
+    {
+        wiced_bt_mesh_app_func_table.p_app_lpn_sleep((uint32_t)(sim_friend_poll_next - sim_now));
+    }
+    sim_sleep_allowed = 0;
+    if ((NULL != sim_sleep_config) &&
+        (WICED_SLEEP_NOT_ALLOWED != sim_sleep_config->sleep_permit_handler(WICED_SLEEP_POLL_SLEEP_PERMISSION)))
+    {
+        sim_sleep_from = sim_now;
+        sim_sleep_allowed = sim_sleep_config->sleep_permit_handler(WICED_SLEEP_POLL_TIME_TO_SLEEP) / 1000;
+    }
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+}
+
+/******************************************************************************
+ *                              Simulation control
+ ******************************************************************************/
+
+/* Clear the clock, statistics, NVRAM and timers */
+void sim_reset(void)
+{
+    sim_now = 0;
+    sim_timers = NULL;
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    memset(sim_nvram, 0, sizeof(sim_nvram));
+    memset(sim_max44009_regs, 0, sizeof(sim_max44009_regs));
+    sim_noise_state = 1;
+    memset(&sim_traffic, 0, sizeof(sim_traffic));
+    memset(&sim_core_statistics, 0, sizeof(sim_core_statistics));
+    sim_friend_poll_next = UINT64_MAX;
+    sim_friend_poll_interval = 0;
+    sim_sleep_config = NULL;
+    sim_wake_tick = UINT64_MAX;
+    sim_radio_tick = UINT64_MAX;
+    sim_sleep_allowed = 0;
+}
+
+/* Start the traffic of the other nodes, spread evenly over the message and poll intervals */
+int sim_traffic_start(const sim_traffic_t *p_traffic)
+{
+    uint32_t msg_interval;
+    uint32_t n;
+
+    if ((p_traffic->lpns > SIM_TRAFFIC_MAX_NODES) || (p_traffic->senders > SIM_TRAFFIC_MAX_NODES) ||
+        (0 == p_traffic->lpn_poll) || (0 == p_traffic->node_msgs_per_hour))
+    {
+        fprintf(stderr, "traffic of at most %d Low Power Nodes and %d senders, with a poll interval and message rate\n",
+                SIM_TRAFFIC_MAX_NODES, SIM_TRAFFIC_MAX_NODES);
+        return -1;
+    }
+    sim_traffic = *p_traffic;
+    msg_interval = SIM_MS_PER_HOUR / sim_traffic.node_msgs_per_hour;
+
+    for (n = 0; n < sim_traffic.lpns; n++)
+    {
+        sim_lpn_next_msg[n]  = sim_now + 1 + (uint64_t)n * msg_interval / sim_traffic.lpns;
+        sim_lpn_next_poll[n] = sim_now + 1 + (uint64_t)n * sim_traffic.lpn_poll / sim_traffic.lpns;
+        sim_lpn_friend[n] = WICED_FALSE;
+        sim_lpn_queued[n] = 0;
+    }
+    for (n = 0; n < sim_traffic.senders; n++)
+    {
+        sim_sender_next[n] = sim_now + 1 + (uint64_t)n * msg_interval / sim_traffic.senders;
+    }
+    sim_replay_len = 0;
+    return 0;
+}
+
+/* Run the application initialization of a provisioned node */
+void sim_boot(void)
+{
+    uint64_t start = sim_cpu_now();
+
+    wiced_bt_mesh_app_func_table.p_app_init(WICED_TRUE);
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+
+    // A Low Power Node hub polls its friend MESH_LPN_POLL_TIMEOUT_POLLS times per poll timeout
+    if (0 != (mesh_config.features & WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER))
+    {
+        sim_friend_poll_interval = mesh_config.low_power.poll_timeout * 100 / MESH_LPN_POLL_TIMEOUT_POLLS;
+        sim_friend_poll_next = sim_now + sim_friend_poll_interval;
+        sim_lpn_idle();
+    }
+}
+
+/* Find the element serving a sensor property */
+int sim_find_sensor(uint16_t property_id, uint8_t *p_element_idx)
+{
+    uint8_t e, i;
+
+    for (e = 0; e < mesh_config.elements_num; e++)
+    {
+        for (i = 0; i < mesh_config.elements[e].sensors_num; i++)
+        {
+            if (mesh_config.elements[e].sensors[i].property_id == property_id)
+            {
+                *p_element_idx = e;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Configuration client sets the publication period of the sensor server on an element */
+void sim_set_publish_period(uint8_t element_idx, uint32_t period)
+{
+    uint64_t start = sim_cpu_now();
+
+    wiced_bt_mesh_app_func_table.p_app_notify_period_set(element_idx, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV, period);
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+}
+
+/* Sensor client sends a Cadence Set, the library copies it into mesh_config and notifies the application */
+void sim_set_cadence(uint8_t element_idx, uint16_t property_id, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence)
+{
+    wiced_bt_mesh_core_config_element_t *p_element = &mesh_config.elements[element_idx];
+    uint64_t start = sim_cpu_now();
+    uint8_t i;
+
+    for (i = 0; i < p_element->sensors_num; i++)
+    {
+        if (p_element->sensors[i].property_id == property_id)
+        {
+            p_element->sensors[i].cadence = *p_cadence;
+        }
+    }
+    if (NULL != sim_config_cb)
+    {
+        sim_config_cb(element_idx, WICED_BT_MESH_SENSOR_CADENCE_SET, property_id, 0);
+    }
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+}
+
+/* Sensor client sends a Sensor Get */
+void sim_sensor_get(uint8_t element_idx, uint16_t property_id)
+{
+    wiced_bt_mesh_sensor_get_t get = { .property_id = property_id };
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(element_idx, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV, 0, 0);
+    uint64_t start = sim_cpu_now();
+
+    if (NULL != sim_report_cb)
+    {
+        sim_report_cb(WICED_BT_MESH_SENSOR_GET, element_idx, &get, p_event);
+    }
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+}
+
+/* A client sends a message to a model of an element, returns WICED_FALSE if no model takes it */
+wiced_bool_t sim_model_message(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint16_t opcode, uint8_t *p_data, uint16_t len)
+{
+    wiced_bt_mesh_core_config_element_t *p_element = &mesh_config.elements[element_idx];
+    wiced_bt_mesh_event_t *p_event;
+    wiced_bool_t handled = WICED_FALSE;
+    uint64_t start = sim_cpu_now();
+    uint8_t i;
+
+    for (i = 0; (i < p_element->models_num) && !handled; i++)
+    {
+        if ((p_element->models[i].company_id != company_id) || (p_element->models[i].model_id != model_id) ||
+            (NULL == p_element->models[i].p_message_handler))
+        {
+            continue;
+        }
+        p_event = wiced_bt_mesh_create_event(element_idx, company_id, model_id, 0, 0);
+        p_event->opcode = opcode;
+        p_event->src = 0x0001;
+        handled = p_element->models[i].p_message_handler(p_event, p_data, len);
+    }
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+    return handled;
+}
+
+/* Sensor client sends a Sensor Series Get for all columns */
+void sim_sensor_series_get(uint8_t element_idx, uint16_t property_id)
+{
+    wiced_bt_mesh_sensor_series_get_data_t get = { .property_id = property_id };
+    wiced_bt_mesh_event_t *p_event = wiced_bt_mesh_create_event(element_idx, MESH_COMPANY_ID_BT_SIG, WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV, 0, 0);
+    uint64_t start = sim_cpu_now();
+
+    if (NULL != sim_report_cb)
+    {
+        sim_series_reply = WICED_TRUE;
+        sim_report_cb(WICED_BT_MESH_SENSOR_SERIES_GET, element_idx, &get, p_event);
+        sim_series_reply = WICED_FALSE;
+    }
+    sim_stats.cpu_ns += sim_cpu_now() - start;
+}
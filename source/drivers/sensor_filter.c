@@ -0,0 +1,159 @@
+/******************************************************************************
+* File Name:   sensor_filter.c
+*
+* Description: This file shows the implementation of the sensor sample
+*              filters. All filters use integer arithmetic only.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "sensor_filter.h"
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function        sensor_filter_init
+ *
+ *                 Configure a filter and clear its state.
+ *
+ * @param[in] p_filter            : Filter
+ * @param[in] type                : Filter type
+ * @param[in] taps                : Window of the moving average and median filters, 1 to SENSOR_FILTER_MAX_TAPS
+ * @param[in] ema_shift           : Weight of a new sample in the EMA filter is 1/2^ema_shift
+ * @return                        : None.
+ */
+void sensor_filter_init(sensor_filter_t *p_filter, sensor_filter_type_t type, uint8_t taps, uint8_t ema_shift)
+{
+    p_filter->type      = type;
+    p_filter->taps      = (taps == 0) ? 1 : ((taps > SENSOR_FILTER_MAX_TAPS) ? SENSOR_FILTER_MAX_TAPS : taps);
+    p_filter->ema_shift = ema_shift;
+    sensor_filter_reset(p_filter);
+}
+
+
+/**
+ * Function        sensor_filter_reset
+ *
+ *                 Drop all samples, the next sample restarts the filter.
+ *
+ * @param[in] p_filter            : Filter
+ * @return                        : None.
+ */
+void sensor_filter_reset(sensor_filter_t *p_filter)
+{
+    p_filter->count  = 0;
+    p_filter->next   = 0;
+    p_filter->sum    = 0;
+    p_filter->ema    = 0;
+    p_filter->output = 0;
+}
+
+
+/**
+ * Function        sensor_filter_push
+ *
+ *                 Add a sample to the filter.
+ *
+ * @param[in] p_filter            : Filter
+ * @param[in] sample              : New sample
+ * @return                        : Filtered value
+ */
+int32_t sensor_filter_push(sensor_filter_t *p_filter, int32_t sample)
+{
+    int32_t sorted[SENSOR_FILTER_MAX_TAPS];
+    int32_t value;
+    uint8_t i, j;
+
+    if (SENSOR_FILTER_EMA == p_filter->type)
+    {
+        // The first sample seeds the average
+        if (0 == p_filter->count)
+        {
+            p_filter->ema = sample * (1 << SENSOR_FILTER_EMA_FRAC_BITS);
+            p_filter->count = 1;
+        }
+        else
+        {
+            p_filter->ema += (sample * (1 << SENSOR_FILTER_EMA_FRAC_BITS) - p_filter->ema) >> p_filter->ema_shift;
+        }
+        p_filter->output = (p_filter->ema + (1 << (SENSOR_FILTER_EMA_FRAC_BITS - 1))) >> SENSOR_FILTER_EMA_FRAC_BITS;
+        return p_filter->output;
+    }
+
+    if (SENSOR_FILTER_NONE == p_filter->type)
+    {
+        p_filter->output = sample;
+        return p_filter->output;
+    }
+
+    // Replace the oldest sample of the window
+    if (p_filter->count == p_filter->taps)
+    {
+        p_filter->sum -= p_filter->window[p_filter->next];
+    }
+    else
+    {
+        p_filter->count++;
+    }
+    p_filter->window[p_filter->next] = sample;
+    p_filter->sum += sample;
+    p_filter->next = (uint8_t)((p_filter->next + 1) % p_filter->taps);
+
+    if (SENSOR_FILTER_MOVING_AVERAGE == p_filter->type)
+    {
+        // Rounded to the nearest integer
+        p_filter->output = (p_filter->sum + ((p_filter->sum < 0) ? -(p_filter->count / 2) : (p_filter->count / 2))) / p_filter->count;
+        return p_filter->output;
+    }
+
+    // Median, insertion sort of the window which is at most SENSOR_FILTER_MAX_TAPS long
+    for (i = 0; i < p_filter->count; i++)
+    {
+        value = p_filter->window[i];
+        for (j = i; (j > 0) && (sorted[j - 1] > value); j--)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+    p_filter->output = sorted[p_filter->count / 2];
+    return p_filter->output;
+}
+
+
+/*END of FILE */
@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name:   sensor_filter.h
+*
+* Description: This file has the data types and function prototypes of the
+*              fixed-point sensor sample filters.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SENSOR_FILTER_H_
+#define SENSOR_FILTER_H_
+
+#include "stdint.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Maximum window of the moving average and median filters
+#define SENSOR_FILTER_MAX_TAPS                  8
+
+// Fractional bits of the exponential moving average state
+#define SENSOR_FILTER_EMA_FRAC_BITS             8
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef enum
+{
+    SENSOR_FILTER_NONE,                 // Output is the last sample
+    SENSOR_FILTER_MOVING_AVERAGE,       // Average of the last taps samples
+    SENSOR_FILTER_MEDIAN,               // Median of the last taps samples
+    SENSOR_FILTER_EMA,                  // Exponential moving average, weight of a new sample is 1/2^ema_shift
+} sensor_filter_type_t;
+
+typedef struct
+{
+    sensor_filter_type_t    type;
+    uint8_t                 taps;                               // Window of the moving average and median filters
+    uint8_t                 ema_shift;                          // Smoothing of the EMA filter
+    uint8_t                 count;                              // Number of samples in the window
+    uint8_t                 next;                               // Position of the next sample in the window
+    int32_t                 window[SENSOR_FILTER_MAX_TAPS];     // Last samples
+    int32_t                 sum;                                // Sum of the samples in the window
+    int32_t                 ema;                                // EMA state in SENSOR_FILTER_EMA_FRAC_BITS fixed point
+    int32_t                 output;                             // Filtered value
+} sensor_filter_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void sensor_filter_init(sensor_filter_t *p_filter, sensor_filter_type_t type, uint8_t taps, uint8_t ema_shift);
+void sensor_filter_reset(sensor_filter_t *p_filter);
+int32_t sensor_filter_push(sensor_filter_t *p_filter, int32_t sample);
+
+#endif /* SENSOR_FILTER_H_ */
@@ -44,6 +44,12 @@
 #include "wiced_hal_adc.h"
 #include "wiced_thermistor.h"
 #include "max_44009.h"
+#include "wiced_hal_i2c.h"
+#include "wiced_bt_mesh_models.h"
+#include "mesh_cfg.h"
+#include "sensors.h"
+#include "mesh_probe.h"
+#include "mesh_log.h"
 #include "GeneratedSource/cycfg_pins.h"
 
 
@@ -56,6 +62,23 @@
 #define SENSOR_TEMP_MIN_VALUE                    (0x80)
 #define SENSOR_TEMP_MAX_VALUE                    (0x7F)
 
+// Range of the Temperature characteristic of the precise property, in 0.01 degree Celsius
+#define SENSOR_TEMP_PRECISE_MIN                  (-27315)
+#define SENSOR_TEMP_PRECISE_MAX                  (32767)
+
+// MAX44009 registers used for the threshold interrupt
+#define SENSOR_ALS_I2C_ADDRESS                   (0x4A)
+#define SENSOR_ALS_REG_INT_STATUS                (0x00)
+#define SENSOR_ALS_REG_INT_ENABLE                (0x01)
+#define SENSOR_ALS_REG_THRESHOLD_UPPER           (0x05)
+#define SENSOR_ALS_REG_THRESHOLD_LOWER           (0x06)
+#define SENSOR_ALS_REG_THRESHOLD_TIMER           (0x07)
+
+// A threshold is 4 bits of exponent and the 4 upper bits of an 8-bit mantissa counting 0.045 lux
+#define SENSOR_ALS_MILLILUX_PER_COUNT            (45)
+#define SENSOR_ALS_MAX_EXPONENT                  (14)
+#define SENSOR_ALS_MAX_LUX                       (188000)
+
 /******************************************************************************
  *                              Structures
  ******************************************************************************/
@@ -63,6 +86,23 @@
 /******************************************************************************
  *                          Function Prototypes
  ******************************************************************************/
+static void sensor_init_thermistor(void);
+static void sensor_init_als(void);
+static void sensor_sample_temperature(void);
+static int32_t sensor_get_temperature(void);
+static int32_t sensor_read_raw_temperature(void);
+static int32_t sensor_encode_temperature(int32_t temp_celsius_100);
+static void sensor_sample_light_level(void);
+static int32_t sensor_get_light_level(void);
+static int32_t sensor_read_raw_light_level(void);
+#if SENSOR_ALS_IRQ_MODE
+static void sensor_als_write_reg(uint8_t reg, uint8_t value);
+static uint8_t sensor_als_read_reg(uint8_t reg);
+static uint8_t sensor_als_threshold_upper(uint32_t lux, uint32_t value);
+static uint8_t sensor_als_threshold_lower(uint32_t lux, uint32_t value);
+static void sensor_als_irq_handler(void *p_data, uint8_t pin);
+static void sensor_set_light_level_window(wiced_bool_t enable, int32_t value, int32_t low, int32_t high);
+#endif
 
 /******************************************************************************
  *                          Variables Definitions
@@ -71,6 +111,43 @@
 max44009_user_set_t max44009_cfg;    // configuration structure for ambient light sensor
 thermistor_cfg_t  thermistor_cfg;    // configuration structure for thermistor
 
+sensor_filter_t sensor_als_filter;   // filter of the light level in lux
+sensor_filter_t sensor_temp_filter;  // filter of the temperature in hundredths of a degree Celsius
+
+#if SENSOR_ALS_IRQ_MODE
+sensor_irq_cback_t sensor_als_irq_cback = NULL;  // called when the light level leaves the threshold window
+wiced_bool_t sensor_als_window_enabled = WICED_FALSE;
+uint8_t sensor_als_upper;                        // programmed upper threshold register
+uint8_t sensor_als_lower;                        // programmed lower threshold register
+#endif
+
+/* The MAX44009 converts continuously, reading its result registers is one short I2C transfer */
+const sensor_driver_t sensor_als_driver =
+{
+    .property_id      = MESH_ALS_SENSOR_PROPERTY,
+    .is_signed        = WICED_FALSE,
+    .sample_interval  = SENSOR_ALS_SAMPLE_INTERVAL_MS,
+    .init             = sensor_init_als,
+    .read             = sensor_sample_light_level,
+    .value            = sensor_get_light_level,
+    .read_raw         = sensor_read_raw_light_level,
+#if SENSOR_ALS_IRQ_MODE
+    .set_window       = sensor_set_light_level_window,
+#endif
+};
+
+/* The thermistor library samples the ADC and converts the voltage in one call */
+const sensor_driver_t sensor_thermistor_driver =
+{
+    .property_id      = MESH_TEMP_SENSOR_PROPERTY,
+    .is_signed        = WICED_TRUE,
+    .sample_interval  = SENSOR_TEMP_SAMPLE_INTERVAL_MS,
+    .init             = sensor_init_thermistor,
+    .read             = sensor_sample_temperature,
+    .value            = sensor_get_temperature,
+    .read_raw         = sensor_read_raw_temperature,
+};
+
 /******************************************************************************
 *                                Function Definitions
 ******************************************************************************/
@@ -87,7 +164,8 @@ void sensor_init_thermistor(void)
     // Initialize thermistor
     thermistor_cfg.high_pin = ADC_INPUT_P8;
     thermistor_init();
-    WICED_BT_TRACE("Thermistor initialization done!\n");
+    sensor_filter_init(&sensor_temp_filter, SENSOR_TEMP_FILTER, SENSOR_TEMP_FILTER_TAPS, SENSOR_TEMP_FILTER_EMA_SHIFT);
+    MESH_LOG_INFO(MESH_LOG_THERMISTOR_INIT);
 }
 
 /**
@@ -102,29 +180,101 @@ void sensor_init_als(void)
     // Initialize ambient light sensor
     max44009_cfg.scl_pin = I2C_SCL;
     max44009_cfg.sda_pin = I2C_SDA;
+#if SENSOR_ALS_IRQ_MODE
+    max44009_cfg.irq_pin = SENSOR_ALS_IRQ_PIN;
+
+    max44009_init(&max44009_cfg, sensor_als_irq_handler, NULL);
+    // The window is programmed once the cadence engine knows the trigger deltas
+    sensor_als_write_reg(SENSOR_ALS_REG_INT_ENABLE, 0);
+    sensor_als_write_reg(SENSOR_ALS_REG_THRESHOLD_TIMER, SENSOR_ALS_IRQ_TIMER);
+#else
     max44009_cfg.irq_pin = WICED_HAL_GPIO_PIN_UNUSED;
 
     max44009_init(&max44009_cfg, NULL, NULL);
-    WICED_BT_TRACE("ALS sensor initialization done!\n");
+#endif
+    sensor_filter_init(&sensor_als_filter, SENSOR_ALS_FILTER, SENSOR_ALS_FILTER_TAPS, SENSOR_ALS_FILTER_EMA_SHIFT);
+    MESH_LOG_INFO(MESH_LOG_ALS_INIT);
+
+}
+
+
+/**
+ * Function        sensor_sample_temperature
+ *
+ *                 Read the thermistor and add the reading to the temperature filter.
+ *
+ * @return                        : None.
+ */
+void sensor_sample_temperature(void)
+{
+    int16_t temp_celsius_100;
+    MESH_PROBE_START(MESH_PROBE_TEMP_READ);
 
+    temp_celsius_100 = thermistor_read(&thermistor_cfg);
+    MESH_PROBE_STOP(MESH_PROBE_TEMP_READ);
+    sensor_filter_push(&sensor_temp_filter, temp_celsius_100);
 }
 
 
 /**
  * Function        sensor_get_temperature
  *
- *                 Helper function to read temperature from the thermistor and convert temperature in celsius
- *                 to Temperature 8 format.  Unit is degree Celsius with a resolution of 0.5. Minimum: -64.0 Maximum: 63.5.
+ *                 Function to get the filtered temperature of the thermistor
+ *
+ * @return                        : Temperature in the encoding of the temperature property.
+ */
+int32_t sensor_get_temperature(void)
+{
+    return sensor_encode_temperature(sensor_temp_filter.output);
+}
+
+
+/**
+ * Function        sensor_read_raw_temperature
+ *
+ *                 Read the thermistor once for the sensor stream, the temperature filter is left alone.
+ *
+ * @return                        : Temperature in the encoding of the temperature property.
+ */
+int32_t sensor_read_raw_temperature(void)
+{
+    int16_t temp_celsius_100;
+    MESH_PROBE_START(MESH_PROBE_TEMP_READ);
+
+    temp_celsius_100 = thermistor_read(&thermistor_cfg);
+    MESH_PROBE_STOP(MESH_PROBE_TEMP_READ);
+    return sensor_encode_temperature(temp_celsius_100);
+}
+
+
+/**
+ * Function        sensor_encode_temperature
  *
+ *                 Helper function to convert the temperature in celsius to Temperature 8 format.
+ *                 Unit is degree Celsius with a resolution of 0.5. Minimum: -64.0 Maximum: 63.5.
+ *                 With MESH_TEMP_SENSOR_PRECISE, the temperature is returned in the
+ *                 Temperature format instead, 0.01 degree Celsius from -273.15 to 327.67.
+ *
+ * @param[in] temp_celsius_100    : Temperature in hundredths of a degree Celsius
  * @return                        : Temperature in celsius.
  */
-int8_t sensor_get_temperature(void)
+int32_t sensor_encode_temperature(int32_t temp_celsius_100)
 {
-    int16_t temp_celsius_100 = thermistor_read(&thermistor_cfg);
+#if MESH_TEMP_SENSOR_PRECISE
+    if (temp_celsius_100 < SENSOR_TEMP_PRECISE_MIN)
+    {
+        return SENSOR_TEMP_PRECISE_MIN;
+    }
+    if (temp_celsius_100 > SENSOR_TEMP_PRECISE_MAX)
+    {
+        return SENSOR_TEMP_PRECISE_MAX;
+    }
+    return temp_celsius_100;
+#else
 
     if (temp_celsius_100 < SENSOR_TEMP_MIN_RANGE)
     {
-        return SENSOR_TEMP_MIN_VALUE;
+        return (int8_t)SENSOR_TEMP_MIN_VALUE;
     }
     else if (temp_celsius_100 >= SENSOR_TEMP_MAX_RANGE)
     {
@@ -134,20 +284,257 @@ int8_t sensor_get_temperature(void)
     {
         return (int8_t)((temp_celsius_100 / 50 )); /* divided by 50 to avoid floating values */
     }
+#endif
+}
+
+
+/**
+ * Function        sensor_sample_light_level
+ *
+ *                 Read the ALS sensor and add the reading to the light level filter.
+ *
+ * @return                        : None.
+ */
+void sensor_sample_light_level(void)
+{
+    uint32_t lux;
+    MESH_PROBE_START(MESH_PROBE_ALS_READ);
+
+    lux = max44009_read_ambient_light();
+    MESH_PROBE_STOP(MESH_PROBE_ALS_READ);
+    sensor_filter_push(&sensor_als_filter, (int32_t)lux);
 }
 
 
 /**
- * Function        sensor_get_ambient_lux
+ * Function        sensor_get_light_level
  *
- *                 Function to read light level from ALS sensor
+ *                 Function to get the filtered light level of the ALS sensor
  *
  * @return                        : Ambient light levels in lux.
  */
-uint32_t sensor_get_light_level(void)
+int32_t sensor_get_light_level(void)
 {
-    return max44009_read_ambient_light();
+    return sensor_als_filter.output;
+}
+
+
+/**
+ * Function        sensor_read_raw_light_level
+ *
+ *                 Read the ALS sensor once for the sensor stream, the light level filter is left alone.
+ *
+ * @return                        : Ambient light level in lux.
+ */
+int32_t sensor_read_raw_light_level(void)
+{
+    uint32_t lux;
+    MESH_PROBE_START(MESH_PROBE_ALS_READ);
+
+    lux = max44009_read_ambient_light();
+    MESH_PROBE_STOP(MESH_PROBE_ALS_READ);
+    return (int32_t)lux;
+}
+
+
+#if SENSOR_ALS_IRQ_MODE
+/**
+ * Function        sensor_als_write_reg
+ *
+ *                 Write a register of the ALS sensor
+ *
+ * @param[in] reg                 : Register address
+ * @param[in] value               : Register value
+ * @return                        : None.
+ */
+void sensor_als_write_reg(uint8_t reg, uint8_t value)
+{
+    uint8_t data[2] = { reg, value };
+
+    wiced_hal_i2c_write(data, sizeof(data), SENSOR_ALS_I2C_ADDRESS);
+}
+
+
+/**
+ * Function        sensor_als_read_reg
+ *
+ *                 Read a register of the ALS sensor
+ *
+ * @param[in] reg                 : Register address
+ * @return                        : Register value
+ */
+uint8_t sensor_als_read_reg(uint8_t reg)
+{
+    uint8_t value = 0;
+
+    wiced_hal_i2c_combined_read(&reg, sizeof(reg), &value, sizeof(value), SENSOR_ALS_I2C_ADDRESS);
+    return value;
+}
+
+
+/**
+ * Function        sensor_als_threshold_upper
+ *
+ *                 Encode the upper threshold, rounded down so that no light level above lux
+ *                 is missed.  The sensor fills the lower mantissa bits of the upper threshold with ones.
+ *                 A threshold below the published value would interrupt right away, so when lux is
+ *                 within one mantissa step of the value, the threshold is the smallest one at or
+ *                 above the value instead.
+ *
+ * @param[in] lux                 : Light level in lux
+ * @param[in] value               : Published light level in lux, not above lux
+ * @return                        : Threshold register value
+ */
+uint8_t sensor_als_threshold_upper(uint32_t lux, uint32_t value)
+{
+    uint32_t step, count, floor;
+    uint8_t exponent, mantissa;
+
+    for (exponent = 0; exponent <= SENSOR_ALS_MAX_EXPONENT; exponent++)
+    {
+        step = SENSOR_ALS_MILLILUX_PER_COUNT << exponent;
+        count = lux * 1000 / step;
+        if (count <= 0xFF)
+        {
+            // largest mantissa nibble with (nibble << 4 | 0x0F) not above count
+            mantissa = (uint8_t)((count >= 0x0F) ? ((count + 1) / 16 - 1) : 0);
+
+            // smallest mantissa nibble with (nibble << 4 | 0x0F) not below the value
+            floor = (value * 1000 + step - 1) / step;
+            if (((uint32_t)(mantissa << 4) | 0x0F) < floor)
+            {
+                mantissa = (floor / 16 > 0x0F) ? 0x0F : (uint8_t)(floor / 16);
+            }
+            return (uint8_t)((exponent << 4) | mantissa);
+        }
+    }
+    return 0xFF;
+}
+
+
+/**
+ * Function        sensor_als_threshold_lower
+ *
+ *                 Encode the lower threshold, rounded up so that no light level below lux
+ *                 is missed.  The sensor fills the lower mantissa bits of the lower threshold with zeros.
+ *                 A threshold above the published value would interrupt right away, so when lux is
+ *                 within one mantissa step of the value, the threshold is the largest one at or
+ *                 below the value instead.
+ *
+ * @param[in] lux                 : Light level in lux
+ * @param[in] value               : Published light level in lux, not below lux
+ * @return                        : Threshold register value
+ */
+uint8_t sensor_als_threshold_lower(uint32_t lux, uint32_t value)
+{
+    uint32_t step, count, ceiling;
+    uint8_t exponent, mantissa;
+
+    for (exponent = 0; exponent <= SENSOR_ALS_MAX_EXPONENT; exponent++)
+    {
+        step = SENSOR_ALS_MILLILUX_PER_COUNT << exponent;
+        count = (lux * 1000 + step - 1) / step;
+        if (count <= 0xF0)
+        {
+            mantissa = (uint8_t)((count + 0x0F) / 16);
+
+            // largest mantissa nibble with (nibble << 4) not above the value
+            ceiling = value * 1000 / step;
+            if ((uint32_t)(mantissa << 4) > ceiling)
+            {
+                mantissa = (uint8_t)(ceiling / 16);
+            }
+            return (uint8_t)((exponent << 4) | mantissa);
+        }
+    }
+    return 0xFF;
+}
+
+
+/**
+ * Function        sensor_als_irq_handler
+ *
+ *                 Interrupt of the ALS sensor, the light level is outside the threshold window
+ *
+ * @param[in] p_data              : User data, not used
+ * @param[in] pin                 : Interrupt pin
+ * @return                        : None.
+ */
+void sensor_als_irq_handler(void *p_data, uint8_t pin)
+{
+    // Reading the status releases the interrupt output
+    if ((0 != sensor_als_read_reg(SENSOR_ALS_REG_INT_STATUS)) && (NULL != sensor_als_irq_cback))
+    {
+        sensor_als_irq_cback();
+    }
+}
+
+
+/**
+ * Function        sensor_set_light_level_irq_callback
+ *
+ *                 Register the function called when the light level leaves the threshold window
+ *
+ * @param[in] p_cback             : Callback
+ * @return                        : None.
+ */
+void sensor_set_light_level_irq_callback(sensor_irq_cback_t p_cback)
+{
+    sensor_als_irq_cback = p_cback;
+}
+
+
+/**
+ * Function        sensor_set_light_level_window
+ *
+ *                 Program the threshold window of the ALS sensor.  The interrupt fires when the
+ *                 light level goes above high or below low.  Thresholds are rounded towards the
+ *                 window, so the interrupt may come early, but not past the published value: a
+ *                 window narrower than the threshold resolution is widened to the thresholds
+ *                 next to the value, and the interrupt may then come late.
+ *
+ * @param[in] enable              : WICED_FALSE disables the interrupt
+ * @param[in] value               : Published light level in lux
+ * @param[in] low                 : Lower bound of the window in lux, 0 or less for none
+ * @param[in] high                : Upper bound of the window in lux, INT32_MAX for none
+ * @return                        : None.
+ */
+void sensor_set_light_level_window(wiced_bool_t enable, int32_t value, int32_t low, int32_t high)
+{
+    uint32_t published;
+    uint8_t upper, lower;
+
+    if (!enable)
+    {
+        sensor_als_window_enabled = WICED_FALSE;
+        sensor_als_write_reg(SENSOR_ALS_REG_INT_ENABLE, 0);
+        return;
+    }
+
+    published = (value < 0) ? 0 : ((value > SENSOR_ALS_MAX_LUX) ? SENSOR_ALS_MAX_LUX : (uint32_t)value);
+    upper = (high >= SENSOR_ALS_MAX_LUX) ? 0xFF :
+            sensor_als_threshold_upper((high < (int32_t)published) ? published : (uint32_t)high, published);
+    lower = (low <= 0) ? 0x00 :
+            sensor_als_threshold_lower((low > (int32_t)published) ? published : (uint32_t)low, published);
+
+    // The engine reprograms the window after every cadence check, most of the time it did not move
+    if (sensor_als_window_enabled && (upper == sensor_als_upper) && (lower == sensor_als_lower))
+    {
+        return;
+    }
+    sensor_als_window_enabled = WICED_TRUE;
+    sensor_als_upper = upper;
+    sensor_als_lower = lower;
+
+    sensor_als_write_reg(SENSOR_ALS_REG_INT_ENABLE, 0);
+    sensor_als_write_reg(SENSOR_ALS_REG_THRESHOLD_UPPER, upper);
+    sensor_als_write_reg(SENSOR_ALS_REG_THRESHOLD_LOWER, lower);
+
+    // Clear an interrupt raised against the previous window before enabling
+    sensor_als_read_reg(SENSOR_ALS_REG_INT_STATUS);
+    sensor_als_write_reg(SENSOR_ALS_REG_INT_ENABLE, 1);
 }
+#endif
 
 
 /*END of FILE */
@@ -42,12 +42,109 @@
 #ifndef SENSORS_H_
 #define SENSORS_H_
 
+#include "wiced.h"
+#include "sensor_filter.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+/* Filter between the ambient light sensor and the cadence engine. Flicker and
+ * passing shadows show up as single-sample outliers, which a median rejects. */
+#ifndef SENSOR_ALS_FILTER
+#define SENSOR_ALS_FILTER                       SENSOR_FILTER_MEDIAN
+#endif
+#ifndef SENSOR_ALS_FILTER_TAPS
+#define SENSOR_ALS_FILTER_TAPS                  5
+#endif
+#ifndef SENSOR_ALS_FILTER_EMA_SHIFT
+#define SENSOR_ALS_FILTER_EMA_SHIFT             2
+#endif
+// Interval of the extra samples taken between cadence reads, 0 to disable
+#ifndef SENSOR_ALS_SAMPLE_INTERVAL_MS
+#define SENSOR_ALS_SAMPLE_INTERVAL_MS           1000
+#endif
+
+/* Filter between the thermistor and the cadence engine. ADC noise is spread
+ * evenly, so the thermistor is averaged in hundredths of a degree before it
+ * is rounded to the Temperature 8 resolution. */
+#ifndef SENSOR_TEMP_FILTER
+#define SENSOR_TEMP_FILTER                      SENSOR_FILTER_MOVING_AVERAGE
+#endif
+#ifndef SENSOR_TEMP_FILTER_TAPS
+#define SENSOR_TEMP_FILTER_TAPS                 4
+#endif
+#ifndef SENSOR_TEMP_FILTER_EMA_SHIFT
+#define SENSOR_TEMP_FILTER_EMA_SHIFT            2
+#endif
+#ifndef SENSOR_TEMP_SAMPLE_INTERVAL_MS
+#define SENSOR_TEMP_SAMPLE_INTERVAL_MS          1000
+#endif
+
+/* When set, the MAX44009 interrupt output wakes the cadence engine when the
+ * light level leaves the trigger delta window, instead of the engine polling
+ * the sensor at the cadence minimum interval. SENSOR_ALS_IRQ_PIN has to be
+ * set to the GPIO wired to the INT output of the sensor. */
+#ifndef SENSOR_ALS_IRQ_MODE
+#define SENSOR_ALS_IRQ_MODE                     0
+#endif
+#if SENSOR_ALS_IRQ_MODE && !defined(SENSOR_ALS_IRQ_PIN)
+#error "SENSOR_ALS_IRQ_MODE needs SENSOR_ALS_IRQ_PIN set to the GPIO wired to the MAX44009 INT output"
+#endif
+// Time the light level has to stay outside the window before the interrupt, in 100 msec
+#ifndef SENSOR_ALS_IRQ_TIMER
+#define SENSOR_ALS_IRQ_TIMER                    0
+#endif
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef void (*sensor_irq_cback_t)(void);
+
+// Initialize the sensor hardware and the filter of its readings
+typedef void (*sensor_driver_init_t)(void);
+
+// Read the sensor and add the reading to the filter of the sensor
+typedef void (*sensor_driver_read_t)(void);
+
+// Filtered value in the units and encoding of the sensor property
+typedef int32_t (*sensor_driver_value_t)(void);
+
+// Read the sensor once and return the reading in the units and encoding of the sensor property, the filter is left alone
+typedef int32_t (*sensor_driver_read_raw_t)(void);
+
+// Program the window around the published value outside which the sensor raises an interrupt
+typedef void (*sensor_driver_window_t)(wiced_bool_t enable, int32_t value, int32_t low, int32_t high);
+
+/*
+ * Driver of one sensor served by the hub.  The cadence engine drives every sensor
+ * through these callbacks, so a new sensor is a new driver and a new entry in the
+ * sensor table of mesh_server.c.  A read is one short transfer on the stack
+ * thread: the MAX44009 converts continuously and the thermistor library samples
+ * the ADC in one call.
+ */
+typedef struct
+{
+    uint16_t                    property_id;        // Sensor property served with the values
+    wiced_bool_t                is_signed;          // Property value is a signed integer
+    uint32_t                    sample_interval;    // Interval of the filter samples in msec, 0 to disable
+    sensor_driver_init_t        init;
+    sensor_driver_read_t        read;
+    sensor_driver_value_t       value;
+    sensor_driver_read_raw_t    read_raw;           // Unfiltered reading for the sensor stream
+    sensor_driver_window_t      set_window;         // Interrupt on trigger crossings, NULL if the triggers are polled
+} sensor_driver_t;
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+extern const sensor_driver_t sensor_als_driver;
+extern const sensor_driver_t sensor_thermistor_driver;
+
 /******************************************************************************
  *                          Function Prototypes
  ******************************************************************************/
-int8_t sensor_get_temperature(void);
-uint32_t sensor_get_light_level(void);
-void sensor_init_thermistor(void);
-void sensor_init_als(void);
+#if SENSOR_ALS_IRQ_MODE
+void sensor_set_light_level_irq_callback(sensor_irq_cback_t p_cback);
+#endif
 
 #endif /* SENSORS_H_ */
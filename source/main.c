@@ -45,9 +45,16 @@
 #include "wiced_hal_pwm.h"
 #include "wiced_hal_aclk.h"
 #include "wiced_bt_trace.h"
+#include "wiced_bt_dev.h"
 #include "wiced_bt_mesh_core.h"
 #include "wiced_bt_mesh_models.h"
 #include "mesh_server.h"
+#include "mesh_sched.h"
+#include "mesh_probe.h"
+#include "mesh_capacity.h"
+#include "mesh_lpn.h"
+#include "mesh_log.h"
+#include "mesh_store.h"
 #include "sensors.h"
 #include "GeneratedSource/cycfg_pins.h"
 
@@ -90,8 +97,10 @@ wiced_pwm_config_t pwm_config;
  */
 void mesh_app_init(wiced_bool_t is_provisioned)
 {
+    uint32_t boot_time = wiced_bt_mesh_core_get_tick_count();
+    wiced_bt_device_address_t bd_addr;
 
-    WICED_BT_TRACE("\n***** Mesh SensorHub *****\n");
+    MESH_LOG_INFO(MESH_LOG_APP_START);
 
     if (!is_provisioned)
     {
@@ -108,19 +117,35 @@ void mesh_app_init(wiced_bool_t is_provisioned)
     if (!is_provisioned)
         return;
 
-    /* Initialization of sensor */
-    sensor_init_als();
-    sensor_init_thermistor();
+#if MESH_PROBE_ENABLE
+    /* Start the cycle counter of the pipeline probes */
+    mesh_probe_init();
+#endif
 
-    /* Initialization of timers */
-    mesh_sensor_cadence_init_als_timer();
-    mesh_sensor_cadence_init_temp_timer();
+    /* Report the Friend and replay protection sizes and start counting their overflows */
+    mesh_capacity_init();
+
+#if LOW_POWER_NODE
+    /* Sleep between the polls of the friend and the sensor deadlines */
+    mesh_lpn_init();
+#endif
+
+    /* Initialization of the sensor scheduler and cadence timers */
+    mesh_sched_init();
+    mesh_sensor_cadence_init_timers();
+
+    /* Hubs powered up together would publish in lockstep, their device addresses set them apart */
+    wiced_bt_dev_read_local_addr(bd_addr);
+    mesh_sched_set_jitter(bd_addr, sizeof(wiced_bt_device_address_t), MESH_SCHED_JITTER_MS);
+
+    /* Restore the cadence of all sensors from NVRAM in one read */
+    mesh_store_load();
 
     /* Initialization of mesh model */
     mesh_sensor_server_init_model(is_provisioned);
 
-    /* Initial reading of sensors */
-    mesh_sensor_init_value();
+    /* Initialization of the sensor hardware and initial reading of sensors, after the models are up */
+    mesh_sensor_start_deferred(boot_time);
 
 }
 
@@ -0,0 +1,210 @@
+/******************************************************************************
+* File Name:   mesh_capacity.c
+*
+* Description: This file shows the implementation of the Friend and replay
+*              protection capacity statistics. The configured Friend and
+*              replay protection sizes are read out over WICED HCI. The WICED
+*              mesh core does not count the Friend cache occupancy, the
+*              messages dropped from full Friend Queues, the refused Friend
+*              Requests or the replay protection evictions, so these counters
+*              are checked on every history bin only in the host simulation
+*              which models them (MESH_CAPACITY_SIM_COUNTERS).
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "wiced_bt_mesh_core.h"
+#include "wiced_bt_mesh_app.h"
+#include "wiced_transport.h"
+#include "mesh_cfg.h"
+#include "mesh_log.h"
+#include "mesh_capacity.h"
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+#if MESH_CAPACITY_SIM_COUNTERS
+static void mesh_capacity_mark(const sim_core_capacity_t *p_capacity);
+#endif
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+#if MESH_CAPACITY_SIM_COUNTERS
+// Counters at the last check, the next check reports what was added since
+static uint32_t mesh_capacity_cache_drops = 0;
+static uint32_t mesh_capacity_friend_rejects = 0;
+static uint32_t mesh_capacity_replay_evictions = 0;
+#endif
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_capacity_init
+ *
+ *                  Report the Friend and replay protection sizes and start counting
+ *
+ * @return                      : None
+ */
+void mesh_capacity_init(void)
+{
+#if MESH_CAPACITY_SIM_COUNTERS
+    sim_core_capacity_t capacity;
+#endif
+
+    MESH_LOG_INFO(MESH_LOG_CAPACITY_CONFIG, mesh_config.friend_cfg.max_lpn_num, mesh_config.friend_cfg.cache_buf_len,
+                  MESH_CACHE_REPLAY_SIZE, MESH_CORE_RAM_BUDGET);
+#if MESH_CAPACITY_SIM_COUNTERS
+    sim_core_capacity_get(&capacity);
+    mesh_capacity_mark(&capacity);
+#endif
+}
+
+
+#if MESH_CAPACITY_SIM_COUNTERS
+/**
+ * Function         mesh_capacity_mark
+ *
+ *                  Remember the counters so that the next check reports from here
+ *
+ * @param[in] p_capacity        : Counters of the simulated core
+ * @return                      : None
+ */
+void mesh_capacity_mark(const sim_core_capacity_t *p_capacity)
+{
+    mesh_capacity_cache_drops = p_capacity->friend_cache_drops;
+    mesh_capacity_friend_rejects = p_capacity->friend_rejects;
+    mesh_capacity_replay_evictions = p_capacity->replay_evictions;
+}
+
+
+/**
+ * Function         mesh_capacity_check
+ *
+ *                  Warn when the Friend cache, the friendships or the replay protection
+ *                  ran out of room since the last check.  Only built with the counters,
+ *                  see MESH_CAPACITY_SIM_COUNTERS.
+ *
+ * @return                      : None
+ */
+void mesh_capacity_check(void)
+{
+    sim_core_capacity_t capacity;
+
+    sim_core_capacity_get(&capacity);
+    if ((capacity.friend_cache_drops != mesh_capacity_cache_drops) ||
+        (capacity.friend_rejects != mesh_capacity_friend_rejects) ||
+        (capacity.replay_evictions != mesh_capacity_replay_evictions))
+    {
+        MESH_LOG_WARN(MESH_LOG_CAPACITY_EXCEEDED, capacity.friend_cache_drops - mesh_capacity_cache_drops,
+                      capacity.friend_rejects - mesh_capacity_friend_rejects,
+                      capacity.replay_evictions - mesh_capacity_replay_evictions);
+    }
+    mesh_capacity_mark(&capacity);
+}
+#endif
+
+
+/**
+ * Function         mesh_capacity_hci_command
+ *
+ *                  Process the capacity commands received over WICED HCI.  The statistics are
+ *                  returned in one event of MESH_CAPACITY_FIELD_COUNT little endian 32-bit values.
+ *                  The counter fields are MESH_CAPACITY_FIELD_UNKNOWN unless the counters are
+ *                  available, see MESH_CAPACITY_SIM_COUNTERS.  Without the counters the reset
+ *                  command is not processed and is left to the library as an unknown command.
+ *
+ * @param[in] opcode            : WICED HCI opcode
+ * @param[in] p_data            : Command parameters, not used
+ * @param[in] length            : Length of the parameters
+ * @return                      : WICED_TRUE if the command was processed
+ */
+uint32_t mesh_capacity_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+#if MESH_CAPACITY_SIM_COUNTERS
+    sim_core_capacity_t capacity;
+#endif
+    uint8_t buffer[MESH_CAPACITY_HCI_STATS_LEN];
+    uint32_t field[MESH_CAPACITY_FIELD_COUNT];
+    uint8_t i, k;
+
+    switch (opcode)
+    {
+    case HCI_CONTROL_SENSOR_HUB_COMMAND_CAPACITY_GET:
+        for (i = 0; i < MESH_CAPACITY_FIELD_COUNT; i++)
+        {
+            field[i] = MESH_CAPACITY_FIELD_UNKNOWN;
+        }
+        field[MESH_CAPACITY_FIELD_LPN_MAX]          = mesh_config.friend_cfg.max_lpn_num;
+        field[MESH_CAPACITY_FIELD_CACHE_LEN]        = mesh_config.friend_cfg.cache_buf_len;
+        field[MESH_CAPACITY_FIELD_REPLAY_SIZE]      = MESH_CACHE_REPLAY_SIZE;
+#if MESH_CAPACITY_SIM_COUNTERS
+        sim_core_capacity_get(&capacity);
+        field[MESH_CAPACITY_FIELD_LPN_COUNT]        = capacity.friend_lpn_count;
+        field[MESH_CAPACITY_FIELD_CACHE_USED]       = capacity.friend_cache_used;
+        field[MESH_CAPACITY_FIELD_CACHE_PEAK]       = capacity.friend_cache_peak;
+        field[MESH_CAPACITY_FIELD_CACHE_DROPS]      = capacity.friend_cache_drops;
+        field[MESH_CAPACITY_FIELD_FRIEND_REJECTS]   = capacity.friend_rejects;
+        field[MESH_CAPACITY_FIELD_REPLAY_EVICTIONS] = capacity.replay_evictions;
+#endif
+
+        for (i = 0; i < MESH_CAPACITY_FIELD_COUNT; i++)
+        {
+            for (k = 0; k < 4; k++)
+            {
+                buffer[4 * i + k] = (uint8_t)(field[i] >> (8 * k));
+            }
+        }
+        wiced_transport_send_data(HCI_CONTROL_SENSOR_HUB_EVENT_CAPACITY_STATS, buffer, (uint16_t)sizeof(buffer));
+        return WICED_TRUE;
+
+#if MESH_CAPACITY_SIM_COUNTERS
+    case HCI_CONTROL_SENSOR_HUB_COMMAND_CAPACITY_RESET:
+        sim_core_capacity_reset();
+        sim_core_capacity_get(&capacity);
+        mesh_capacity_mark(&capacity);
+        return WICED_TRUE;
+#endif
+
+    default:
+        return WICED_FALSE;
+    }
+}
+
+
+/*END of FILE */
@@ -0,0 +1,95 @@
+/******************************************************************************
+* File Name:   mesh_capacity.h
+*
+* Description: This file shows the structures and function prototypes of the
+*              Friend and replay protection capacity statistics.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_CAPACITY_H_
+#define MESH_CAPACITY_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "mesh_hci.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// The WICED mesh core does not count the Friend cache use, the Friend Queue drops, the refused
+// Friend Requests or the replay protection evictions.  Only the host simulation, which models
+// the Friend Queues and the replay list, provides them (sim_core_capacity_get) and builds with
+// MESH_CAPACITY_SIM_COUNTERS.  On a device the counter fields read MESH_CAPACITY_FIELD_UNKNOWN,
+// and the per-bin check and the reset command are not built.
+#ifndef MESH_CAPACITY_SIM_COUNTERS
+#define MESH_CAPACITY_SIM_COUNTERS              0
+#endif
+
+// Value of a counter field which is not available
+#define MESH_CAPACITY_FIELD_UNKNOWN             0xFFFFFFFF
+
+// Bytes of the HCI event, one little endian 32-bit value per field
+#define MESH_CAPACITY_HCI_STATS_LEN             (4 * MESH_CAPACITY_FIELD_COUNT)
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// Fields of the HCI event
+typedef enum
+{
+    MESH_CAPACITY_FIELD_LPN_COUNT,          // Low Power Nodes with an established friendship
+    MESH_CAPACITY_FIELD_LPN_MAX,            // MESH_FRIEND_MAX_LPN, 0 on a Low Power Node
+    MESH_CAPACITY_FIELD_CACHE_USED,         // Bytes of the Friend cache in use
+    MESH_CAPACITY_FIELD_CACHE_PEAK,         // Most bytes of the Friend cache in use
+    MESH_CAPACITY_FIELD_CACHE_LEN,          // MESH_FRIEND_CACHE_BUF_LEN, 0 on a Low Power Node
+    MESH_CAPACITY_FIELD_CACHE_DROPS,        // Messages discarded from a full Friend Queue
+    MESH_CAPACITY_FIELD_FRIEND_REJECTS,     // Friend Requests refused with every friendship in use
+    MESH_CAPACITY_FIELD_REPLAY_EVICTIONS,   // Replay protection entries taken over by another source
+    MESH_CAPACITY_FIELD_REPLAY_SIZE,        // MESH_CACHE_REPLAY_SIZE
+    MESH_CAPACITY_FIELD_COUNT
+} mesh_capacity_field_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_capacity_init(void);
+#if MESH_CAPACITY_SIM_COUNTERS
+void mesh_capacity_check(void);
+#endif
+uint32_t mesh_capacity_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length);
+
+#endif /* MESH_CAPACITY_H_ */
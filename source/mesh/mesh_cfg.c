@@ -46,168 +46,157 @@
 #include "wiced_bt_mesh_app.h"
 #include "wiced_bt_cfg.h"
 #include "mesh_cfg.h"
+#include "mesh_manifest.h"
+#include "mesh_history.h"
+#include "mesh_stream.h"
 
 
 /*************************************************************************************
 * Variables Definitions
 *************************************************************************************/
-/* variable to hold the sensor current value */
-extern uint32_t mesh_sensor_sent_lux_value;
-extern int8_t mesh_sensor_sent_temp_value;
-
-uint8_t mesh_mfr_name[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MANUFACTURER_NAME] = { 'I', 'n', 'f', 'i', 'n', 'e', 'o', 'n', 0 };
-uint8_t mesh_model_num[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MODEL_NUMBER]     = { '1', '2', '3', '4', 0, 0, 0, 0 };
-uint8_t mesh_system_id[8]                                                  = { 0xbb, 0xb8, 0xa1, 0x80, 0x5f, 0x9f, 0x91, 0x71 };
-
-// Optional setting for the sensors, the Total Device Runtime, in Time Hour 24 format
-uint8_t mesh_sensor_als_setting_val[] = { 0x01, 0x00, 0x00 }; /*HH, MM, SS */
-uint8_t mesh_sensor_temp_setting_val[] = { 0x01, 0x00, 0x00 };
-
-wiced_bt_mesh_sensor_config_setting_t mesh_sensor_als_settings[] =
-{
-    {
-        .setting_property_id = WICED_BT_MESH_PROPERTY_TOTAL_DEVICE_RUNTIME,
-        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
-        .value_len           = WICED_BT_MESH_PROPERTY_LEN_TOTAL_DEVICE_RUNTIME,
-        .val                 = mesh_sensor_als_setting_val
-    },
-};
-
-wiced_bt_mesh_sensor_config_setting_t mesh_sensor_temp_settings[] =
-{
-    {
-        .setting_property_id = WICED_BT_MESH_PROPERTY_TOTAL_DEVICE_RUNTIME,
-        .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,
-        .value_len           = WICED_BT_MESH_PROPERTY_LEN_TOTAL_DEVICE_RUNTIME,
-        .val                 = mesh_sensor_temp_setting_val
-    },
-};
-
-wiced_bt_mesh_core_config_model_t mesh_element1_models[] =
+/*
+ * The tables the mesh library only reads are const so that they stay in flash: the device
+ * strings, the models, the setting descriptions and the elements, as no model of the node
+ * changes the element defaults. The library configuration types are not const-qualified,
+ * hence the casts where mesh_config points to them. The sensor configurations stay in RAM,
+ * the library writes their cadence, values and series.
+ */
+const uint8_t mesh_mfr_name[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MANUFACTURER_NAME] = { 'I', 'n', 'f', 'i', 'n', 'e', 'o', 'n', 0 };
+const uint8_t mesh_model_num[WICED_BT_MESH_PROPERTY_LEN_DEVICE_MODEL_NUMBER]     = { '1', '2', '3', '4', 0, 0, 0, 0 };
+const uint8_t mesh_system_id[8]                                                  = { 0xbb, 0xb8, 0xa1, 0x80, 0x5f, 0x9f, 0x91, 0x71 };
+
+/*
+ * Buffers of each sensor in mesh_manifest.h: the value published by the mesh models library,
+ * the history served as Sensor Series columns, whose number grows as the history fills, and
+ * the optional setting of the sensor, the Total Device Runtime in Time Hour 24 format.
+ */
+#define MESH_CFG_SENSOR_DATA(arg, name, element_idx, driver, max_age)                           \
+    uint8_t mesh_sensor_data_##name[MESH_##name##_SENSOR_PROPERTY_LEN];                         \
+    wiced_bt_mesh_sensor_config_column_data_t mesh_sensor_columns_##name[MESH_SENSOR_HISTORY_BINS]; \
+    uint8_t mesh_sensor_setting_val_##name[] = { 0x01, 0x00, 0x00 }; /* HH, MM, SS */          \
+    const wiced_bt_mesh_sensor_config_setting_t mesh_sensor_settings_##name[] =                 \
+    {                                                                                           \
+        {                                                                                       \
+            .setting_property_id = WICED_BT_MESH_PROPERTY_TOTAL_DEVICE_RUNTIME,                 \
+            .access              = WICED_BT_MESH_SENSOR_SETTING_READABLE_AND_WRITABLE,          \
+            .value_len           = WICED_BT_MESH_PROPERTY_LEN_TOTAL_DEVICE_RUNTIME,             \
+            .val                 = mesh_sensor_setting_val_##name                               \
+        },                                                                                      \
+    };
+MESH_MANIFEST_SENSORS(MESH_CFG_SENSOR_DATA, 0)
+
+const wiced_bt_mesh_core_config_model_t mesh_element1_models[] =
 {
     WICED_BT_MESH_DEVICE,
     WICED_BT_MESH_MODEL_SENSOR_SERVER,
+#if MESH_SENSOR_STREAM
+    MESH_MODEL_STREAM_SERVER,
+#endif
 };
 
-wiced_bt_mesh_core_config_model_t mesh_element2_models[] =
+#if !MESH_SENSOR_BATCH_PUBLISH
+const wiced_bt_mesh_core_config_model_t mesh_element2_models[] =
 {
     WICED_BT_MESH_MODEL_SENSOR_SERVER,
 };
-
-wiced_bt_mesh_core_config_sensor_t mesh_element1_sensors[] =
-{
-    {
-        .property_id = WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL,
-        .prop_value_len = WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_LIGHT_LEVEL,
-        .descriptor =
-        {
-            .positive_tolerance = MESH_ALS_SENSOR_POSITIVE_TOLERANCE,
-            .negative_tolerance = MESH_ALS_SENSOR_NEGATIVE_TOLERANCE,
-            .sampling_function  = MESH_ALS_SENSOR_SAMPLING_FUNCTION,
-            .measurement_period = MESH_ALS_SENSOR_MEASUREMENT_PERIOD,
-            .update_interval    = MESH_ALS_SENSOR_UPDATE_INTERVAL,
-        },
-        .data = (uint8_t *)&mesh_sensor_sent_lux_value,
-        .cadence =
-        {
-            // Value 1 indicates that cadence does not change depending on the measurements
-            .fast_cadence_period_divisor = 1,            // Value of the divisor
-            .trigger_type_percentage     = WICED_FALSE,
-            .trigger_delta_down          = 0,
-            .trigger_delta_up            = 0,
-            .min_interval                = (1 << 0x0C),  // ~4 seconds
-            .fast_cadence_low            = 0,
-            .fast_cadence_high           = 0,
-        },
-        .num_series     = 0,
-        .series_columns = NULL,
-        .num_settings   = 1,
-        .settings       = mesh_sensor_als_settings,
+#endif
+
+// Sensors of the hub, grouped by element
+#define MESH_CFG_SENSOR(arg, name, element_idx, driver, max_age)                                \
+    {                                                                                           \
+        .property_id    = MESH_##name##_SENSOR_PROPERTY,                                        \
+        .prop_value_len = MESH_##name##_SENSOR_PROPERTY_LEN,                                    \
+        .descriptor =                                                                           \
+        {                                                                                       \
+            .positive_tolerance = MESH_##name##_SENSOR_POSITIVE_TOLERANCE,                      \
+            .negative_tolerance = MESH_##name##_SENSOR_NEGATIVE_TOLERANCE,                      \
+            .sampling_function  = MESH_##name##_SENSOR_SAMPLING_FUNCTION,                       \
+            .measurement_period = MESH_##name##_SENSOR_MEASUREMENT_PERIOD,                      \
+            .update_interval    = MESH_##name##_SENSOR_UPDATE_INTERVAL,                         \
+        },                                                                                      \
+        .data = mesh_sensor_data_##name,                                                        \
+        .cadence =                                                                              \
+        {                                                                                       \
+            /* Value 1 indicates that cadence does not change depending on the measurements */ \
+            .fast_cadence_period_divisor = 1,                                                   \
+            .trigger_type_percentage     = WICED_FALSE,                                         \
+            .trigger_delta_down          = 0,                                                   \
+            .trigger_delta_up            = 0,                                                   \
+            .min_interval                = MESH_SENSOR_MIN_INTERVAL_MS,                         \
+            .fast_cadence_low            = 0,                                                   \
+            .fast_cadence_high           = 0,                                                   \
+        },                                                                                      \
+        .num_series     = 0,                                                                    \
+        .series_columns = mesh_sensor_columns_##name,                                           \
+        .num_settings   = 1,                                                                    \
+        .settings       = (wiced_bt_mesh_sensor_config_setting_t *)mesh_sensor_settings_##name, \
     },
-};
-
-
-wiced_bt_mesh_core_config_sensor_t mesh_element2_sensors[] =
+wiced_bt_mesh_core_config_sensor_t mesh_element_sensors[] =
 {
-
-    {
-        .property_id = WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE,
-        .prop_value_len = WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_TEMPERATURE,
-        .descriptor =
-        {
-            .positive_tolerance = MESH_TEMP_SENSOR_POSITIVE_TOLERANCE,
-            .negative_tolerance = MESH_TEMP_SENSOR_NEGATIVE_TOLERANCE,
-            .sampling_function  = MESH_TEMP_SENSOR_SAMPLING_FUNCTION,
-            .measurement_period = MESH_TEMP_SENSOR_MEASUREMENT_PERIOD,
-            .update_interval    = MESH_TEMP_SENSOR_UPDATE_INTERVAL,
-        },
-        .data = (uint8_t *)&mesh_sensor_sent_temp_value,
-        .cadence =
-        {
-            // Value 1 indicates that cadence does not change depending on the measurements
-            .fast_cadence_period_divisor = 1,            // Value of the divisor
-            .trigger_type_percentage     = WICED_FALSE,
-            .trigger_delta_down          = 0,
-            .trigger_delta_up            = 0,
-            .min_interval                = (1 << 0x0C),  // ~4 seconds
-            .fast_cadence_low            = 0,
-            .fast_cadence_high           = 0,
-        },
-        .num_series     = 0,
-        .series_columns = NULL,
-        .num_settings   = 1,
-        .settings       = mesh_sensor_temp_settings,
-    },
-
+    MESH_MANIFEST_SENSORS(MESH_CFG_SENSOR, 0)
 };
 
-
-wiced_bt_mesh_core_config_element_t mesh_elements[] =
-{
-    {
-        .location = MESH_ELEM_LOC_MAIN,                                  // location description as defined in the GATT Bluetooth Namespace Descriptors section of the Bluetooth SIG Assigned Numbers
-        .default_transition_time = MESH_DEFAULT_TRANSITION_TIME_IN_MS,   // Default transition time for models of the element in milliseconds
-        .onpowerup_state = WICED_BT_MESH_ON_POWER_UP_STATE_RESTORE,      // Default element behavior on power up
-        .default_level = 0,                                              // Default value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .range_min = 1,                                                  // Minimum value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .range_max = 0xffff,                                             // Maximum value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .move_rollover = 0,                                              // If true when level gets to range_max during move operation, it switches to min, otherwise move stops.
-        .properties_num = 0,                                             // Number of properties in the array models
-        .properties = NULL,                                              // Array of properties in the element.
-        .sensors_num = 1,                                                // Number of properties in the array models
-        .sensors = mesh_element1_sensors,                                // Array of properties in the element.
-        .models_num = sizeof(mesh_element1_models) / sizeof(wiced_bt_mesh_core_config_model_t),                               // Number of models in the array models
-        .models = mesh_element1_models,                                  // Array of models located in that element. Model data is defined by structure wiced_bt_mesh_core_config_model_t
-    },
-    {
-        .location = MESH_ELEM_LOC_MAIN,                                  // location description as defined in the GATT Bluetooth Namespace Descriptors section of the Bluetooth SIG Assigned Numbers
-        .default_transition_time = MESH_DEFAULT_TRANSITION_TIME_IN_MS,   // Default transition time for models of the element in milliseconds
-        .onpowerup_state = WICED_BT_MESH_ON_POWER_UP_STATE_RESTORE,      // Default element behavior on power up
-        .default_level = 0,                                              // Default value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .range_min = 1,                                                  // Minimum value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .range_max = 0xffff,                                             // Maximum value of the variable controlled on this element (for example power, lightness, temperature, hue...)
-        .move_rollover = 0,                                              // If true when level gets to range_max during move operation, it switches to min, otherwise move stops.
-        .properties_num = 0,                                             // Number of properties in the array models
-        .properties = NULL,                                              // Array of properties in the element.
-        .sensors_num = 1,                                                // Number of properties in the array models
-        .sensors = mesh_element2_sensors,                                // Array of properties in the element.
-        .models_num = sizeof(mesh_element2_models) / sizeof(wiced_bt_mesh_core_config_model_t),                               // Number of models in the array models
-        .models = mesh_element2_models,                                  // Array of models located in that element. Model data is defined by structure wiced_bt_mesh_core_config_model_t
+// Elements of the node, each serving its group of mesh_element_sensors
+#define MESH_CFG_ELEMENT(arg, element_idx, element_models)                                      \
+    {                                                                                           \
+        .location = MESH_ELEM_LOC_MAIN,                                 /* location description as defined in the GATT Bluetooth Namespace Descriptors section of the Bluetooth SIG Assigned Numbers */ \
+        .default_transition_time = MESH_DEFAULT_TRANSITION_TIME_IN_MS,  /* Default transition time for models of the element in milliseconds */ \
+        .onpowerup_state = WICED_BT_MESH_ON_POWER_UP_STATE_RESTORE,     /* Default element behavior on power up */ \
+        .default_level = 0,                                             /* Default value of the variable controlled on this element (for example power, lightness, temperature, hue...) */ \
+        .range_min = 1,                                                 /* Minimum value of the variable controlled on this element (for example power, lightness, temperature, hue...) */ \
+        .range_max = 0xffff,                                            /* Maximum value of the variable controlled on this element (for example power, lightness, temperature, hue...) */ \
+        .move_rollover = 0,                                             /* If true when level gets to range_max during move operation, it switches to min, otherwise move stops. */ \
+        .properties_num = 0,                                            /* Number of properties in the array models */ \
+        .properties = NULL,                                             /* Array of properties in the element. */ \
+        .sensors_num = MESH_MANIFEST_ELEMENT_SENSORS(element_idx),      /* Number of sensors in the array sensors */ \
+        .sensors = &mesh_element_sensors[MESH_MANIFEST_ELEMENT_FIRST(element_idx)], /* Array of sensors in the element. */ \
+        .models_num = sizeof(element_models) / sizeof(wiced_bt_mesh_core_config_model_t), /* Number of models in the array models */ \
+        .models = (wiced_bt_mesh_core_config_model_t *)element_models, /* Array of models located in that element. Model data is defined by structure wiced_bt_mesh_core_config_model_t */ \
     },
+const wiced_bt_mesh_core_config_element_t mesh_elements[] =
+{
+    MESH_MANIFEST_ELEMENTS(MESH_CFG_ELEMENT, 0)
 };
 
+#if LOW_POWER_NODE
+// Fails to compile when the poll timeout is out of the range of the Friend Request, 1 second to 96 hours
+typedef char mesh_cfg_lpn_poll_timeout_check[((MESH_LPN_POLL_TIMEOUT >= 0x0A) && (MESH_LPN_POLL_TIMEOUT <= 0x34BBFF)) ? 1 : -1];
+#else
+// Fails to compile when the core RAM budget leaves no room for the Friend cache of every friendship
+typedef char mesh_cfg_core_ram_budget_check[((MESH_FRIEND_MAX_LPN > 0) &&
+    (MESH_FRIEND_CACHE_BUF_LEN >= MESH_FRIEND_MAX_LPN * MESH_FRIEND_MIN_CACHE_MSGS * MESH_FRIEND_CACHE_MSG_SIZE) &&
+    (MESH_FRIEND_CACHE_BUF_LEN <= 0xFFFF)) ? 1 : -1];
+#endif
+
 wiced_bt_mesh_core_config_t  mesh_config =
 {
     .company_id         = MESH_COMPANY_ID,                  // Company identifier assigned by the Bluetooth SIG
     .product_id         = MESH_PID,                                 // Vendor-assigned product identifier
     .vendor_id          = MESH_VID,                                 // Vendor-assigned product version identifier
     .replay_cache_size  = MESH_CACHE_REPLAY_SIZE,                   // Number of replay protection entries, i.e. maximum number of mesh devices that can send application messages to this device.
+#if LOW_POWER_NODE
+    .features           = WICED_BT_MESH_CORE_FEATURE_BIT_LOW_POWER, // A Low Power Node neither relays nor proxies, and is nobody's friend
+    .friend_cfg         =                                           // Configuration of the Friend Feature(Receive Window in Ms, messages cache)
+    {
+        .receive_window        = 0,
+        .cache_buf_len         = 0,
+        .max_lpn_num           = 0
+    },
+    .low_power          =                                           // Configuration of the Low Power Feature
+    {
+        .rssi_factor           = 2,                                 // contribution of the RSSI measured by the Friend node used in Friend Offer Delay calculations.
+        .receive_window_factor = 2,                                 // contribution of the supported Receive Window used in Friend Offer Delay calculations.
+        .min_cache_size_log    = 3,                                 // minimum number of messages that the Friend node can store in its Friend Cache.
+        .receive_delay         = 100,                               // Receive delay in 1 ms units to be requested by the Low Power node.
+        .poll_timeout          = MESH_LPN_POLL_TIMEOUT              // Poll timeout in 100ms units to be requested by the Low Power node.
+    },
+#else
     .features           = WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND | WICED_BT_MESH_CORE_FEATURE_BIT_RELAY | WICED_BT_MESH_CORE_FEATURE_BIT_GATT_PROXY_SERVER,   // In Friend mode support friend, relay
     .friend_cfg         =                                           // Configuration of the Friend Feature(Receive Window in Ms, messages cache)
     {
         .receive_window        = 20,
-        .cache_buf_len         = 300,                               // Length of the buffer for the cache
-        .max_lpn_num           = 4                                  // Max number of Low Power Nodes with established friendship. Must be > 0 if Friend feature is supported.
+        .cache_buf_len         = MESH_FRIEND_CACHE_BUF_LEN,         // Length of the buffer for the cache
+        .max_lpn_num           = MESH_FRIEND_MAX_LPN                // Max number of Low Power Nodes with established friendship. Must be > 0 if Friend feature is supported.
     },
     .low_power          =                                           // Configuration of the Low Power Feature
     {
@@ -217,9 +206,10 @@ wiced_bt_mesh_core_config_t  mesh_config =
         .receive_delay         = 0,                                 // Receive delay in 1 ms units to be requested by the Low Power node.
         .poll_timeout          = 0                                  // Poll timeout in 100ms units to be requested by the Low Power node.
     },
+#endif
     .gatt_client_only          = WICED_FALSE,                       // Can connect to mesh over GATT or ADV
     .elements_num  = (uint8_t)(sizeof(mesh_elements) / sizeof(mesh_elements[0])),   // number of elements on this device
-    .elements      = mesh_elements                                  // Array of elements for this device
+    .elements      = (wiced_bt_mesh_core_config_element_t *)mesh_elements   // Array of elements for this device
 };
 
 
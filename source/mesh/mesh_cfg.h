@@ -49,14 +49,40 @@
  ******************************************************************************/
 #define MESH_PID                                0x3122
 #define MESH_VID                                0x0002
-#define MESH_CACHE_REPLAY_SIZE                  0x0008
 #define MESH_COMPANY_ID                         0x0009
 
-#define MESH_ALS_SENSOR_PROPERTY_ID             WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL
-#define MESH_ALS_SENSOR_VALUE_LEN               WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_LIGHT_LEVEL
+/*
+ * Friend feature and replay protection, sized from the RAM given to the mesh core: the Low
+ * Power Node friendships and the replay protection entries are set, the Friend cache gets the
+ * rest of the budget. The default budget is the RAM of the earlier fixed configuration, a 300
+ * byte cache, 4 friendships and 8 replay entries, plus the RAM freed by keeping the read-only
+ * configuration tables in flash.
+ */
+// Estimated core RAM per friendship, per cached message and per replay protection entry
+#define MESH_FRIEND_LPN_SIZE                    32
+#define MESH_FRIEND_CACHE_MSG_SIZE              32
+#define MESH_REPLAY_ENTRY_SIZE                  8
 
-#define MESH_TEMP_SENSOR_PROPERTY_ID            WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE
-#define MESH_TEMP_SENSOR_VALUE_LEN              WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_TEMPERATURE
+#ifndef MESH_CORE_RAM_BUDGET
+#define MESH_CORE_RAM_BUDGET                    (300 + 4 * MESH_FRIEND_LPN_SIZE + 8 * MESH_REPLAY_ENTRY_SIZE + 192)
+#endif
+
+// Low Power Nodes the hub is a friend of at the same time
+#ifndef MESH_FRIEND_MAX_LPN
+#define MESH_FRIEND_MAX_LPN                     6
+#endif
+
+// Nodes sending application messages to the hub which the replay protection tells apart
+#ifndef MESH_CACHE_REPLAY_SIZE
+#define MESH_CACHE_REPLAY_SIZE                  8
+#endif
+
+// Friend cache in bytes, shared by the friendships, and the messages each friendship must fit
+#define MESH_FRIEND_CACHE_BUF_LEN               (MESH_CORE_RAM_BUDGET - MESH_FRIEND_MAX_LPN * MESH_FRIEND_LPN_SIZE - \
+                                                 MESH_CACHE_REPLAY_SIZE * MESH_REPLAY_ENTRY_SIZE)
+#define MESH_FRIEND_MIN_CACHE_MSGS              2
+
+// Descriptors of the sensors listed in mesh_manifest.h, named MESH_<name>_SENSOR_*
 
 // The ALS sensor has a positive and negative tolerance of 1%
 #define MESH_ALS_SENSOR_POSITIVE_TOLERANCE      CONVERT_TOLERANCE_PERCENTAGE_TO_MESH(1)
@@ -74,7 +100,131 @@
 #define MESH_TEMP_SENSOR_MEASUREMENT_PERIOD     WICED_BT_MESH_SENSOR_VAL_UNKNOWN
 #define MESH_TEMP_SENSOR_UPDATE_INTERVAL        WICED_BT_MESH_SENSOR_VAL_UNKNOWN
 
-#define MESH_ALS_SENSOR_ELEMENT_INDEX           (0)
-#define MESH_TEMP_SENSOR_ELEMENT_INDEX          (1)
+// When set, the thermistor is served as Precise Present Ambient Temperature, a signed 16-bit
+// value in 0.01 degree Celsius, instead of Present Ambient Temperature in 0.5 degree steps, so
+// that the trigger deltas and published values keep the resolution of the filtered readings
+#ifndef MESH_TEMP_SENSOR_PRECISE
+#define MESH_TEMP_SENSOR_PRECISE                0
+#endif
+
+// Property served for each sensor and the length of its value
+#define MESH_ALS_SENSOR_PROPERTY                WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL
+#define MESH_ALS_SENSOR_PROPERTY_LEN            WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_LIGHT_LEVEL
+#if MESH_TEMP_SENSOR_PRECISE
+#define MESH_TEMP_SENSOR_PROPERTY               WICED_BT_MESH_PROPERTY_PRECISE_PRESENT_AMBIENT_TEMPERATURE
+#define MESH_TEMP_SENSOR_PROPERTY_LEN           WICED_BT_MESH_PROPERTY_LEN_PRECISE_PRESENT_AMBIENT_TEMPERATURE
+#else
+#define MESH_TEMP_SENSOR_PROPERTY               WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE
+#define MESH_TEMP_SENSOR_PROPERTY_LEN           WICED_BT_MESH_PROPERTY_LEN_PRESENT_AMBIENT_TEMPERATURE
+#endif
+
+// A Sensor Get is answered with the last reading of the sensor when it is not older than this, in msec
+#ifndef MESH_ALS_SENSOR_MAX_AGE_MS
+#define MESH_ALS_SENSOR_MAX_AGE_MS              1000
+#endif
+#ifndef MESH_TEMP_SENSOR_MAX_AGE_MS
+#define MESH_TEMP_SENSOR_MAX_AGE_MS             5000
+#endif
+
+// The sensor hardware is initialized and read this many msec after the application
+// initialization, the mesh models answer in the meantime
+#ifndef MESH_SENSOR_START_DELAY_MS
+#define MESH_SENSOR_START_DELAY_MS              0
+#endif
+
+// When set, both sensors are served by the primary element so that their values
+// can be published together in one Sensor Status message
+#ifndef MESH_SENSOR_BATCH_PUBLISH
+#define MESH_SENSOR_BATCH_PUBLISH               0
+#endif
+
+// Sensor values due within this many msec of each other are published in one message
+#ifndef MESH_SENSOR_BATCH_WINDOW_MS
+#define MESH_SENSOR_BATCH_WINDOW_MS             500
+#endif
+
+// A sensor polled for its trigger deltas is polled up to 2^MESH_SENSOR_ADAPTIVE_MAX_SHIFT times
+// the cadence minimum interval while its value is stable, 0 always polls at the minimum interval
+#ifndef MESH_SENSOR_ADAPTIVE_MAX_SHIFT
+#define MESH_SENSOR_ADAPTIVE_MAX_SHIFT          2
+#endif
+
+// The polling interval doubles while the change of the value over the doubled interval stays within
+// 1/MESH_SENSOR_ADAPTIVE_MARGIN of the distance to the trigger bound, and drops back to the minimum
+// interval when the change over the current interval exceeds it
+#ifndef MESH_SENSOR_ADAPTIVE_MARGIN
+#define MESH_SENSOR_ADAPTIVE_MARGIN             4
+#endif
+
+// The fast cadence range has a hysteresis band inside each bound of this percentage of the trigger
+// delta a value published at the bound would have: a value enters the range when it is inside by the
+// band and leaves it when it is out of the range.  0 enters at the fast cadence bounds.
+#ifndef MESH_SENSOR_FAST_HYSTERESIS
+#define MESH_SENSOR_FAST_HYSTERESIS             50
+#endif
+
+// A value enters the fast cadence range when it was inside for this many msec of cadence checks,
+// and leaves it when it was outside for the exit time.  0 switches at the first check.
+#ifndef MESH_SENSOR_FAST_ENTER_DWELL_MS
+#define MESH_SENSOR_FAST_ENTER_DWELL_MS         0
+#endif
+#ifndef MESH_SENSOR_FAST_EXIT_DWELL_MS
+#define MESH_SENSOR_FAST_EXIT_DWELL_MS          0
+#endif
+
+// When set, the primary element has a vendor model which streams the readings of every sensor
+// at a sub-second interval set by a client, packing consecutive readings into one message
+#ifndef MESH_SENSOR_STREAM
+#define MESH_SENSOR_STREAM                      0
+#endif
+
+// Largest access message of the stream, 11 bytes fit in one unsegmented network PDU
+#ifndef MESH_STREAM_MAX_ACCESS_LEN
+#define MESH_STREAM_MAX_ACCESS_LEN              11
+#endif
+
+// Shortest sample interval of the stream in msec, a Set asking for less gets this.  Every sample
+// blocks the stack thread for a MAX44009 I2C transfer and a thermistor ADC conversion, and the
+// MAX44009 has a new reading only every 800 msec, so faster light samples only repeat it.
+#ifndef MESH_STREAM_MIN_INTERVAL_MS
+#define MESH_STREAM_MIN_INTERVAL_MS             100
+#endif
+
+// Default cadence minimum interval of the sensors, about 4 seconds
+#define MESH_SENSOR_MIN_INTERVAL_MS             (1 << 0x0C)
+
+/*
+ * Low Power Node variant. The node asks its friend for a poll timeout of MESH_LPN_POLL_TIMEOUT_POLLS
+ * poll intervals, and the mesh core polls the friend within it. The poll interval defaults to the
+ * longest trigger polling interval of a stable sensor, so that the sensor checks of a quiet room
+ * share the radio wake of the polls. Sensor deadlines shortly before a poll wait for it.
+ */
+#ifndef LOW_POWER_NODE
+#define LOW_POWER_NODE                          0
+#endif
+
+#ifndef MESH_LPN_POLL_INTERVAL_MS
+#define MESH_LPN_POLL_INTERVAL_MS               (MESH_SENSOR_MIN_INTERVAL_MS << MESH_SENSOR_ADAPTIVE_MAX_SHIFT)
+#endif
+#define MESH_LPN_POLL_TIMEOUT_POLLS             4
+
+// Poll timeout in 100 msec units
+#define MESH_LPN_POLL_TIMEOUT                   ((MESH_LPN_POLL_INTERVAL_MS * MESH_LPN_POLL_TIMEOUT_POLLS) / 100)
+
+// Sensor deadlines up to this many msec before a friend poll are deferred to it
+#ifndef MESH_LPN_WAKE_SLACK_MS
+#define MESH_LPN_WAKE_SLACK_MS                  2000
+#endif
+
+// The filter samples of a sensor are taken in a burst of this many reads at each cadence read,
+// instead of on a sampling timer which would wake the node between the friend polls
+#ifndef MESH_LPN_FILTER_BURST
+#define MESH_LPN_FILTER_BURST                   4
+#endif
+
+// The node stays awake when it can sleep for less than this many msec
+#ifndef MESH_LPN_MIN_SLEEP_MS
+#define MESH_LPN_MIN_SLEEP_MS                   10
+#endif
 
 #endif /* MESH_CFG_H_ */
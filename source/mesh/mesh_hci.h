@@ -0,0 +1,64 @@
+/******************************************************************************
+* File Name:   mesh_hci.h
+*
+* Description: This file contains the WICED HCI commands and events of the
+*              sensor hub, carried in the group reserved for this
+*              application.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_HCI_H_
+#define MESH_HCI_H_
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// WICED HCI group reserved for this application
+#define HCI_CONTROL_GROUP_SENSOR_HUB                0xF0
+
+// Commands from the host
+#define HCI_CONTROL_SENSOR_HUB_COMMAND_PROBE_GET    ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x01)   // Read the probe statistics, see mesh_probe.c
+#define HCI_CONTROL_SENSOR_HUB_COMMAND_PROBE_RESET  ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x02)   // Clear the probes
+#define HCI_CONTROL_SENSOR_HUB_COMMAND_CAPACITY_GET ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x03)   // Read the Friend and replay statistics, see mesh_capacity.c
+#define HCI_CONTROL_SENSOR_HUB_COMMAND_CAPACITY_RESET ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x04) // Clear the Friend and replay statistics, host simulation only
+
+// Events to the host
+#define HCI_CONTROL_SENSOR_HUB_EVENT_PROBE_STATS    ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x81)   // Probe statistics
+#define HCI_CONTROL_SENSOR_HUB_EVENT_LOG            ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x82)   // Binary log record, see mesh_log.c
+#define HCI_CONTROL_SENSOR_HUB_EVENT_CAPACITY_STATS ((HCI_CONTROL_GROUP_SENSOR_HUB << 8) | 0x83)   // Friend and replay statistics
+
+#endif /* MESH_HCI_H_ */
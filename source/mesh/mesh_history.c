@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   mesh_history.c
+*
+* Description: This file shows the implementation of the sensor history.
+*              Readings are averaged per time bin and the bins are kept in a
+*              fixed-size ring buffer, the oldest bin is overwritten.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "mesh_history.h"
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_history_init
+ *
+ *                  Clear the history of a sensor
+ *
+ * @param[in] p_history         : Sensor history
+ * @return                      : None
+ */
+void mesh_history_init(mesh_history_t *p_history)
+{
+    p_history->next    = 0;
+    p_history->count   = 0;
+    p_history->samples = 0;
+    p_history->sum     = 0;
+}
+
+
+/**
+ * Function         mesh_history_add
+ *
+ *                  Add a reading to the open bin
+ *
+ * @param[in] p_history         : Sensor history
+ * @param[in] value             : Native sensor value
+ * @return                      : None
+ */
+void mesh_history_add(mesh_history_t *p_history, int32_t value)
+{
+    // Readings beyond the capacity of the sample counter are left out of the bin
+    if (0xFFFF == p_history->samples)
+    {
+        return;
+    }
+    p_history->sum += value;
+    p_history->samples++;
+}
+
+
+/**
+ * Function         mesh_history_close_bin
+ *
+ *                  Store the average of the open bin in the ring buffer and open the next bin
+ *
+ * @param[in] p_history         : Sensor history
+ * @return                      : WICED_FALSE if the open bin had no reading and was not stored
+ */
+wiced_bool_t mesh_history_close_bin(mesh_history_t *p_history)
+{
+    if (0 == p_history->samples)
+    {
+        return WICED_FALSE;
+    }
+
+    p_history->bins[p_history->next] = (int32_t)(p_history->sum / p_history->samples);
+    p_history->next = (uint8_t)((p_history->next + 1) % MESH_SENSOR_HISTORY_BINS);
+    if (p_history->count < MESH_SENSOR_HISTORY_BINS)
+    {
+        p_history->count++;
+    }
+    p_history->samples = 0;
+    p_history->sum     = 0;
+    return WICED_TRUE;
+}
+
+
+/**
+ * Function         mesh_history_get
+ *
+ *                  Get the average of a closed bin
+ *
+ * @param[in] p_history         : Sensor history
+ * @param[in] age               : Age of the bin, 0 is the most recently closed bin, less than count
+ * @return                      : Average value of the bin
+ */
+int32_t mesh_history_get(mesh_history_t *p_history, uint8_t age)
+{
+    return p_history->bins[(p_history->next + MESH_SENSOR_HISTORY_BINS - 1 - age) % MESH_SENSOR_HISTORY_BINS];
+}
+
+
+/*END of FILE */
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name:   mesh_history.h
+*
+* Description: This file has the data types and function prototypes of the
+*              sensor history kept for the Sensor Series and Sensor Column
+*              messages.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_HISTORY_H_
+#define MESH_HISTORY_H_
+
+#include "stdint.h"
+#include "wiced.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Number of time bins kept for each sensor
+#ifndef MESH_SENSOR_HISTORY_BINS
+#define MESH_SENSOR_HISTORY_BINS                12
+#endif
+
+// Time span of each bin in msec, the history covers MESH_SENSOR_HISTORY_BINS times this
+#ifndef MESH_SENSOR_HISTORY_BIN_MS
+#define MESH_SENSOR_HISTORY_BIN_MS              (5 * 60 * 1000)
+#endif
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    int32_t     bins[MESH_SENSOR_HISTORY_BINS];     // Average value of the closed bins
+    uint8_t     next;                               // Ring position of the next bin to close
+    uint8_t     count;                              // Number of closed bins held
+    uint16_t    samples;                            // Number of samples in the open bin
+    int64_t     sum;                                // Sum of the samples in the open bin
+} mesh_history_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_history_init(mesh_history_t *p_history);
+void mesh_history_add(mesh_history_t *p_history, int32_t value);
+wiced_bool_t mesh_history_close_bin(mesh_history_t *p_history);
+int32_t mesh_history_get(mesh_history_t *p_history, uint8_t age);
+
+#endif /* MESH_HISTORY_H_ */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:   mesh_log.c
+*
+* Description: This file has the implementation of the application log, the
+*              encoder of the binary log records.  The text log is formatted
+*              by WICED_BT_TRACE at the call site, see mesh_log.h.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include "wiced_bt_mesh_core.h"
+#include "wiced_transport.h"
+#include "mesh_hci.h"
+#include "mesh_log.h"
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+#if MESH_LOG_BINARY
+/**
+ * Function         mesh_log_write
+ *
+ *                  Send a binary log record to the host in one WICED HCI event.  The host looks up
+ *                  the format string of the message ID in mesh_log_fmt.h, see sim/log_decode.c.
+ *
+ * @param[in] level             : Level of the message
+ * @param[in] id                : Message ID
+ * @param[in] nargs             : Number of integer arguments that follow
+ * @return                      : None
+ */
+void mesh_log_write(uint8_t level, mesh_log_id_t id, uint8_t nargs, ...)
+{
+    uint8_t record[MESH_LOG_RECORD_MAX_LEN];
+    uint8_t *p = record;
+    uint32_t tick = wiced_bt_mesh_core_get_tick_count();
+    uint32_t arg;
+    va_list args;
+    uint8_t i;
+
+    if (nargs > MESH_LOG_MAX_ARGS)
+    {
+        nargs = MESH_LOG_MAX_ARGS;
+    }
+
+    UINT16_TO_STREAM(p, (uint16_t)id);
+    *p++ = (uint8_t)((level << 4) | nargs);
+    for (i = 0; i < 4; i++)
+    {
+        *p++ = (uint8_t)(tick >> (8 * i));
+    }
+
+    va_start(args, nargs);
+    while (nargs--)
+    {
+        arg = va_arg(args, uint32_t);
+        for (i = 0; i < 4; i++)
+        {
+            *p++ = (uint8_t)(arg >> (8 * i));
+        }
+    }
+    va_end(args);
+
+    wiced_transport_send_data(HCI_CONTROL_SENSOR_HUB_EVENT_LOG, record, (uint16_t)(p - record));
+}
+#endif
+
+
+/*END of FILE */
@@ -0,0 +1,138 @@
+/******************************************************************************
+* File Name:   mesh_log.h
+*
+* Description: This file has the macros of the leveled application log.
+*              Messages below MESH_LOG_LEVEL are compiled out; the others are
+*              printed as text or sent as binary records of message ID and
+*              raw arguments, decoded on the host.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_LOG_H_
+#define MESH_LOG_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+#define MESH_LOG_LEVEL_NONE                     0
+#define MESH_LOG_LEVEL_ERROR                    1
+#define MESH_LOG_LEVEL_WARN                     2
+#define MESH_LOG_LEVEL_INFO                     3
+#define MESH_LOG_LEVEL_DEBUG                    4       // Per sample traces of the cadence engine
+
+// Messages of a higher level than this are compiled out
+#ifndef MESH_LOG_LEVEL
+#define MESH_LOG_LEVEL                          MESH_LOG_LEVEL_INFO
+#endif
+
+// Set to send binary records over WICED HCI instead of formatting the messages
+#ifndef MESH_LOG_BINARY
+#define MESH_LOG_BINARY                         0
+#endif
+
+// Most arguments of a message
+#define MESH_LOG_MAX_ARGS                       6
+
+// Binary record: message ID, level and number of arguments, tick count, arguments, all little endian
+#define MESH_LOG_RECORD_HEADER_LEN              7
+#define MESH_LOG_RECORD_MAX_LEN                 (MESH_LOG_RECORD_HEADER_LEN + 4 * MESH_LOG_MAX_ARGS)
+
+// Number of arguments, 0 to MESH_LOG_MAX_ARGS
+#define MESH_LOG_NARGS(...)                     MESH_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define MESH_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#if MESH_LOG_BINARY
+#define MESH_LOG_WRITE(level, id, ...)          mesh_log_write(level, id, MESH_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#else
+#define MESH_LOG_WRITE(level, id, ...)          WICED_BT_TRACE(mesh_log_format_##id(), ##__VA_ARGS__)
+#endif
+
+// The arguments of a compiled out message are not evaluated
+#if MESH_LOG_LEVEL >= MESH_LOG_LEVEL_ERROR
+#define MESH_LOG_ERROR(id, ...)                 MESH_LOG_WRITE(MESH_LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#else
+#define MESH_LOG_ERROR(id, ...)
+#endif
+
+#if MESH_LOG_LEVEL >= MESH_LOG_LEVEL_WARN
+#define MESH_LOG_WARN(id, ...)                  MESH_LOG_WRITE(MESH_LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#else
+#define MESH_LOG_WARN(id, ...)
+#endif
+
+#if MESH_LOG_LEVEL >= MESH_LOG_LEVEL_INFO
+#define MESH_LOG_INFO(id, ...)                  MESH_LOG_WRITE(MESH_LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#else
+#define MESH_LOG_INFO(id, ...)
+#endif
+
+#if MESH_LOG_LEVEL >= MESH_LOG_LEVEL_DEBUG
+#define MESH_LOG_DEBUG(id, ...)                 MESH_LOG_WRITE(MESH_LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+#else
+#define MESH_LOG_DEBUG(id, ...)
+#endif
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// Message IDs, see mesh_log_fmt.h
+typedef enum
+{
+#define MESH_LOG_FMT(id, format)                id,
+#include "mesh_log_fmt.h"
+#undef MESH_LOG_FMT
+    MESH_LOG_ID_COUNT
+} mesh_log_id_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+#if MESH_LOG_BINARY
+void mesh_log_write(uint8_t level, mesh_log_id_t id, uint8_t nargs, ...);
+#else
+// Format string of each message for the text log.  Only the messages compiled in call theirs,
+// so the format strings of the messages above MESH_LOG_LEVEL are not linked in.
+#define MESH_LOG_FMT(id, format)                static inline const char *mesh_log_format_##id(void) { return format; }
+#include "mesh_log_fmt.h"
+#undef MESH_LOG_FMT
+#endif
+
+#endif /* MESH_LOG_H_ */
@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name:   mesh_log_fmt.h
+*
+* Description: This file lists the log messages of the application. The
+*              position of a message in the list is its ID in the binary log,
+*              so new messages are only ever appended.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*
+ * No include guard: the list is expanded with a different definition of MESH_LOG_FMT(id, format)
+ * by each user. The arguments of a message are integers of up to 32 bits, at most
+ * MESH_LOG_MAX_ARGS of them.
+ */
+MESH_LOG_FMT(MESH_LOG_APP_START,            "\n***** Mesh SensorHub *****\n")
+MESH_LOG_FMT(MESH_LOG_THERMISTOR_INIT,      "Thermistor initialization done!\n")
+MESH_LOG_FMT(MESH_LOG_ALS_INIT,             "ALS sensor initialization done!\n")
+MESH_LOG_FMT(MESH_LOG_SCHED_INIT,           "Sensor scheduler initialization done, slack:%d ms\n")
+MESH_LOG_FMT(MESH_LOG_SCHED_INIT_FAILED,    "Sensor scheduler timer initialization failed!\n")
+MESH_LOG_FMT(MESH_LOG_SCHED_FULL,           "Sensor scheduler full, timer dropped\n")
+MESH_LOG_FMT(MESH_LOG_CADENCE_TIMER_INIT,   "Cadence timer initialization for sensor %04x done!\n")
+MESH_LOG_FMT(MESH_LOG_MODEL_INIT,           "Sensor model initialization done!\n")
+MESH_LOG_FMT(MESH_LOG_RESTART_PERIOD,       "Sensor %04x restart timer period:%d\n")
+MESH_LOG_FMT(MESH_LOG_RESTART_TIMEOUT,      "Sensor %04x restart timer timeout:%d\n")
+MESH_LOG_FMT(MESH_LOG_IRQ_WINDOW,           "Sensor %04x interrupt window:%d..%d\n")
+MESH_LOG_FMT(MESH_LOG_CONFIG_EVENT,         "Mesh sensor server config change handler message: %d\n")
+MESH_LOG_FMT(MESH_LOG_UNKNOWN_EVENT,        "Unknown event: %d\n")
+MESH_LOG_FMT(MESH_LOG_REPORT_EVENT,         "Mesh sensor server report handler message: %d\n")
+MESH_LOG_FMT(MESH_LOG_GET_VALUE,            "Sensor %04x value:%d cache hits:%d misses:%d\n")
+MESH_LOG_FMT(MESH_LOG_CADENCE_UNKNOWN,      "Cadence changed for unknown property id:%04x\n")
+MESH_LOG_FMT(MESH_LOG_CADENCE_TRIGGERS,     "Cadence changed property id:%04x divisor:%d percent:%d delta up:%d down:%d\n")
+MESH_LOG_FMT(MESH_LOG_CADENCE_FAST,         "Cadence minimum interval:%d fast cadence low:%d high:%d\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_PERIOD,       "Publish needed for sensor %04x, period expired\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_DELTA_UP,     "Publish needed delta up for sensor %04x value:%d sent:%d\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_DELTA_DOWN,   "Publish needed delta down for sensor %04x value:%d sent:%d\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_IN_RANGE,     "Publish needed in range for sensor %04x\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_OUT_OF_RANGE, "Publish needed out of range for sensor %04x\n")
+MESH_LOG_FMT(MESH_LOG_MIN_INTERVAL,         "Time since last publish of sensor %04x, time:%d ms interval:%d ms\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_VALUE,        "Publish value for sensor %04x:%d, time:%d ms\n")
+MESH_LOG_FMT(MESH_LOG_PUBLISH_BATCH,        "Publish %d values of element %d in one message\n")
+MESH_LOG_FMT(MESH_LOG_SETTING_CHANGED,      "Mesh sensor setting changed, property id:%x, setting property id:%x\n")
+MESH_LOG_FMT(MESH_LOG_INVALID_PARAMS,       "Mesh sensor server invalid params idx:%d prop:%04x len:%d\n")
+MESH_LOG_FMT(MESH_LOG_NEW_VALUE,            "New sensor %04x value:%d\n")
+MESH_LOG_FMT(MESH_LOG_NOT_ENOUGH_TIME,      "Not enough time since last sensor %04x value published\n")
+MESH_LOG_FMT(MESH_LOG_ADV_NAME,             "Advertising in the device name\n")
+MESH_LOG_FMT(MESH_LOG_SCAN_RSP_FAILED,      "Failed to set scan response data\n")
+MESH_LOG_FMT(MESH_LOG_SEND_PERIOD,          "Sensor %04x data send period:%d ms\n")
+MESH_LOG_FMT(MESH_LOG_UNKNOWN_HCI_COMMAND,  "WICED HCI command:%04x not for the application\n")
+MESH_LOG_FMT(MESH_LOG_STORE_LOADED,         "Configuration of %d sensors restored from NVRAM\n")
+MESH_LOG_FMT(MESH_LOG_STORE_MIGRATED,       "Cadence records of an earlier version moved into one record\n")
+MESH_LOG_FMT(MESH_LOG_STORE_COMMIT,         "Configuration of %d sensors saved to NVRAM, result:%d\n")
+MESH_LOG_FMT(MESH_LOG_STORE_UNCHANGED,      "Configuration unchanged, NVRAM write skipped\n")
+MESH_LOG_FMT(MESH_LOG_SENSORS_STARTED,      "Sensors initialized and read %d ms after boot\n")
+MESH_LOG_FMT(MESH_LOG_FIRST_STATUS,         "First Sensor Status %d ms after boot\n")
+MESH_LOG_FMT(MESH_LOG_SENSOR_UNBOUND,       "No sensor of property %04x in the element table\n")
+MESH_LOG_FMT(MESH_LOG_CAPACITY_CONFIG,      "Friend of up to %d Low Power Nodes, cache %d bytes, %d replay entries, core RAM %d bytes\n")
+MESH_LOG_FMT(MESH_LOG_CAPACITY_EXCEEDED,    "Friend cache dropped %d messages, %d Friend Requests refused, %d replay entries evicted\n")
+MESH_LOG_FMT(MESH_LOG_ADAPT_INTERVAL,       "Sensor %04x polling interval shift:%d value:%d trigger low:%d high:%d\n")
+MESH_LOG_FMT(MESH_LOG_LPN_CONFIG,           "Low Power Node, poll timeout:%d00 ms, poll interval:%d ms, wake slack:%d ms\n")
+MESH_LOG_FMT(MESH_LOG_LPN_SLEEP_FAILED,     "Low Power Node sleep configuration failed!\n")
+MESH_LOG_FMT(MESH_LOG_LPN_SLEEP,            "Low Power Node idle for %d ms, next sensor deadline in %d ms\n")
+MESH_LOG_FMT(MESH_LOG_STREAM_SET,           "Sensor stream interval:%d ms, up to %d samples per message\n")
+MESH_LOG_FMT(MESH_LOG_STREAM_DATA,          "Sensor stream data of sensor %d, %d samples in %d bytes\n")
+MESH_LOG_FMT(MESH_LOG_STREAM_INVALID,       "Sensor stream invalid message opcode:%d len:%d\n")
+MESH_LOG_FMT(MESH_LOG_FAST_CADENCE,         "Sensor %04x fast cadence:%d value:%d after %d ms\n")
+MESH_LOG_FMT(MESH_LOG_SCHED_JITTER,         "Sensor deadlines jitter up to %d ms, seed:%08x\n")
@@ -0,0 +1,181 @@
+/******************************************************************************
+* File Name:   mesh_lpn.c
+*
+* Description: This file shows the Low Power Node support of the sensor hub.
+*              The node sleeps until the next poll of its friend or the next
+*              sensor deadline, and sensor deadlines shortly before a poll
+*              are deferred to it so that both share one wake.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "wiced_bt_mesh_core.h"
+#include "wiced_sleep.h"
+#include "mesh_cfg.h"
+#include "mesh_sched.h"
+#include "mesh_log.h"
+#include "mesh_lpn.h"
+#include "sensors.h"
+
+#if LOW_POWER_NODE
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static uint32_t mesh_lpn_sleep_permit_handler(wiced_sleep_poll_type_t type);
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+/*
+ * The node sleeps without shutdown so that RAM is retained: the cadence state, the read cache
+ * and the history of the sensors live in RAM and would be lost by a shutdown sleep.
+ */
+static wiced_sleep_config_t mesh_lpn_sleep_config =
+{
+    .sleep_mode             = WICED_SLEEP_MODE_NO_TRANSPORT,
+    .host_wake_mode         = WICED_SLEEP_WAKE_ACTIVE_HIGH,
+    .device_wake_mode       = WICED_SLEEP_WAKE_ACTIVE_LOW,
+#if SENSOR_ALS_IRQ_MODE
+    .device_wake_source     = WICED_SLEEP_WAKE_SOURCE_GPIO,     // The light sensor interrupt wakes the node
+    .device_wake_gpio_num   = SENSOR_ALS_IRQ_PIN,
+#else
+    .device_wake_source     = 0,                                // Only the timers wake the node
+    .device_wake_gpio_num   = 0,
+#endif
+    .sleep_permit_handler   = mesh_lpn_sleep_permit_handler,
+};
+
+static uint32_t     mesh_lpn_wake_time;                 // Tick count of the next poll of the friend
+static wiced_bool_t mesh_lpn_idle = WICED_FALSE;        // The mesh core is idle until mesh_lpn_wake_time
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_lpn_init
+ *
+ *                  Register the sleep permit handler of the Low Power Node
+ *
+ * @return                      : None
+ */
+void mesh_lpn_init(void)
+{
+    mesh_lpn_idle = WICED_FALSE;
+
+    if (WICED_SUCCESS != wiced_sleep_configure(&mesh_lpn_sleep_config))
+    {
+        MESH_LOG_ERROR(MESH_LOG_LPN_SLEEP_FAILED);
+        return;
+    }
+    MESH_LOG_INFO(MESH_LOG_LPN_CONFIG, MESH_LPN_POLL_TIMEOUT, MESH_LPN_POLL_INTERVAL_MS, MESH_LPN_WAKE_SLACK_MS);
+}
+
+
+/**
+ * Function         mesh_lpn_sleep
+ *
+ *                  The mesh core is idle until its next poll of the friend.  Sensor deadlines up to
+ *                  MESH_LPN_WAKE_SLACK_MS before the poll are deferred to it, so that the sensor reads
+ *                  and publishes of that wake go out while the radio is up for the poll.
+ *
+ * @param[in] max_sleep_duration : Time in msec until the mesh core polls the friend
+ * @return                      : None
+ */
+void mesh_lpn_sleep(uint32_t max_sleep_duration)
+{
+    mesh_sched_set_anchor(max_sleep_duration, MESH_LPN_WAKE_SLACK_MS);
+
+    mesh_lpn_wake_time = wiced_bt_mesh_core_get_tick_count() + max_sleep_duration;
+    mesh_lpn_idle = WICED_TRUE;
+    MESH_LOG_DEBUG(MESH_LOG_LPN_SLEEP, max_sleep_duration, mesh_sched_get_next_deadline());
+}
+
+
+/**
+ * Function         mesh_lpn_sleep_permit_handler
+ *
+ *                  Answer the sleep polls of the firmware.  The node sleeps while the mesh core is
+ *                  idle, until the next poll of the friend or the next sensor deadline, whichever
+ *                  comes first.
+ *
+ * @param[in] type              : Sleep poll type
+ * @return                      : Time to sleep in usec, or the sleep permission
+ */
+static uint32_t mesh_lpn_sleep_permit_handler(wiced_sleep_poll_type_t type)
+{
+    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+    uint32_t sleep;
+    uint32_t next;
+
+    // The mesh core is busy again from its wake time until it reports the next idle period
+    if (mesh_lpn_idle && ((int32_t)(cur_time - mesh_lpn_wake_time) >= 0))
+    {
+        mesh_lpn_idle = WICED_FALSE;
+    }
+
+    switch (type)
+    {
+    case WICED_SLEEP_POLL_TIME_TO_SLEEP:
+        if (!mesh_lpn_idle)
+        {
+            return 0;
+        }
+        sleep = mesh_lpn_wake_time - cur_time;
+        next = mesh_sched_get_next_deadline();
+        if (next < sleep)
+        {
+            sleep = next;
+        }
+        if (sleep < MESH_LPN_MIN_SLEEP_MS)
+        {
+            return 0;
+        }
+        return (sleep < (WICED_SLEEP_MAX_TIME_TO_SLEEP / 1000)) ? (sleep * 1000) : WICED_SLEEP_MAX_TIME_TO_SLEEP;
+
+    case WICED_SLEEP_POLL_SLEEP_PERMISSION:
+        return mesh_lpn_idle ? WICED_SLEEP_ALLOWED_WITHOUT_SHUTDOWN : WICED_SLEEP_NOT_ALLOWED;
+
+    default:
+        return WICED_SLEEP_NOT_ALLOWED;
+    }
+}
+
+#endif /* LOW_POWER_NODE */
+
+
+/*END of FILE */
@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name:   mesh_manifest.h
+*
+* Description: This file is the sensor manifest of the hub. The element and
+*              sensor tables of mesh_cfg.c and the sensor table of
+*              mesh_server.c are generated from it at compile time.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_MANIFEST_H_
+#define MESH_MANIFEST_H_
+
+#include "mesh_cfg.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+#define MESH_ALS_SENSOR_ELEMENT_INDEX           0
+#if MESH_SENSOR_BATCH_PUBLISH
+#define MESH_TEMP_SENSOR_ELEMENT_INDEX          0
+#else
+#define MESH_TEMP_SENSOR_ELEMENT_INDEX          1
+#endif
+
+/*
+ * Elements of the node, in element order: X(arg, element_idx, models)
+ *
+ * element_idx   : index of the element
+ * models        : array of the models of the element, in mesh_cfg.c
+ */
+#if MESH_SENSOR_BATCH_PUBLISH
+#define MESH_MANIFEST_ELEMENTS(X, arg) \
+    X(arg, 0, mesh_element1_models)
+#else
+#define MESH_MANIFEST_ELEMENTS(X, arg) \
+    X(arg, 0, mesh_element1_models) \
+    X(arg, 1, mesh_element2_models)
+#endif
+
+/*
+ * Sensors of the hub, grouped by element in element order:
+ * X(arg, name, element_idx, driver, max_age)
+ * A sensor listed out of the group of its element is reported unbound at start.
+ *
+ * name          : MESH_<name>_SENSOR_PROPERTY, MESH_<name>_SENSOR_PROPERTY_LEN and the
+ *                 MESH_<name>_SENSOR_* descriptor settings in mesh_cfg.h
+ * element_idx   : element serving the sensor property
+ * driver        : sensor driver, see sensors.h
+ * max_age       : age in msec up to which a reading answers a Sensor Get
+ */
+#define MESH_MANIFEST_SENSORS(X, arg) \
+    X(arg, ALS,  MESH_ALS_SENSOR_ELEMENT_INDEX,  sensor_als_driver,        MESH_ALS_SENSOR_MAX_AGE_MS) \
+    X(arg, TEMP, MESH_TEMP_SENSOR_ELEMENT_INDEX, sensor_thermistor_driver, MESH_TEMP_SENSOR_MAX_AGE_MS)
+
+// Number of sensors on an element, and the position of its first sensor in the sensor tables
+#define MESH_MANIFEST_ON_ELEMENT(idx, name, element_idx, driver, max_age)        + ((element_idx) == (idx))
+#define MESH_MANIFEST_BEFORE_ELEMENT(idx, name, element_idx, driver, max_age)    + ((element_idx) < (idx))
+#define MESH_MANIFEST_ELEMENT_SENSORS(idx)      (0 MESH_MANIFEST_SENSORS(MESH_MANIFEST_ON_ELEMENT, idx))
+#define MESH_MANIFEST_ELEMENT_FIRST(idx)        (0 MESH_MANIFEST_SENSORS(MESH_MANIFEST_BEFORE_ELEMENT, idx))
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// Position of each sensor in the sensor tables
+#define MESH_MANIFEST_INDEX(arg, name, element_idx, driver, max_age)    MESH_SENSOR_IDX_##name,
+enum
+{
+    MESH_MANIFEST_SENSORS(MESH_MANIFEST_INDEX, 0)
+    MESH_SENSOR_COUNT
+};
+
+// Fails to compile when a sensor is listed on an element missing from MESH_MANIFEST_ELEMENTS
+#define MESH_MANIFEST_ELEMENT_CHECK(arg, element_idx, models)   + MESH_MANIFEST_ELEMENT_SENSORS(element_idx)
+typedef char mesh_manifest_sensors_on_elements[((0 MESH_MANIFEST_ELEMENTS(MESH_MANIFEST_ELEMENT_CHECK, 0)) == MESH_SENSOR_COUNT) ? 1 : -1];
+
+#endif /* MESH_MANIFEST_H_ */
@@ -0,0 +1,207 @@
+/******************************************************************************
+* File Name:   mesh_probe.c
+*
+* Description: This file shows the implementation of the cycle count probes.
+*              Each probe keeps the count, minimum, maximum and sum of its
+*              durations, and the most recent records of all probes are kept
+*              in a ring buffer. The statistics are read out over WICED HCI.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "wiced_bt_trace.h"
+#include "wiced_transport.h"
+#include "mesh_probe.h"
+
+#if MESH_PROBE_ENABLE
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+mesh_probe_stats_t  mesh_probe_stats[MESH_PROBE_COUNT];
+mesh_probe_record_t mesh_probe_ring[MESH_PROBE_RING_SIZE];     // Most recent records, oldest overwritten
+uint8_t             mesh_probe_ring_next = 0;
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_probe_init
+ *
+ *                  Start the cycle counter and clear the probes
+ *
+ * @return                      : None
+ */
+void mesh_probe_init(void)
+{
+#ifdef MESH_PROBE_USE_DWT
+    MESH_PROBE_DEMCR |= MESH_PROBE_DEMCR_TRCENA;
+    MESH_PROBE_DWT_CYCCNT = 0;
+    MESH_PROBE_DWT_CTRL |= MESH_PROBE_DWT_CTRL_CYCCNTENA;
+#endif
+    mesh_probe_reset();
+}
+
+
+/**
+ * Function         mesh_probe_reset
+ *
+ *                  Clear the statistics and records of all probes
+ *
+ * @return                      : None
+ */
+void mesh_probe_reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MESH_PROBE_COUNT; i++)
+    {
+        mesh_probe_stats[i].count = 0;
+        mesh_probe_stats[i].min   = 0xFFFFFFFF;
+        mesh_probe_stats[i].max   = 0;
+        mesh_probe_stats[i].sum   = 0;
+    }
+    for (i = 0; i < MESH_PROBE_RING_SIZE; i++)
+    {
+        mesh_probe_ring[i].probe = MESH_PROBE_COUNT;
+    }
+    mesh_probe_ring_next = 0;
+}
+
+
+/**
+ * Function         mesh_probe_record
+ *
+ *                  Record the end of a stage
+ *
+ * @param[in] probe             : Probe of the stage
+ * @param[in] start             : Cycle counter at the start of the stage
+ * @return                      : None
+ */
+void mesh_probe_record(mesh_probe_t probe, uint32_t start)
+{
+    uint32_t cycles = MESH_PROBE_CYCLES() - start;
+    mesh_probe_stats_t *p_stats = &mesh_probe_stats[probe];
+    mesh_probe_record_t *p_record = &mesh_probe_ring[mesh_probe_ring_next];
+
+    p_stats->count++;
+    p_stats->sum += cycles;
+    if (cycles < p_stats->min)
+    {
+        p_stats->min = cycles;
+    }
+    if (cycles > p_stats->max)
+    {
+        p_stats->max = cycles;
+    }
+
+    p_record->probe  = (uint8_t)probe;
+    p_record->start  = start;
+    p_record->cycles = cycles;
+    mesh_probe_ring_next = (uint8_t)((mesh_probe_ring_next + 1) % MESH_PROBE_RING_SIZE);
+}
+
+
+/**
+ * Function         mesh_probe_get_stats
+ *
+ *                  Get the statistics of a probe
+ *
+ * @param[in] probe             : Probe
+ * @return                      : Statistics, min is 0xFFFFFFFF while count is 0
+ */
+const mesh_probe_stats_t *mesh_probe_get_stats(mesh_probe_t probe)
+{
+    return &mesh_probe_stats[probe];
+}
+
+
+/**
+ * Function         mesh_probe_hci_command
+ *
+ *                  Process the probe commands received over WICED HCI.  The statistics are
+ *                  returned in one event, MESH_PROBE_HCI_STATS_LEN little endian bytes per probe.
+ *
+ * @param[in] opcode            : WICED HCI opcode
+ * @param[in] p_data            : Command parameters, not used
+ * @param[in] length            : Length of the parameters
+ * @return                      : WICED_TRUE if the command was processed
+ */
+uint32_t mesh_probe_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    uint8_t buffer[MESH_PROBE_COUNT * MESH_PROBE_HCI_STATS_LEN];
+    uint8_t *p = buffer;
+    mesh_probe_stats_t *p_stats;
+    uint32_t field[4];
+    uint8_t i, j, k;
+
+    switch (opcode)
+    {
+    case HCI_CONTROL_SENSOR_HUB_COMMAND_PROBE_GET:
+        for (i = 0; i < MESH_PROBE_COUNT; i++)
+        {
+            p_stats = &mesh_probe_stats[i];
+            field[0] = p_stats->count;
+            field[1] = (0 == p_stats->count) ? 0 : p_stats->min;
+            field[2] = p_stats->max;
+            field[3] = (0 == p_stats->count) ? 0 : (uint32_t)(p_stats->sum / p_stats->count);
+
+            *p++ = i;
+            for (j = 0; j < 4; j++)
+            {
+                for (k = 0; k < 4; k++)
+                {
+                    *p++ = (uint8_t)(field[j] >> (8 * k));
+                }
+            }
+        }
+        wiced_transport_send_data(HCI_CONTROL_SENSOR_HUB_EVENT_PROBE_STATS, buffer, (uint16_t)sizeof(buffer));
+        return WICED_TRUE;
+
+    case HCI_CONTROL_SENSOR_HUB_COMMAND_PROBE_RESET:
+        mesh_probe_reset();
+        return WICED_TRUE;
+
+    default:
+        return WICED_FALSE;
+    }
+}
+
+#endif /* MESH_PROBE_ENABLE */
+
+
+/*END of FILE */
@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name:   mesh_probe.h
+*
+* Description: This file has the macros and function prototypes of the cycle
+*              count probes around the read, decide and publish stages of the
+*              sensor pipeline.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_PROBE_H_
+#define MESH_PROBE_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "mesh_hci.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Probes are compiled in only when set, the probe macros are empty otherwise
+#ifndef MESH_PROBE_ENABLE
+#define MESH_PROBE_ENABLE                       0
+#endif
+
+// Number of most recent probe records kept
+#ifndef MESH_PROBE_RING_SIZE
+#define MESH_PROBE_RING_SIZE                    32
+#endif
+
+// Cycle counter of the Cortex-M data watchpoint and trace unit
+#define MESH_PROBE_DEMCR                        (*(volatile uint32_t *)0xE000EDFC)
+#define MESH_PROBE_DEMCR_TRCENA                 (1u << 24)
+#define MESH_PROBE_DWT_CTRL                     (*(volatile uint32_t *)0xE0001000)
+#define MESH_PROBE_DWT_CTRL_CYCCNTENA           (1u << 0)
+#define MESH_PROBE_DWT_CYCCNT                   (*(volatile uint32_t *)0xE0001004)
+
+// Another counter may be supplied with MESH_PROBE_CYCLES, e.g. on a host build
+#ifndef MESH_PROBE_CYCLES
+#define MESH_PROBE_USE_DWT
+#define MESH_PROBE_CYCLES()                     (MESH_PROBE_DWT_CYCCNT)
+#endif
+
+// Bytes per probe in the HCI event: id, count, min, max and mean cycles
+#define MESH_PROBE_HCI_STATS_LEN                17
+
+#if MESH_PROBE_ENABLE
+#define MESH_PROBE_START(probe)                 uint32_t mesh_probe_start_##probe = MESH_PROBE_CYCLES()
+#define MESH_PROBE_STOP(probe)                  mesh_probe_record(probe, mesh_probe_start_##probe)
+#else
+#define MESH_PROBE_START(probe)
+#define MESH_PROBE_STOP(probe)
+#endif
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// Stages of the read, decide and publish pipeline
+typedef enum
+{
+    MESH_PROBE_CADENCE,         // Cadence timer callback, read to publish
+    MESH_PROBE_ALS_READ,        // I2C read of the ambient light sensor
+    MESH_PROBE_TEMP_READ,       // ADC read of the thermistor
+    MESH_PROBE_DECIDE,          // Cadence decision
+    MESH_PROBE_PUBLISH,         // Hand over of the Sensor Status to the mesh models library
+    MESH_PROBE_GET,             // Sensor Get processing
+    MESH_PROBE_COUNT
+} mesh_probe_t;
+
+typedef struct
+{
+    uint32_t    count;          // Number of records
+    uint32_t    min;            // Shortest duration in cycles
+    uint32_t    max;            // Longest duration in cycles
+    uint64_t    sum;            // Sum of the durations in cycles
+} mesh_probe_stats_t;
+
+typedef struct
+{
+    uint8_t     probe;          // mesh_probe_t
+    uint32_t    start;          // Cycle counter at the start of the stage
+    uint32_t    cycles;         // Duration of the stage
+} mesh_probe_record_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+#if MESH_PROBE_ENABLE
+void mesh_probe_init(void);
+void mesh_probe_reset(void);
+void mesh_probe_record(mesh_probe_t probe, uint32_t start);
+const mesh_probe_stats_t *mesh_probe_get_stats(mesh_probe_t probe);
+uint32_t mesh_probe_hci_command(uint16_t opcode, uint8_t *p_data, uint32_t length);
+#endif
+
+#endif /* MESH_PROBE_H_ */
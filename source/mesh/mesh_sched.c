@@ -0,0 +1,546 @@
+/******************************************************************************
+* File Name:   mesh_sched.c
+*
+* Description: This file shows the implementation of the sensor scheduler.
+*              All sensor deadlines are kept in a min-heap and served by a
+*              single hardware timer armed for the earliest one.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "wiced_bt_mesh_core.h"
+#include "wiced_timer.h"
+#include "mesh_sched.h"
+#include "mesh_log.h"
+
+/******************************************************************************
+ *                              Macros
+ ******************************************************************************/
+// Wrap safe comparison of two tick counts
+#define MESH_SCHED_BEFORE(a, b)                 ((int32_t)((a) - (b)) < 0)
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static void mesh_sched_timer_callback(TIMER_PARAM_TYPE arg);
+static void mesh_sched_swap(uint8_t i, uint8_t j);
+static void mesh_sched_sift_up(uint8_t idx);
+static void mesh_sched_sift_down(uint8_t idx);
+static void mesh_sched_remove(mesh_sched_timer_t *p_timer);
+static void mesh_sched_arm(void);
+
+// Fails to compile when MESH_SCHED_MAX_TIMERS is set below the timers of the application
+typedef char mesh_sched_max_timers_check[(MESH_SCHED_MAX_TIMERS >= MESH_SCHED_APP_TIMERS) ? 1 : -1];
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static wiced_timer_t        mesh_sched_hw_timer;                        // The only timer running for the sensors
+static mesh_sched_timer_t   *mesh_sched_heap[MESH_SCHED_MAX_TIMERS];    // Queued timers, earliest deadline first
+static uint8_t              mesh_sched_heap_len = 0;
+static uint32_t             mesh_sched_armed_deadline;                  // Deadline the hardware timer is running for
+static wiced_bool_t         mesh_sched_armed = WICED_FALSE;
+static wiced_bool_t         mesh_sched_dispatching = WICED_FALSE;
+static uint32_t             mesh_sched_slack = MESH_SCHED_SLACK_MS;
+static uint32_t             mesh_sched_anchor;                          // Tick count of a wakeup of the device outside the scheduler
+static uint32_t             mesh_sched_anchor_window = 0;               // Deadlines this many msec before the anchor wait for it, 0 for none
+static uint32_t             mesh_sched_jitter_state = 1;                // Pseudo random generator of the jitter, never 0
+static uint32_t             mesh_sched_jitter_max = 0;                  // Largest jitter in msec, 0 for none
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_sched_init
+ *
+ *                  Initialize the hardware timer shared by all scheduler timers
+ *
+ * @return                        : None
+ */
+void mesh_sched_init(void)
+{
+    wiced_result_t result;
+
+    mesh_sched_heap_len = 0;
+    mesh_sched_armed = WICED_FALSE;
+    mesh_sched_anchor_window = 0;
+
+    result = wiced_init_timer(&mesh_sched_hw_timer, &mesh_sched_timer_callback, 0, WICED_MILLI_SECONDS_TIMER);
+    if (WICED_SUCCESS == result)
+    {
+        MESH_LOG_INFO(MESH_LOG_SCHED_INIT, mesh_sched_slack);
+    }
+    else
+    {
+        MESH_LOG_ERROR(MESH_LOG_SCHED_INIT_FAILED);
+    }
+}
+
+
+/**
+ * Function         mesh_sched_set_slack
+ *
+ *                  Set how much a deadline can be deferred to be served together with
+ *                  another one.  Zero disables coalescing.
+ *
+ * @param[in] slack             : Slack window in msec
+ * @return                      : None
+ */
+void mesh_sched_set_slack(uint32_t slack)
+{
+    mesh_sched_slack = slack;
+}
+
+
+/**
+ * Function         mesh_sched_set_anchor
+ *
+ *                  Announce a wakeup of the device for another reason, such as a radio event.
+ *                  Deadlines which fall within the window before it, queued or started until
+ *                  then, are deferred to it so that the device wakes once for both.
+ *
+ * @param[in] timeout           : Time until the wakeup in msec
+ * @param[in] window            : Deferral window in msec, zero disables the anchor
+ * @return                      : None
+ */
+void mesh_sched_set_anchor(uint32_t timeout, uint32_t window)
+{
+    uint8_t i;
+
+    mesh_sched_anchor = wiced_bt_mesh_core_get_tick_count() + timeout;
+    mesh_sched_anchor_window = window;
+    if (0 == window)
+    {
+        return;
+    }
+
+    // Moving the deadlines of a window to its end keeps their order, the heap needs no sifting
+    for (i = 0; i < mesh_sched_heap_len; i++)
+    {
+        if ((mesh_sched_anchor - mesh_sched_heap[i]->deadline) <= window)
+        {
+            mesh_sched_heap[i]->deadline = mesh_sched_anchor;
+        }
+    }
+    mesh_sched_arm();
+}
+
+
+/**
+ * Function         mesh_sched_set_jitter
+ *
+ *                  Seed the jitter of the deadlines with bytes which differ between devices,
+ *                  such as the device address, so that devices which start their timers at the
+ *                  same time draw different jitter and drift apart, and a device draws the same
+ *                  jitter after every restart.
+ *
+ * @param[in] p_seed            : Seed bytes
+ * @param[in] len               : Number of seed bytes
+ * @param[in] max_jitter        : Largest jitter in msec, zero disables the jitter
+ * @return                      : None
+ */
+void mesh_sched_set_jitter(const uint8_t *p_seed, uint8_t len, uint32_t max_jitter)
+{
+    uint32_t hash = 2166136261u;
+    uint8_t i;
+
+    // FNV-1a hash of the seed, the generator state must not be 0
+    for (i = 0; i < len; i++)
+    {
+        hash = (hash ^ p_seed[i]) * 16777619u;
+    }
+    mesh_sched_jitter_state = (0 != hash) ? hash : 1;
+    mesh_sched_jitter_max = max_jitter;
+    if (0 != max_jitter)
+    {
+        MESH_LOG_INFO(MESH_LOG_SCHED_JITTER, max_jitter, mesh_sched_jitter_state);
+    }
+}
+
+
+/**
+ * Function         mesh_sched_jitter
+ *
+ *                  Draw the jitter to add to a deadline from the xorshift generator seeded
+ *                  by mesh_sched_set_jitter
+ *
+ * @return                      : Jitter in msec, 0 to the largest jitter
+ */
+uint32_t mesh_sched_jitter(void)
+{
+    uint32_t x = mesh_sched_jitter_state;
+
+    if (0 == mesh_sched_jitter_max)
+    {
+        return 0;
+    }
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    mesh_sched_jitter_state = x;
+    return x % (mesh_sched_jitter_max + 1);
+}
+
+
+/**
+ * Function         mesh_sched_init_timer
+ *
+ *                  Initialize a scheduler timer
+ *
+ * @param[in] p_timer           : Timer to initialize
+ * @param[in] cback             : Function called when the timer expires
+ * @param[in] arg               : Parameter passed to the callback
+ * @return                      : None
+ */
+void mesh_sched_init_timer(mesh_sched_timer_t *p_timer, mesh_sched_callback_t cback, TIMER_PARAM_TYPE arg)
+{
+    p_timer->cback    = cback;
+    p_timer->arg      = arg;
+    p_timer->heap_idx = MESH_SCHED_NOT_QUEUED;
+}
+
+
+/**
+ * Function         mesh_sched_start_timer
+ *
+ *                  Start or restart a scheduler timer.  If another timer expires within the
+ *                  slack window after the requested deadline, or the anchor within its window,
+ *                  both are served by the same wakeup.  A timer never expires before the
+ *                  requested timeout.
+ *
+ * @param[in] p_timer           : Timer to start
+ * @param[in] timeout           : Timeout in msec
+ * @return                      : None
+ */
+void mesh_sched_start_timer(mesh_sched_timer_t *p_timer, uint32_t timeout)
+{
+    uint32_t deadline = wiced_bt_mesh_core_get_tick_count() + timeout;
+    uint32_t best_delta = MESH_SCHED_NO_DEADLINE;
+    uint32_t delta;
+    uint8_t i;
+
+    mesh_sched_remove(p_timer);
+
+    if (mesh_sched_heap_len >= MESH_SCHED_MAX_TIMERS)
+    {
+        MESH_LOG_ERROR(MESH_LOG_SCHED_FULL);
+        return;
+    }
+
+    // Align with the earliest queued deadline which falls in the slack window
+    for (i = 0; i < mesh_sched_heap_len; i++)
+    {
+        delta = mesh_sched_heap[i]->deadline - deadline;
+        if ((delta <= mesh_sched_slack) && (delta < best_delta))
+        {
+            best_delta = delta;
+        }
+    }
+    delta = mesh_sched_anchor - deadline;
+    if ((0 != mesh_sched_anchor_window) && (delta <= mesh_sched_anchor_window) && (delta < best_delta))
+    {
+        best_delta = delta;
+    }
+    p_timer->deadline = (MESH_SCHED_NO_DEADLINE != best_delta) ? (deadline + best_delta) : deadline;
+
+    p_timer->heap_idx = mesh_sched_heap_len;
+    mesh_sched_heap[mesh_sched_heap_len++] = p_timer;
+    mesh_sched_sift_up(p_timer->heap_idx);
+
+    mesh_sched_arm();
+}
+
+
+/**
+ * Function         mesh_sched_stop_timer
+ *
+ *                  Stop a scheduler timer
+ *
+ * @param[in] p_timer           : Timer to stop
+ * @return                      : None
+ */
+void mesh_sched_stop_timer(mesh_sched_timer_t *p_timer)
+{
+    if (MESH_SCHED_NOT_QUEUED != p_timer->heap_idx)
+    {
+        mesh_sched_remove(p_timer);
+        mesh_sched_arm();
+    }
+}
+
+
+/**
+ * Function         mesh_sched_is_timer_in_use
+ *
+ *                  Check if a scheduler timer is running
+ *
+ * @param[in] p_timer           : Timer to check
+ * @return                      : WICED_TRUE if the timer is queued
+ */
+wiced_bool_t mesh_sched_is_timer_in_use(mesh_sched_timer_t *p_timer)
+{
+    return (MESH_SCHED_NOT_QUEUED != p_timer->heap_idx);
+}
+
+
+/**
+ * Function         mesh_sched_get_remaining
+ *
+ *                  Time until a scheduler timer expires
+ *
+ * @param[in] p_timer           : Timer to check
+ * @return                      : Time in msec, MESH_SCHED_NO_DEADLINE if the timer is not running
+ */
+uint32_t mesh_sched_get_remaining(mesh_sched_timer_t *p_timer)
+{
+    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+
+    if (MESH_SCHED_NOT_QUEUED == p_timer->heap_idx)
+    {
+        return MESH_SCHED_NO_DEADLINE;
+    }
+    if (MESH_SCHED_BEFORE(p_timer->deadline, cur_time))
+    {
+        return 0;
+    }
+    return p_timer->deadline - cur_time;
+}
+
+
+/**
+ * Function         mesh_sched_get_next_deadline
+ *
+ *                  Time until the earliest queued timer expires.  The device can sleep at
+ *                  least this long as far as the sensors are concerned.
+ *
+ * @return                      : Time in msec, MESH_SCHED_NO_DEADLINE if no timer is running
+ */
+uint32_t mesh_sched_get_next_deadline(void)
+{
+    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+
+    if (0 == mesh_sched_heap_len)
+    {
+        return MESH_SCHED_NO_DEADLINE;
+    }
+    if (MESH_SCHED_BEFORE(mesh_sched_heap[0]->deadline, cur_time))
+    {
+        return 0;
+    }
+    return mesh_sched_heap[0]->deadline - cur_time;
+}
+
+
+/**
+ * Function         mesh_sched_timer_callback
+ *
+ *                  Hardware timer callback.  Runs every timer whose deadline has passed and
+ *                  rearms the hardware timer for the next one.
+ *
+ * @param[in] arg               : Not used
+ * @return                      : None
+ */
+void mesh_sched_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_sched_timer_t *p_timer;
+
+    mesh_sched_armed = WICED_FALSE;
+    mesh_sched_dispatching = WICED_TRUE;
+
+    while ((0 != mesh_sched_heap_len) &&
+           !MESH_SCHED_BEFORE(wiced_bt_mesh_core_get_tick_count(), mesh_sched_heap[0]->deadline))
+    {
+        p_timer = mesh_sched_heap[0];
+        mesh_sched_remove(p_timer);
+        p_timer->cback(p_timer->arg);
+    }
+
+    mesh_sched_dispatching = WICED_FALSE;
+    mesh_sched_arm();
+}
+
+
+/**
+ * Function         mesh_sched_arm
+ *
+ *                  Make sure the hardware timer runs for the earliest queued deadline.  The
+ *                  hardware timer is only restarted if that deadline has changed.
+ *
+ * @return                      : None
+ */
+void mesh_sched_arm(void)
+{
+    uint32_t cur_time;
+
+    // Rearmed once all expired timers are served
+    if (mesh_sched_dispatching)
+    {
+        return;
+    }
+
+    if (0 == mesh_sched_heap_len)
+    {
+        if (mesh_sched_armed)
+        {
+            wiced_stop_timer(&mesh_sched_hw_timer);
+            mesh_sched_armed = WICED_FALSE;
+        }
+        return;
+    }
+
+    if (mesh_sched_armed && (mesh_sched_armed_deadline == mesh_sched_heap[0]->deadline))
+    {
+        return;
+    }
+
+    cur_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_sched_armed_deadline = mesh_sched_heap[0]->deadline;
+    mesh_sched_armed = WICED_TRUE;
+
+    wiced_stop_timer(&mesh_sched_hw_timer);
+    wiced_start_timer(&mesh_sched_hw_timer,
+            MESH_SCHED_BEFORE(cur_time, mesh_sched_armed_deadline) ? (mesh_sched_armed_deadline - cur_time) : 0);
+}
+
+
+/**
+ * Function         mesh_sched_remove
+ *
+ *                  Remove a timer from the deadline heap, if queued
+ *
+ * @param[in] p_timer           : Timer to remove
+ * @return                      : None
+ */
+void mesh_sched_remove(mesh_sched_timer_t *p_timer)
+{
+    uint8_t idx = p_timer->heap_idx;
+
+    if (MESH_SCHED_NOT_QUEUED == idx)
+    {
+        return;
+    }
+
+    p_timer->heap_idx = MESH_SCHED_NOT_QUEUED;
+    mesh_sched_heap_len--;
+    if (idx == mesh_sched_heap_len)
+    {
+        return;
+    }
+
+    // Move the last timer into the hole and restore the heap order
+    mesh_sched_heap[idx] = mesh_sched_heap[mesh_sched_heap_len];
+    mesh_sched_heap[idx]->heap_idx = idx;
+    mesh_sched_sift_up(idx);
+    mesh_sched_sift_down(mesh_sched_heap[idx]->heap_idx);
+}
+
+
+/**
+ * Function         mesh_sched_swap
+ *
+ *                  Swap two heap entries
+ *
+ * @param[in] i                 : First heap index
+ * @param[in] j                 : Second heap index
+ * @return                      : None
+ */
+void mesh_sched_swap(uint8_t i, uint8_t j)
+{
+    mesh_sched_timer_t *p_timer = mesh_sched_heap[i];
+
+    mesh_sched_heap[i] = mesh_sched_heap[j];
+    mesh_sched_heap[j] = p_timer;
+    mesh_sched_heap[i]->heap_idx = i;
+    mesh_sched_heap[j]->heap_idx = j;
+}
+
+
+/**
+ * Function         mesh_sched_sift_up
+ *
+ *                  Move a heap entry towards the root while it expires before its parent
+ *
+ * @param[in] idx               : Heap index
+ * @return                      : None
+ */
+void mesh_sched_sift_up(uint8_t idx)
+{
+    uint8_t parent;
+
+    while (idx > 0)
+    {
+        parent = (uint8_t)((idx - 1) / 2);
+        if (!MESH_SCHED_BEFORE(mesh_sched_heap[idx]->deadline, mesh_sched_heap[parent]->deadline))
+        {
+            break;
+        }
+        mesh_sched_swap(idx, parent);
+        idx = parent;
+    }
+}
+
+
+/**
+ * Function         mesh_sched_sift_down
+ *
+ *                  Move a heap entry towards the leaves while a child expires before it
+ *
+ * @param[in] idx               : Heap index
+ * @return                      : None
+ */
+void mesh_sched_sift_down(uint8_t idx)
+{
+    uint8_t child;
+
+    while ((child = (uint8_t)(2 * idx + 1)) < mesh_sched_heap_len)
+    {
+        if (((child + 1) < mesh_sched_heap_len) &&
+            MESH_SCHED_BEFORE(mesh_sched_heap[child + 1]->deadline, mesh_sched_heap[child]->deadline))
+        {
+            child++;
+        }
+        if (!MESH_SCHED_BEFORE(mesh_sched_heap[child]->deadline, mesh_sched_heap[idx]->deadline))
+        {
+            break;
+        }
+        mesh_sched_swap(idx, child);
+        idx = child;
+    }
+}
+
+
+/*END of FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   mesh_sched.h
+*
+* Description: This file has the data types and function prototypes of the
+*              sensor scheduler, which multiplexes all sensor deadlines onto
+*              one timer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_SCHED_H_
+#define MESH_SCHED_H_
+
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "mesh_manifest.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Scheduler timers of the application: the cadence and sample timers of each sensor, the batch,
+// history, start and store commit timers, and the stream timer
+#define MESH_SCHED_APP_TIMERS                   (2 * MESH_SENSOR_COUNT + 4 + MESH_SENSOR_STREAM)
+
+// Maximum number of scheduler timers which can be queued at the same time
+#ifndef MESH_SCHED_MAX_TIMERS
+#define MESH_SCHED_MAX_TIMERS                   MESH_SCHED_APP_TIMERS
+#endif
+
+// A deadline is deferred by up to this many msec to expire together with an already queued one
+#ifndef MESH_SCHED_SLACK_MS
+#define MESH_SCHED_SLACK_MS                     50
+#endif
+
+// Largest pseudo random delay in msec added to the cadence deadlines, 0 for none
+#ifndef MESH_SCHED_JITTER_MS
+#define MESH_SCHED_JITTER_MS                    250
+#endif
+
+#define MESH_SCHED_NOT_QUEUED                   0xFF
+#define MESH_SCHED_NO_DEADLINE                  0xFFFFFFFF
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef void (*mesh_sched_callback_t)(TIMER_PARAM_TYPE arg);
+
+typedef struct
+{
+    mesh_sched_callback_t   cback;          // Called when the timer expires
+    TIMER_PARAM_TYPE        arg;            // Parameter passed to the callback
+    uint32_t                deadline;       // Tick count at which the timer expires
+    uint8_t                 heap_idx;       // Position in the deadline heap, MESH_SCHED_NOT_QUEUED if stopped
+} mesh_sched_timer_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_sched_init(void);
+void mesh_sched_set_slack(uint32_t slack);
+void mesh_sched_set_anchor(uint32_t timeout, uint32_t window);
+void mesh_sched_set_jitter(const uint8_t *p_seed, uint8_t len, uint32_t max_jitter);
+uint32_t mesh_sched_jitter(void);
+void mesh_sched_init_timer(mesh_sched_timer_t *p_timer, mesh_sched_callback_t cback, TIMER_PARAM_TYPE arg);
+void mesh_sched_start_timer(mesh_sched_timer_t *p_timer, uint32_t timeout);
+void mesh_sched_stop_timer(mesh_sched_timer_t *p_timer);
+wiced_bool_t mesh_sched_is_timer_in_use(mesh_sched_timer_t *p_timer);
+uint32_t mesh_sched_get_remaining(mesh_sched_timer_t *p_timer);
+uint32_t mesh_sched_get_next_deadline(void);
+
+#endif /* MESH_SCHED_H_ */
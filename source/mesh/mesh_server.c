@@ -44,27 +44,60 @@
 #include "wiced_bt_gatt.h"
 #include "wiced_bt_mesh_models.h"
 #include "wiced_bt_trace.h"
-#include "wiced_hal_nvram.h"
 #include "mesh_cfg.h"
+#include "mesh_manifest.h"
 #include "mesh_server.h"
+#include "mesh_sched.h"
+#include "mesh_probe.h"
+#include "mesh_capacity.h"
+#include "mesh_lpn.h"
+#include "mesh_stream.h"
+#include "mesh_log.h"
+#include "mesh_store.h"
 #include "sensors.h"
 
+
 /******************************************************************************
  *                              Macros
  ******************************************************************************/
-#define MESH_SENSOR_ALS_CADENCE_NVRAM_ID        WICED_NVRAM_VSID_START
-#define MESH_SENSOR_TEMP_CADENCE_NVRAM_ID        WICED_NVRAM_VSID_START + 24u
 
  /* PAYLAOD LEN = SIZE(PROPERTY_ID) + SIZE(PROPERTY_LEN) + SIZE(SENSOR_VALUE) */
-#define MESH_SENSOR_ALS_PAYLOAD_LENGTH            MESH_ALS_SENSOR_VALUE_LEN + 4
-#define MESH_SENSOR_TEMP_PAYLOAD_LENGTH            MESH_TEMP_SENSOR_VALUE_LEN + 4
+#define MESH_SENSOR_PAYLOAD_LENGTH(value_len)   ((value_len) + 4)
 
 /******************************************************************************
  *                          Function Prototypes
  ******************************************************************************/
-static void mesh_sensor_publish_als_timer_callback(TIMER_PARAM_TYPE arg);
-static void mesh_sensor_publish_temp_timer_callback(TIMER_PARAM_TYPE arg);
-static void mesh_sensor_server_restart_timer(uint8_t element_idx, wiced_bt_mesh_core_config_sensor_t *p_sensor);
+static void mesh_sensor_refresh(mesh_sensor_t *p_sensor, uint32_t max_age);
+static int32_t mesh_sensor_read(mesh_sensor_t *p_sensor, uint32_t max_age);
+static void mesh_sensor_stop_sampling(mesh_sensor_t *p_sensor);
+#if LOW_POWER_NODE
+static void mesh_sensor_read_burst(mesh_sensor_t *p_sensor);
+#endif
+static mesh_sensor_t *mesh_sensor_find(uint8_t element_idx, uint16_t property_id);
+static int32_t mesh_sensor_from_raw(mesh_sensor_t *p_sensor, uint32_t raw_value);
+static void mesh_sensor_to_raw(mesh_sensor_t *p_sensor, int32_t value, uint8_t *p_raw);
+static void mesh_sensor_value_limits(mesh_sensor_t *p_sensor, int32_t *p_min, int32_t *p_max);
+static void mesh_sensor_store_value(mesh_sensor_t *p_sensor, int32_t value);
+static void mesh_sensor_update_columns(mesh_sensor_t *p_sensor);
+static void mesh_sensor_start(void);
+static void mesh_sensor_start_timer_callback(TIMER_PARAM_TYPE arg);
+static void mesh_sensor_server_data(uint8_t element_idx, uint16_t property_id, wiced_bt_mesh_event_t *p_ref_data);
+static void mesh_sensor_history_timer_callback(TIMER_PARAM_TYPE arg);
+static wiced_bool_t mesh_sensor_publish_needed(mesh_sensor_t *p_sensor, uint32_t cur_time);
+static void mesh_sensor_fast_check(mesh_sensor_t *p_sensor, uint32_t cur_time);
+static void mesh_sensor_publish_timer_callback(TIMER_PARAM_TYPE arg);
+static void mesh_sensor_cadence_check(mesh_sensor_t *p_sensor);
+static uint8_t mesh_sensor_adapt_shift(mesh_sensor_t *p_sensor);
+static void mesh_sensor_adapt(mesh_sensor_t *p_sensor, wiced_bool_t published);
+static void mesh_sensor_sample_timer_callback(TIMER_PARAM_TYPE arg);
+static void mesh_sensor_publish(mesh_sensor_t *p_sensor);
+static void mesh_sensor_batch_flush(void);
+static void mesh_sensor_batch_timer_callback(TIMER_PARAM_TYPE arg);
+static void mesh_sensor_server_restart_timer(mesh_sensor_t *p_sensor);
+static void mesh_sensor_update_window(mesh_sensor_t *p_sensor, wiced_bool_t triggers);
+#if SENSOR_ALS_IRQ_MODE
+static void mesh_sensor_als_irq(void);
+#endif
 static void mesh_sensor_server_report_handler(uint16_t event, uint8_t element_idx, void *p_get, void *p_ref_data);
 static void mesh_sensor_server_process_cadence_changed(uint8_t element_idx, uint16_t property_id);
 static void mesh_sensor_server_process_setting_changed(uint8_t element_idx, uint16_t property_id, uint16_t setting_property_id);
@@ -72,6 +105,7 @@ static void mesh_sensor_server_config_change_handler(uint8_t element_idx, uint16
 static void mesh_sensor_server_status_changed(uint8_t element_idx, uint8_t *p_data, uint32_t length);
 static wiced_bool_t mesh_app_notify_period_set(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint32_t period);
 static void mesh_app_factory_reset(void);
+static uint32_t mesh_app_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length);
 extern void mesh_app_init(wiced_bool_t is_provisioned);
 
 /******************************************************************************
@@ -79,23 +113,29 @@ extern void mesh_app_init(wiced_bool_t is_provisioned);
  ******************************************************************************/
 extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
-// Present Ambient Light Sensor property.
-uint32_t      mesh_sensor_current_lux_value = 0;        // ambient light value
-uint32_t      mesh_sensor_sent_lux_value = 0;
-uint32_t      mesh_sensor_sent_lux_time;                // time stamp when lux was published
-uint32_t      mesh_sensor_publish_lux_period = 0;       // publish period in msec
-uint32_t      mesh_sensor_fast_publish_lux_period = 0;  // publish period in msec when values are outside of limit
+// Sensors served by the hub, in the order of mesh_manifest.h. Cadence state of each property is kept
+// in its entry, the element and configuration are looked up in mesh_config by the driver property.
+#define MESH_SERVER_SENSOR(arg, name, element_idx, driver, age) { .p_driver = &driver, .max_age = age },
+mesh_sensor_t mesh_sensors[MESH_SENSOR_COUNT] =
+{
+    MESH_MANIFEST_SENSORS(MESH_SERVER_SENSOR, 0)
+};
+
+// Values due for publishing wait on this timer for the other sensors of their element
+mesh_sched_timer_t mesh_sensor_batch_timer;
 
+// Closes a history bin of every sensor each MESH_SENSOR_HISTORY_BIN_MS
+mesh_sched_timer_t mesh_sensor_history_timer;
 
-// Present Ambient Temperature Sensor property.
-int8_t        mesh_sensor_current_temp_value = 0;        // ambient temperature value
-int8_t        mesh_sensor_sent_temp_value = 0;
-uint32_t      mesh_sensor_sent_temp_time;                // time stamp when temp was published
-uint32_t      mesh_sensor_publish_temp_period = 0;       // publish period in msec
-uint32_t      mesh_sensor_fast_publish_temp_period = 0;  // publish period in msec when values are outside of limit
+// Initializes the sensor hardware and reads the sensors once the mesh models are up
+mesh_sched_timer_t mesh_sensor_start_timer;
 
+// Sensor hardware is initialized and every sensor has been read
+wiced_bool_t mesh_sensors_started = WICED_FALSE;
 
-wiced_timer_t mesh_sensor_cadence_als_timer, mesh_sensor_cadence_temp_timer;
+// Tick count when the application initialization started, and whether a Sensor Status was sent since
+uint32_t     mesh_sensor_boot_time = 0;
+wiced_bool_t mesh_sensor_status_sent = WICED_FALSE;
 
 /*
  * Mesh application library will call into application functions if provided by the application.
@@ -107,8 +147,12 @@ wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
     NULL,                       // GATT connection status
     NULL,                       // attention processing
     mesh_app_notify_period_set, // notify period set
-    NULL,                       // WICED HCI command
+    mesh_app_proc_rx_cmd,       // WICED HCI command
+#if LOW_POWER_NODE
+    mesh_lpn_sleep,             // LPN sleep
+#else
     NULL,                       // LPN sleep
+#endif
     mesh_app_factory_reset      // factory reset
 };
 
@@ -116,94 +160,369 @@ wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
 *                                Function Definitions
 ******************************************************************************/
 
+/**
+ * Function         mesh_sensor_find
+ *
+ *                  Find the sensor serving a property on an element
+ *
+ * @param[in] element_idx       : Element id value
+ * @param[in] property_id       : Property id value, 0 matches any property of the element
+ * @return                      : Sensor entry, NULL if not found
+ */
+mesh_sensor_t *mesh_sensor_find(uint8_t element_idx, uint16_t property_id)
+{
+    uint8_t i;
+
+    for (i = 0; i < MESH_SENSOR_COUNT; i++)
+    {
+        if ((mesh_sensors[i].element_idx == element_idx) &&
+            ((0 == property_id) || (mesh_sensors[i].property_id == property_id)))
+        {
+            return &mesh_sensors[i];
+        }
+    }
+    return NULL;
+}
+
 
 /**
- * Function         mesh_sensor_init_value
+ * Function         mesh_sensor_refresh
  *
- *                  Read and initialize the sensor values
+ *                  Bring the reading of a sensor up to date through its read cache.  The last reading
+ *                  is kept while it is not older than max_age, otherwise the sensor is read into its
+ *                  filter, and the filtered value into the read cache and the history.
  *
- * @return                        : None;
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] max_age           : Maximum age of the cached reading in msec, 0 always reads the hardware
+ * @return                      : None
  */
-void mesh_sensor_init_value()
+void mesh_sensor_refresh(mesh_sensor_t *p_sensor, uint32_t max_age)
 {
-    wiced_result_t  result = WICED_SUCCESS;
+    // The first read before the deferred start runs the start right away
+    if (!mesh_sensors_started)
+    {
+        mesh_sensor_start();
+    }
 
-    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = NULL;
+    if ((0 != max_age) && ((wiced_bt_mesh_core_get_tick_count() - p_sensor->read_time) <= max_age))
+    {
+        p_sensor->cache_hits++;
+        return;
+    }
 
-    /* Read ambient light level */
-    mesh_sensor_current_lux_value = sensor_get_light_level();
+    p_sensor->cache_misses++;
+    p_sensor->p_driver->read();
+    p_sensor->current_value = p_sensor->p_driver->value();
+    p_sensor->read_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_history_add(&p_sensor->history, p_sensor->current_value);
+}
 
-    /* Read temperature value */
-    mesh_sensor_current_temp_value = sensor_get_temperature();
 
-    mesh_sensor_sent_lux_value = mesh_sensor_current_lux_value;
-    mesh_sensor_sent_temp_value = mesh_sensor_current_temp_value;
-    mesh_sensor_sent_lux_time = mesh_sensor_sent_temp_time = cur_time;
+/**
+ * Function         mesh_sensor_read
+ *
+ *                  Read a sensor through its read cache.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] max_age           : Maximum age of the cached reading in msec, 0 always reads the hardware
+ * @return                      : Native sensor value
+ */
+int32_t mesh_sensor_read(mesh_sensor_t *p_sensor, uint32_t max_age)
+{
+    mesh_sensor_refresh(p_sensor, max_age);
+    return p_sensor->current_value;
+}
 
-    p_sensor = &mesh_config.elements[MESH_ALS_SENSOR_ELEMENT_INDEX].sensors[0];
-    //restore the cadence for ambient light sensor from NVRAM
-    wiced_hal_read_nvram(MESH_SENSOR_ALS_CADENCE_NVRAM_ID, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &result);
 
-    p_sensor = &mesh_config.elements[MESH_TEMP_SENSOR_ELEMENT_INDEX].sensors[0];
-    //restore the cadence for temperature sensor from NVRAM
-    wiced_hal_read_nvram(MESH_SENSOR_TEMP_CADENCE_NVRAM_ID, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &result);
+/**
+ * Function         mesh_sensor_read_value
+ *
+ *                  Read a sensor of the manifest for the sensor stream.  The hardware is read each
+ *                  time, and the reading bypasses the filter, read cache and history, so the stream
+ *                  does not change the filtered values served to the clients nor the cadence.
+ *
+ * @param[in] sensor_idx        : Position of the sensor in mesh_manifest.h
+ * @return                      : Native sensor value, unfiltered
+ */
+int32_t mesh_sensor_read_value(uint8_t sensor_idx)
+{
+    if (!mesh_sensors_started)
+    {
+        mesh_sensor_start();
+    }
+    return mesh_sensors[sensor_idx].p_driver->read_raw();
+}
+
+
+/**
+ * Function         mesh_sensor_from_raw
+ *
+ *                  Convert a raw cadence value received from the client into the native
+ *                  sensor value, sign extending it for signed properties.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] raw_value         : Raw value in property encoding
+ * @return                      : Native sensor value
+ */
+int32_t mesh_sensor_from_raw(mesh_sensor_t *p_sensor, uint32_t raw_value)
+{
+    uint8_t shift = (uint8_t)(32 - 8 * p_sensor->p_config->prop_value_len);
 
-    WICED_BT_TRACE("Mesh Sensor values are initialized!\n");
+    if (!p_sensor->p_driver->is_signed || (0 == shift))
+    {
+        return (int32_t)raw_value;
+    }
+    return ((int32_t)(raw_value << shift)) >> shift;
 }
 
 
 /**
- * Function         mesh_sensor_cadence_init_als_timer
+ * Function         mesh_sensor_value_limits
  *
- *                  Initialize the cadence timer for ALS sensor
+ *                  Lowest and highest native value of the property of a sensor.
  *
- * @return                        : None;
+ * @param[in] p_sensor          : Sensor entry
+ * @param[out] p_min            : Lowest value
+ * @param[out] p_max            : Highest value
+ * @return                      : None
  */
-void mesh_sensor_cadence_init_als_timer()
+void mesh_sensor_value_limits(mesh_sensor_t *p_sensor, int32_t *p_min, int32_t *p_max)
 {
-    wiced_result_t result = WICED_ERROR;
-    // Initialize the cadence timer for als sensor.  Need a timer for each element because each sensor model can be
-    // configured for different publication period.
-    result = wiced_init_timer(&mesh_sensor_cadence_als_timer, &mesh_sensor_publish_als_timer_callback,
-                    (TIMER_PARAM_TYPE)&mesh_config.elements[MESH_ALS_SENSOR_ELEMENT_INDEX].sensors[0],
-                    WICED_MILLI_SECONDS_TIMER);
+    uint8_t bits = (uint8_t)(8 * p_sensor->p_config->prop_value_len);
 
-    if(WICED_SUCCESS == result)
+    if (p_sensor->p_driver->is_signed)
     {
-        WICED_BT_TRACE("Cadence timer initialization for ALS sensor done!\n");
+        *p_min = (int32_t)-((int64_t)1 << (bits - 1));
+        *p_max = (int32_t)(((int64_t)1 << (bits - 1)) - 1);
     }
     else
     {
-        WICED_BT_TRACE("Cadence timer initialization failed for ALS sensor!\n");
+        *p_min = 0;
+        *p_max = (bits < 32) ? (int32_t)(((int64_t)1 << bits) - 1) : INT32_MAX;
     }
 }
 
 
 /**
- * Function         mesh_sensor_cadence_init_temp_timer
+ * Function         mesh_sensor_to_raw
  *
- *                  Initialize the cadence timer for thermistor sensor
+ *                  Convert a native sensor value into the little endian property encoding.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] value             : Native sensor value
+ * @param[out] p_raw            : Buffer of the property value length
+ * @return                      : None
+ */
+void mesh_sensor_to_raw(mesh_sensor_t *p_sensor, int32_t value, uint8_t *p_raw)
+{
+    uint8_t i;
+
+    for (i = 0; i < p_sensor->p_config->prop_value_len; i++)
+    {
+        p_raw[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+
+/**
+ * Function         mesh_sensor_store_value
+ *
+ *                  Store the value to be published in the property buffer used by the
+ *                  mesh models library, and move the trigger bounds around it.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] value             : Native sensor value
+ * @return                      : None
+ */
+void mesh_sensor_store_value(mesh_sensor_t *p_sensor, int32_t value)
+{
+    p_sensor->sent_value = value;
+    mesh_sensor_to_raw(p_sensor, value, p_sensor->p_config->data);
+    mesh_trigger_update(&p_sensor->trigger, &p_sensor->p_config->cadence, value);
+}
+
+
+/**
+ * Function         mesh_sensor_update_columns
+ *
+ *                  Copy the history of a sensor into its Sensor Series columns.  Column X is
+ *                  the age of a bin, column 0 holding the most recently closed bin, and
+ *                  column Y the average sensor value over the bin.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_update_columns(mesh_sensor_t *p_sensor)
+{
+    wiced_bt_mesh_sensor_config_column_data_t *p_column = p_sensor->p_config->series_columns;
+    uint8_t age;
+
+    for (age = 0; age < p_sensor->history.count; age++, p_column++)
+    {
+        mesh_sensor_to_raw(p_sensor, age, p_column->raw_valuex);
+        mesh_sensor_to_raw(p_sensor, 1, p_column->column_width);
+        mesh_sensor_to_raw(p_sensor, mesh_history_get(&p_sensor->history, age), p_column->raw_valuey);
+    }
+    p_sensor->p_config->num_series = p_sensor->history.count;
+}
+
+
+/**
+ * Function         mesh_sensor_start
+ *
+ *                  Initialize the sensor hardware and read and initialize the sensor values.
+ *                  Runs once, from the start timer or from the first read of a sensor.
  *
  * @return                        : None;
  */
-void mesh_sensor_cadence_init_temp_timer()
+void mesh_sensor_start(void)
 {
-    wiced_result_t result = WICED_ERROR;
+    uint32_t cur_time;
+    mesh_sensor_t *p_sensor;
 
-    // Initialize the cadence timer for thermistor.
-    result = wiced_init_timer(&mesh_sensor_cadence_temp_timer, &mesh_sensor_publish_temp_timer_callback,
-                    (TIMER_PARAM_TYPE)&mesh_config.elements[MESH_TEMP_SENSOR_ELEMENT_INDEX].sensors[0],
-                    WICED_MILLI_SECONDS_TIMER);
-    if(WICED_SUCCESS == result)
+    if (mesh_sensors_started)
     {
-        WICED_BT_TRACE("Cadence time initialization for thermistor done!\n");
+        return;
     }
-    else
+    mesh_sensors_started = WICED_TRUE;
+    mesh_sched_stop_timer(&mesh_sensor_start_timer);
+
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
+    {
+        p_sensor->p_driver->init();
+    }
+
+    cur_time = wiced_bt_mesh_core_get_tick_count();
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
+    {
+        mesh_history_init(&p_sensor->history);
+        mesh_sensor_store_value(p_sensor, mesh_sensor_read(p_sensor, 0));
+        p_sensor->sent_time = cur_time;
+        p_sensor->fast_hold_time = cur_time;
+    }
+
+    mesh_sched_start_timer(&mesh_sensor_history_timer, MESH_SENSOR_HISTORY_BIN_MS);
+
+    // Interrupt windows requested before the start could not be programmed
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
     {
-        WICED_BT_TRACE("Cadence timer initialization failed for thermistor!\n");
+        if (NULL != p_sensor->p_driver->set_window)
+        {
+            mesh_sensor_server_restart_timer(p_sensor);
+        }
     }
 
+    MESH_LOG_INFO(MESH_LOG_SENSORS_STARTED, wiced_bt_mesh_core_get_tick_count() - mesh_sensor_boot_time);
+}
+
+
+/**
+ * Function         mesh_sensor_start_timer_callback
+ *
+ *                  Deferred start of the sensors
+ *
+ * @param[in] arg               : Not used
+ * @return                      : None
+ */
+void mesh_sensor_start_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_sensor_start();
+}
+
+
+/**
+ * Function         mesh_sensor_start_deferred
+ *
+ *                  Schedule the initialization of the sensor hardware and the first reads of the
+ *                  sensors, so that the application initialization returns without waiting on
+ *                  the sensors.  A Sensor Get received before that runs the start right away.
+ *
+ * @param[in] boot_time           : Tick count when the application initialization started
+ * @return                        : None;
+ */
+void mesh_sensor_start_deferred(uint32_t boot_time)
+{
+    mesh_sensor_boot_time = boot_time;
+    mesh_sched_start_timer(&mesh_sensor_start_timer, MESH_SENSOR_START_DELAY_MS);
+}
+
+
+/**
+ * Function         mesh_sensor_server_data
+ *
+ *                  Hand a Sensor Status over to the mesh models library, logging the time from
+ *                  boot to the first one
+ *
+ * @param[in] element_idx       : Element id value
+ * @param[in] property_id       : Property id value, 0 for all properties of the element
+ * @param[in] p_ref_data        : Get message replied to, NULL to publish
+ * @return                      : None
+ */
+void mesh_sensor_server_data(uint8_t element_idx, uint16_t property_id, wiced_bt_mesh_event_t *p_ref_data)
+{
+    if (!mesh_sensor_status_sent)
+    {
+        mesh_sensor_status_sent = WICED_TRUE;
+        MESH_LOG_INFO(MESH_LOG_FIRST_STATUS, wiced_bt_mesh_core_get_tick_count() - mesh_sensor_boot_time);
+    }
+    wiced_bt_mesh_model_sensor_server_data(element_idx, property_id, p_ref_data);
+}
+
+
+/**
+ * Function         mesh_sensor_cadence_init_timers
+ *
+ *                  Bind each sensor to its configuration and initialize its cadence timer on
+ *                  the sensor scheduler
+ *
+ * @return                        : None;
+ */
+void mesh_sensor_cadence_init_timers(void)
+{
+    wiced_bt_mesh_core_config_element_t *p_element;
+    mesh_sensor_t *p_sensor;
+    uint8_t element_idx;
+    uint8_t i;
+
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
+    {
+        // Bind the driver to the sensor of its property in the element table
+        p_sensor->property_id = p_sensor->p_driver->property_id;
+        for (element_idx = 0; element_idx < mesh_config.elements_num; element_idx++)
+        {
+            p_element = &mesh_config.elements[element_idx];
+            for (i = 0; i < p_element->sensors_num; i++)
+            {
+                if (p_element->sensors[i].property_id == p_sensor->property_id)
+                {
+                    p_sensor->element_idx = element_idx;
+                    p_sensor->p_config = &p_element->sensors[i];
+                }
+            }
+        }
+        if (NULL == p_sensor->p_config)
+        {
+            MESH_LOG_ERROR(MESH_LOG_SENSOR_UNBOUND, p_sensor->property_id);
+        }
+
+        // Each sensor can be configured for different publication period, the deadlines of all
+        // sensors are multiplexed on the hardware timer of the sensor scheduler.
+        mesh_sched_init_timer(&p_sensor->timer, &mesh_sensor_publish_timer_callback, (TIMER_PARAM_TYPE)p_sensor);
+        mesh_sched_init_timer(&p_sensor->sample_timer, &mesh_sensor_sample_timer_callback, (TIMER_PARAM_TYPE)p_sensor);
+        MESH_LOG_INFO(MESH_LOG_CADENCE_TIMER_INIT, p_sensor->property_id);
+    }
+
+    mesh_sched_init_timer(&mesh_sensor_batch_timer, &mesh_sensor_batch_timer_callback, 0);
+    mesh_sched_init_timer(&mesh_sensor_history_timer, &mesh_sensor_history_timer_callback, 0);
+    mesh_sched_init_timer(&mesh_sensor_start_timer, &mesh_sensor_start_timer_callback, 0);
+    mesh_store_init();
+#if MESH_SENSOR_STREAM
+    mesh_stream_init();
+#endif
+
+#if SENSOR_ALS_IRQ_MODE
+    sensor_set_light_level_irq_callback(&mesh_sensor_als_irq);
+#endif
 }
 
 
@@ -217,14 +536,43 @@ void mesh_sensor_cadence_init_temp_timer()
  */
 void mesh_sensor_server_init_model(wiced_bool_t is_provisioned)
 {
+    uint8_t element_idx;
+
+    // Initialize the sensor server model on every element hosting sensors.
+    for (element_idx = 0; element_idx < mesh_config.elements_num; element_idx++)
+    {
+        if (0 != mesh_config.elements[element_idx].sensors_num)
+        {
+            wiced_bt_mesh_model_sensor_server_init(element_idx, mesh_sensor_server_report_handler,
+                                                    mesh_sensor_server_config_change_handler, is_provisioned);
+        }
+    }
+    MESH_LOG_INFO(MESH_LOG_MODEL_INIT);
+}
+
+
+/**
+ * Function         mesh_sensor_get_cache_stats
+ *
+ *                  Get the read cache counters of a sensor
+ *
+ * @param[in] element_idx       : Element id value
+ * @param[in] property_id       : Property id value
+ * @param[out] p_hits           : Reads answered from the last reading
+ * @param[out] p_misses         : Reads which went to the sensor hardware
+ * @return                      : WICED_FALSE if the sensor is not found
+ */
+wiced_bool_t mesh_sensor_get_cache_stats(uint8_t element_idx, uint16_t property_id, uint32_t *p_hits, uint32_t *p_misses)
+{
+    mesh_sensor_t *p_sensor = mesh_sensor_find(element_idx, property_id);
 
-    // Initialize the sensor server model for ALS sensor.
-    wiced_bt_mesh_model_sensor_server_init(MESH_ALS_SENSOR_ELEMENT_INDEX, mesh_sensor_server_report_handler,
-                                            mesh_sensor_server_config_change_handler, is_provisioned);
-    // Initialize the sensor server model for thermistor.
-    wiced_bt_mesh_model_sensor_server_init(MESH_TEMP_SENSOR_ELEMENT_INDEX, mesh_sensor_server_report_handler,
-                                            mesh_sensor_server_config_change_handler, is_provisioned);
-    WICED_BT_TRACE("Sensor model initialization done!\n");
+    if (NULL == p_sensor)
+    {
+        return WICED_FALSE;
+    }
+    *p_hits   = p_sensor->cache_hits;
+    *p_misses = p_sensor->cache_misses;
+    return WICED_TRUE;
 }
 
 
@@ -232,112 +580,208 @@ void mesh_sensor_server_init_model(wiced_bool_t is_provisioned)
  * Function         mesh_sensor_server_restart_timer
  *
  *                  Start periodic timer depending on the publication period, fast cadence divisor
- *                  and minimum interval.
+ *                  and minimum interval.  A sensor polled for its trigger deltas is polled at the
+ *                  minimum interval scaled by its adaptive shift, up to the next publication.
+ *                  The timeout is lengthened by the jitter of the scheduler.
  *
- * @param[in] element_idx       : Element id value
- * @param[in] p_sensor          : Sensor config value
+ * @param[in] p_sensor          : Sensor entry
  * @return                      : None
  */
-void mesh_sensor_server_restart_timer(uint8_t element_idx, wiced_bt_mesh_core_config_sensor_t *p_sensor)
+void mesh_sensor_server_restart_timer(mesh_sensor_t *p_sensor)
 {
+    wiced_bt_mesh_sensor_config_cadence_t *p_cadence = &p_sensor->p_config->cadence;
+    wiced_bool_t triggers = (0 != p_cadence->trigger_delta_up) || (0 != p_cadence->trigger_delta_down);
     // If there are no specific cadence settings, publish every publish period.
-    uint32_t timeout = 0;
+    uint32_t timeout = p_sensor->publish_period;
+    uint32_t poll_interval;
+    uint32_t elapsed;
+    uint32_t deadline;
+    int32_t min, max;
 
-    if(MESH_ALS_SENSOR_ELEMENT_INDEX == element_idx)
+    mesh_sched_stop_timer(&p_sensor->timer);
+
+    // The trigger deltas may have changed
+    mesh_trigger_update(&p_sensor->trigger, p_cadence, p_sensor->sent_value);
+
+    // An interrupt driven sensor reports trigger crossings itself, it is not polled for them
+    mesh_sensor_update_window(p_sensor, triggers);
+    if (NULL != p_sensor->p_driver->set_window)
+    {
+        triggers = WICED_FALSE;
+    }
+
+    if (0 == p_sensor->publish_period)
     {
-        timeout = mesh_sensor_publish_lux_period;
-        wiced_stop_timer(&mesh_sensor_cadence_als_timer);
-        if (0 == mesh_sensor_publish_lux_period)
+        // The sensor is not interrupt driven.  If client configured sensor to send notification when
+        // the value changes, we will need to check periodically if the condition has been satisfied.
+        // The cadence.min_interval can be used because we do not need to send data more often than that.
+        if ((0 != p_cadence->min_interval) && triggers)
         {
-            // The sensor is not interrupt driven.  If client configured sensor to send notification when
-            // the value changes, we will need to check periodically if the condition has been satisfied.
-            // The cadence.min_interval can be used because we do not need to send data more often than that.
-            if ((p_sensor->cadence.min_interval != 0) &&
-                ((p_sensor->cadence.trigger_delta_up != 0) || (p_sensor->cadence.trigger_delta_down != 0)))
-            {
-                timeout = p_sensor->cadence.min_interval;
-            }
-            else
-            {
-                WICED_BT_TRACE("Ambient light sensor restart timer period:%d\n", mesh_sensor_publish_lux_period);
-                return;
-            }
+            timeout = p_cadence->min_interval << p_sensor->adapt_shift;
         }
         else
         {
-            // If fast cadence period divisor is set, we need to check light level more
-            // often than publication period.  Publish if measurement is in specified range
-            if (1 < p_sensor->cadence.fast_cadence_period_divisor)
-            {
-                mesh_sensor_fast_publish_lux_period = mesh_sensor_publish_lux_period / p_sensor->cadence.fast_cadence_period_divisor;
-                timeout = mesh_sensor_fast_publish_lux_period;
-            }
-            else
-            {
-                mesh_sensor_fast_publish_lux_period = 0;
-            }
-            // The sensor is not interrupt driven.  If client configured sensor to send notification when
-            // the value changes, we may need to check value more often not to miss the trigger.
-            // The cadence.min_interval can be used because we do not need to send data more often than that.
-            if ((p_sensor->cadence.min_interval < timeout) &&
-                ((0 != p_sensor->cadence.trigger_delta_up) || (0 != p_sensor->cadence.trigger_delta_down)))
-            {
-                timeout = p_sensor->cadence.min_interval;
-            }
+            MESH_LOG_DEBUG(MESH_LOG_RESTART_PERIOD, p_sensor->property_id, p_sensor->publish_period);
+            p_sensor->adapt_shift = 0;
+            mesh_sensor_stop_sampling(p_sensor);
+            return;
         }
-
-        WICED_BT_TRACE("Ambient light sensor restart timer timeout:%d\n", timeout);
-        wiced_start_timer(&mesh_sensor_cadence_als_timer, timeout);
     }
-
-    if(MESH_TEMP_SENSOR_ELEMENT_INDEX == element_idx)
+    else
     {
-        timeout = mesh_sensor_publish_temp_period;
-        wiced_stop_timer(&mesh_sensor_cadence_temp_timer);
-        if (0 == mesh_sensor_publish_temp_period)
+        // If fast cadence period divisor is set, we need to check the value more
+        // often than publication period.  Publish if measurement is in specified range
+        if (1 < p_cadence->fast_cadence_period_divisor)
         {
-            // The thermistor is not interrupt driven.  If client configured sensor to send notification when
-            // the value changes, we will need to check periodically if the condition has been satisfied.
-            // The cadence.min_interval can be used because we do not need to send data more often than that.
-            if ((0 != p_sensor->cadence.min_interval) &&
-                ((0 != p_sensor->cadence.trigger_delta_up) || (0 != p_sensor->cadence.trigger_delta_down)))
-            {
-                timeout = p_sensor->cadence.min_interval;
-            }
-            else
-            {
-                WICED_BT_TRACE("Temperature sensor restart timer period:%d\n", mesh_sensor_publish_temp_period);
-                return;
-            }
+            p_sensor->fast_publish_period = p_sensor->publish_period / p_cadence->fast_cadence_period_divisor;
+            timeout = p_sensor->fast_publish_period;
+            mesh_sensor_value_limits(p_sensor, &min, &max);
+            mesh_trigger_range_update(&p_sensor->fast_range, p_cadence,
+                                      mesh_sensor_from_raw(p_sensor, p_cadence->fast_cadence_low),
+                                      mesh_sensor_from_raw(p_sensor, p_cadence->fast_cadence_high),
+                                      min, max, MESH_SENSOR_FAST_HYSTERESIS);
         }
         else
         {
-            // If fast cadence period divisor is set, we need to check light level more
-            // often than publication period.  Publish if measurement is in specified range
-            if (1 < p_sensor->cadence.fast_cadence_period_divisor)
-            {
-                mesh_sensor_fast_publish_temp_period = mesh_sensor_publish_temp_period / p_sensor->cadence.fast_cadence_period_divisor;
-                timeout = mesh_sensor_fast_publish_temp_period;
-            }
-            else
-            {
-                mesh_sensor_fast_publish_temp_period = 0;
-            }
-            // The thermistor is not interrupt driven.  If client configured sensor to send notification when
-            // the value changes, we may need to check value more often not to miss the trigger.
-            // The cadence.min_interval can be used because we do not need to send data more often than that.
-            if ((p_sensor->cadence.min_interval < timeout) &&
-                ((0 != p_sensor->cadence.trigger_delta_up) || (0 != p_sensor->cadence.trigger_delta_down)))
+            p_sensor->fast_publish_period = 0;
+        }
+        // The sensor is not interrupt driven.  If client configured sensor to send notification when
+        // the value changes, we may need to check value more often not to miss the trigger.
+        // The cadence.min_interval can be used because we do not need to send data more often than that.
+        // While the value is stable, the adaptive shift lengthens the interval, up to the next
+        // publication deadline so that a lengthened interval does not postpone the publication.
+        poll_interval = p_cadence->min_interval << p_sensor->adapt_shift;
+        elapsed = wiced_bt_mesh_core_get_tick_count() - p_sensor->sent_time;
+        deadline = ((0 != p_sensor->fast_publish_period) && (elapsed < p_sensor->fast_publish_period)) ?
+                   p_sensor->fast_publish_period : p_sensor->publish_period;
+        if ((0 != p_sensor->adapt_shift) && (elapsed < deadline) && ((deadline - elapsed) < poll_interval))
+        {
+            poll_interval = deadline - elapsed;
+        }
+        if ((p_cadence->min_interval < timeout) && triggers)
+        {
+            if (poll_interval < timeout)
             {
-                timeout = p_sensor->cadence.min_interval;
+                timeout = poll_interval;
             }
         }
+        else
+        {
+            p_sensor->adapt_shift = 0;
+        }
+    }
+
+    // Hubs configured alike drift apart instead of publishing at the same moments
+    timeout += mesh_sched_jitter();
+
+    MESH_LOG_DEBUG(MESH_LOG_RESTART_TIMEOUT, p_sensor->property_id, timeout);
+    mesh_sched_start_timer(&p_sensor->timer, timeout);
+
+    // Feed the filter between the cadence reads while the sensor is monitored for its trigger deltas
+    // or fast cadence range, as many times per polling interval when it is lengthened.  A periodic
+    // publication reads the sensor once per period and is not sampled.  Sampling is pointless when
+    // the cadence engine itself reads the sensor at least as often.
+#if LOW_POWER_NODE
+    // A Low Power Node sleeps from one friend poll to the next, the cadence reads feed the filter in bursts
+    p_sensor->sample_interval = 0;
+#else
+    p_sensor->sample_interval = p_sensor->p_driver->sample_interval << p_sensor->adapt_shift;
+#endif
+    if ((0 != p_sensor->sample_interval) && (p_sensor->sample_interval < timeout) &&
+        (triggers || (0 != p_sensor->fast_publish_period)))
+    {
+        if (!mesh_sched_is_timer_in_use(&p_sensor->sample_timer))
+        {
+            mesh_sched_start_timer(&p_sensor->sample_timer, p_sensor->sample_interval);
+        }
+    }
+    else
+    {
+        mesh_sensor_stop_sampling(p_sensor);
+    }
+}
+
+
+/**
+ * Function         mesh_sensor_update_window
+ *
+ *                  Program the interrupt window of an interrupt driven sensor around the last
+ *                  published value, so that the sensor wakes the engine when a trigger delta
+ *                  is exceeded.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] triggers          : Trigger deltas are configured
+ * @return                      : None
+ */
+void mesh_sensor_update_window(mesh_sensor_t *p_sensor, wiced_bool_t triggers)
+{
+    int32_t low = INT32_MIN;
+    int32_t high = INT32_MAX;
+
+    // Programmed once the sensor hardware is initialized
+    if ((NULL == p_sensor->p_driver->set_window) || !mesh_sensors_started)
+    {
+        return;
+    }
+    if (!triggers)
+    {
+        p_sensor->p_driver->set_window(WICED_FALSE, p_sensor->sent_value, low, high);
+        return;
+    }
+
+    // The window holds the values between the trigger bounds
+    if (INT32_MAX != p_sensor->trigger.high)
+    {
+        high = p_sensor->trigger.high - 1;
+    }
+    if (INT32_MIN != p_sensor->trigger.low)
+    {
+        low = p_sensor->trigger.low + 1;
+    }
+
+    MESH_LOG_DEBUG(MESH_LOG_IRQ_WINDOW, p_sensor->property_id, low, high);
+    p_sensor->p_driver->set_window(WICED_TRUE, p_sensor->sent_value, low, high);
+}
+
 
-        WICED_BT_TRACE("Temperature sensor restart timer timeout:%d\n", timeout);
-        wiced_start_timer(&mesh_sensor_cadence_temp_timer, timeout);
+#if SENSOR_ALS_IRQ_MODE
+/**
+ * Function         mesh_sensor_als_irq
+ *
+ *                  The light level left the interrupt window, evaluate the cadence of the ALS sensor now
+ *
+ * @return                      : None
+ */
+void mesh_sensor_als_irq(void)
+{
+    mesh_sensor_t *p_sensor = &mesh_sensors[MESH_SENSOR_IDX_ALS];
+    uint32_t min_interval;
+    uint32_t sent_time;
+
+    if (NULL == p_sensor->p_config)
+    {
+        return;
     }
+    min_interval = p_sensor->p_config->cadence.min_interval;
+    sent_time = p_sensor->sent_time;
 
+    // Take a fresh reading, the cadence check below is then answered from the read cache
+    mesh_sensor_read(p_sensor, 0);
+    mesh_sensor_publish_timer_callback((TIMER_PARAM_TYPE)p_sensor);
+
+    // The thresholds only hold the 4 upper mantissa bits, so the window can be much narrower than
+    // the trigger deltas and the sensor interrupts on every conversion while it is outside.  If the
+    // value was not published, mask the interrupt and check again after the minimum interval.
+    if ((sent_time == p_sensor->sent_time) && (0 != min_interval))
+    {
+        p_sensor->p_driver->set_window(WICED_FALSE, 0, 0, 0);
+        if (mesh_sched_get_remaining(&p_sensor->timer) > min_interval)
+        {
+            mesh_sched_start_timer(&p_sensor->timer, min_interval);
+        }
+    }
 }
+#endif
 
 
 /**
@@ -354,7 +798,7 @@ void mesh_sensor_server_restart_timer(uint8_t element_idx, wiced_bt_mesh_core_co
 void mesh_sensor_server_config_change_handler(uint8_t element_idx, uint16_t event, uint16_t property_id, uint16_t setting_property_id)
 {
 
-    WICED_BT_TRACE("Mesh sensor server config change handler message: %d\n", event);
+    MESH_LOG_DEBUG(MESH_LOG_CONFIG_EVENT, event);
 
     switch (event)
     {
@@ -367,7 +811,7 @@ void mesh_sensor_server_config_change_handler(uint8_t element_idx, uint16_t even
         mesh_sensor_server_process_setting_changed(element_idx, property_id, setting_property_id);
         break;
     default:
-        WICED_BT_TRACE("Unknown event\n");
+        MESH_LOG_WARN(MESH_LOG_UNKNOWN_EVENT, event);
         break;
     }
 }
@@ -387,28 +831,46 @@ void mesh_sensor_server_config_change_handler(uint8_t element_idx, uint16_t even
 void mesh_sensor_server_report_handler(uint16_t event, uint8_t element_idx, void *p_get, void *p_ref_data)
 {
     wiced_bt_mesh_sensor_get_t *p_sensor_get = (wiced_bt_mesh_sensor_get_t *)p_get;
-    WICED_BT_TRACE("Mesh sensor server report handler message: %d\n", event);
+    mesh_sensor_t *p_sensor;
+    MESH_LOG_DEBUG(MESH_LOG_REPORT_EVENT, event);
 
     switch (event)
     {
     case WICED_BT_MESH_SENSOR_GET:
+    {
+        MESH_PROBE_START(MESH_PROBE_GET);
 
-        if(MESH_ALS_SENSOR_ELEMENT_INDEX == element_idx)
-        {
-            mesh_sensor_sent_lux_value = sensor_get_light_level();
-            WICED_BT_TRACE("Ambient light level:%d lux\n", mesh_sensor_sent_lux_value);
-        }
-        if(MESH_TEMP_SENSOR_ELEMENT_INDEX == element_idx)
+        // A get without property id reports all sensors of the element
+        for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
         {
-            mesh_sensor_sent_temp_value = sensor_get_temperature();
-            WICED_BT_TRACE("Temperature value:%d.%d DegC\n", (mesh_sensor_sent_temp_value/2),(mesh_sensor_sent_temp_value%2)*5);
+            if ((p_sensor->element_idx == element_idx) &&
+                ((0 == p_sensor_get->property_id) || (p_sensor->property_id == p_sensor_get->property_id)))
+            {
+                // Polling clients are answered from the last reading while it is fresh
+                mesh_sensor_store_value(p_sensor, mesh_sensor_read(p_sensor, p_sensor->max_age));
+                MESH_LOG_DEBUG(MESH_LOG_GET_VALUE, p_sensor->property_id, p_sensor->sent_value,
+                               p_sensor->cache_hits, p_sensor->cache_misses);
+            }
         }
 
         // tell mesh models library that data is ready to be shipped out, the library will get data from mesh_config
-        wiced_bt_mesh_model_sensor_server_data(element_idx, p_sensor_get->property_id, p_ref_data);
+        mesh_sensor_server_data(element_idx, p_sensor_get->property_id, p_ref_data);
+        MESH_PROBE_STOP(MESH_PROBE_GET);
+        break;
+    }
+
+    case WICED_BT_MESH_SENSOR_COLUMN_GET:
+        // The columns are kept up to date as history bins close, the library looks up the requested column in mesh_config
+        mesh_sensor_server_data(element_idx, ((wiced_bt_mesh_sensor_column_get_data_t *)p_get)->property_id, p_ref_data);
+        break;
+
+    case WICED_BT_MESH_SENSOR_SERIES_GET:
+        // The library reports the columns within the requested range from mesh_config
+        mesh_sensor_server_data(element_idx, ((wiced_bt_mesh_sensor_series_get_data_t *)p_get)->property_id, p_ref_data);
         break;
+
     default:
-        WICED_BT_TRACE("Unknown event\n");
+        MESH_LOG_WARN(MESH_LOG_UNKNOWN_EVENT, event);
         break;
     }
 }
@@ -425,267 +887,466 @@ void mesh_sensor_server_report_handler(uint16_t event, uint8_t element_idx, void
  */
 void mesh_sensor_server_process_cadence_changed(uint8_t element_idx, uint16_t property_id)
 {
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = NULL;
-    uint8_t written_byte = 0;
-    wiced_result_t result =  WICED_SUCCESS;
-    p_sensor = &mesh_config.elements[element_idx].sensors[0];
+    mesh_sensor_t *p_sensor = mesh_sensor_find(element_idx, property_id);
 
-    WICED_BT_TRACE("Cadence changed property id:%04x\n", property_id);
-    WICED_BT_TRACE("Fast cadence period divisor:%d\n", p_sensor->cadence.fast_cadence_period_divisor);
-    WICED_BT_TRACE("Cadence trigger type percent:%d\n", p_sensor->cadence.trigger_type_percentage);
-    WICED_BT_TRACE("Trigger delta up:%d\n", p_sensor->cadence.trigger_delta_up);
-    WICED_BT_TRACE("Trigger delta down:%d\n", p_sensor->cadence.trigger_delta_down);
-    WICED_BT_TRACE("Cadence minimum Interval:%d\n", p_sensor->cadence.min_interval);
-    WICED_BT_TRACE("Fast cadence low:%d\n", p_sensor->cadence.fast_cadence_low);
-    WICED_BT_TRACE("Fast cadence high:%d\n", p_sensor->cadence.fast_cadence_high);
+    if (NULL == p_sensor)
+    {
+        MESH_LOG_WARN(MESH_LOG_CADENCE_UNKNOWN, property_id);
+        return;
+    }
 
-    if(MESH_ALS_SENSOR_ELEMENT_INDEX == element_idx)
+    MESH_LOG_INFO(MESH_LOG_CADENCE_TRIGGERS, property_id, p_sensor->p_config->cadence.fast_cadence_period_divisor,
+                  p_sensor->p_config->cadence.trigger_type_percentage, p_sensor->p_config->cadence.trigger_delta_up,
+                  p_sensor->p_config->cadence.trigger_delta_down);
+    MESH_LOG_INFO(MESH_LOG_CADENCE_FAST, p_sensor->p_config->cadence.min_interval,
+                  p_sensor->p_config->cadence.fast_cadence_low, p_sensor->p_config->cadence.fast_cadence_high);
+
+    /* Save sensor cadence setting to NVRAM, together with the other changes of a bulk configuration */
+    mesh_store_mark_dirty();
+
+    // The new trigger deltas are polled at the minimum interval until the value proves stable,
+    // and the value has to enter the new fast cadence range
+    p_sensor->adapt_shift = 0;
+    p_sensor->fast_active = WICED_FALSE;
+    p_sensor->fast_hold_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_sensor_server_restart_timer(p_sensor);
+}
+
+
+/**
+ * Function         mesh_sensor_publish_needed
+ *
+ *                  Decide whether the current value of a sensor has to be published.  Need to send
+ *                  data if publish period expired, or if value has changed more than specified in
+ *                  the triggers, or if value is in range of fast cadence values.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] cur_time          : Current time in msec
+ * @return                      : WICED_TRUE if the value has to be published
+ */
+wiced_bool_t mesh_sensor_publish_needed(mesh_sensor_t *p_sensor, uint32_t cur_time)
+{
+    uint32_t elapsed = cur_time - p_sensor->sent_time;
+    int32_t  current = p_sensor->current_value;
+
+    // check if publication timer expired
+    if ((0 != p_sensor->publish_period) && (elapsed >= p_sensor->publish_period))
     {
-        /* Save ambient light sensor cadence setting to NVRAM */
-        written_byte = wiced_hal_write_nvram(MESH_SENSOR_ALS_CADENCE_NVRAM_ID, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &result);
-        WICED_BT_TRACE("Cadence settings for ALS saved to NVRAM, %d bytes \n", written_byte);
+        MESH_LOG_DEBUG(MESH_LOG_PUBLISH_PERIOD, p_sensor->property_id);
+        return WICED_TRUE;
     }
 
-    if(MESH_TEMP_SENSOR_ELEMENT_INDEX == element_idx)
+    // still need to send if publication timer has not expired, but triggers are configured, and value
+    // changed too much.  The bounds are precomputed when the value is published.
+    if (current >= p_sensor->trigger.high)
     {
-        /* Save ambient light sensor cadence setting to NVRAM */
-        written_byte = wiced_hal_write_nvram(MESH_SENSOR_TEMP_CADENCE_NVRAM_ID, sizeof(wiced_bt_mesh_sensor_config_cadence_t), (uint8_t*)(&p_sensor->cadence), &result);
-        WICED_BT_TRACE("Cadence settings for thermistor saved to NVRAM, %d bytes \n", written_byte);
+        MESH_LOG_DEBUG(MESH_LOG_PUBLISH_DELTA_UP, p_sensor->property_id, current, p_sensor->sent_value);
+        return WICED_TRUE;
+    }
+    if (current <= p_sensor->trigger.low)
+    {
+        MESH_LOG_DEBUG(MESH_LOG_PUBLISH_DELTA_DOWN, p_sensor->property_id, current, p_sensor->sent_value);
+        return WICED_TRUE;
     }
 
-    mesh_sensor_server_restart_timer(element_idx,p_sensor);
+    // may still need to send if fast publication is configured, fast publish period expired and the
+    // value is in the fast cadence range.  If cadence high is more than cadence low, the range is
+    // between them, otherwise outside of them.
+    if ((0 != p_sensor->fast_publish_period) && (elapsed >= p_sensor->fast_publish_period) && p_sensor->fast_active)
+    {
+        if (!p_sensor->fast_range.outside)
+        {
+            MESH_LOG_DEBUG(MESH_LOG_PUBLISH_IN_RANGE, p_sensor->property_id);
+        }
+        else
+        {
+            MESH_LOG_DEBUG(MESH_LOG_PUBLISH_OUT_OF_RANGE, p_sensor->property_id);
+        }
+        return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+
+/**
+ * Function         mesh_sensor_fast_check
+ *
+ *                  Track whether the value of a sensor is in its fast cadence range.  The value
+ *                  is checked against the range with the hysteresis bands, and the sensor enters
+ *                  or leaves the fast cadence when the value has disagreed with the current state
+ *                  at every cadence check for the dwell time.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] cur_time          : Current time in msec
+ * @return                      : None
+ */
+void mesh_sensor_fast_check(mesh_sensor_t *p_sensor, uint32_t cur_time)
+{
+    wiced_bool_t in_range = mesh_trigger_in_range(&p_sensor->fast_range, p_sensor->current_value, p_sensor->fast_active);
+    uint32_t dwell = p_sensor->fast_active ? MESH_SENSOR_FAST_EXIT_DWELL_MS : MESH_SENSOR_FAST_ENTER_DWELL_MS;
+
+    if (in_range == p_sensor->fast_active)
+    {
+        p_sensor->fast_hold_time = cur_time;
+    }
+    else if ((cur_time - p_sensor->fast_hold_time) >= dwell)
+    {
+        MESH_LOG_DEBUG(MESH_LOG_FAST_CADENCE, p_sensor->property_id, in_range, p_sensor->current_value,
+                       cur_time - p_sensor->fast_hold_time);
+        p_sensor->fast_active = in_range;
+        p_sensor->fast_hold_time = cur_time;
+    }
 }
 
 
 /**
- * Function         mesh_sensor_publish_als_timer_callback
+ * Function         mesh_sensor_publish_timer_callback
  *
- *                  Publication timer callback for ALS sensor.  Need to send data if publish period
- *                  expired, or if value has changed more than specified in the triggers, or if value
- *                  is in range of fast cadence values.
+ *                  Publication timer callback shared by all sensors.  Reads the sensor and
+ *                  publishes the value when the cadence state requires it.
  *
- * @param[in] arg               : Callback timer parameter
+ * @param[in] arg               : Callback timer parameter, the sensor entry
  * @return                      : None
  */
-void mesh_sensor_publish_als_timer_callback(TIMER_PARAM_TYPE arg)
+void mesh_sensor_publish_timer_callback(TIMER_PARAM_TYPE arg)
 {
-    wiced_bt_mesh_event_t *p_event;
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = (wiced_bt_mesh_core_config_sensor_t *)arg;
-    wiced_bool_t pub_needed = WICED_FALSE;
+    mesh_sensor_t *p_sensor = (mesh_sensor_t *)arg;
+    MESH_PROBE_START(MESH_PROBE_CADENCE);
+
+#if LOW_POWER_NODE
+    mesh_sensor_read_burst(p_sensor);
+#else
+    mesh_sensor_refresh(p_sensor, p_sensor->max_age);
+#endif
+    mesh_sensor_cadence_check(p_sensor);
+    MESH_PROBE_STOP(MESH_PROBE_CADENCE);
+}
+
+
+/**
+ * Function         mesh_sensor_cadence_check
+ *
+ *                  Publish the current value of a sensor when the cadence state requires it,
+ *                  and restart its cadence timer.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_cadence_check(mesh_sensor_t *p_sensor)
+{
+    uint32_t min_interval = p_sensor->p_config->cadence.min_interval;
     uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+    wiced_bool_t publish;
 
-    /* Read ambient light level */
-    mesh_sensor_current_lux_value = sensor_get_light_level();
+    if ((cur_time - p_sensor->sent_time) < min_interval)
+    {
+        MESH_LOG_DEBUG(MESH_LOG_MIN_INTERVAL, p_sensor->property_id, cur_time - p_sensor->sent_time, min_interval);
+        mesh_sched_start_timer(&p_sensor->timer, min_interval - cur_time + p_sensor->sent_time);
+        return;
+    }
 
-    if ((cur_time - mesh_sensor_sent_lux_time) < p_sensor->cadence.min_interval)
+    MESH_PROBE_START(MESH_PROBE_DECIDE);
+    if (0 != p_sensor->fast_publish_period)
     {
-        WICED_BT_TRACE("Time since last publish of ALS, time:%d ms interval:%d ms\n", (cur_time - mesh_sensor_sent_lux_time), p_sensor->cadence.min_interval);
-        wiced_start_timer(&mesh_sensor_cadence_als_timer, (p_sensor->cadence.min_interval - cur_time + mesh_sensor_sent_lux_time));
+        mesh_sensor_fast_check(p_sensor, cur_time);
     }
-    else
+    publish = mesh_sensor_publish_needed(p_sensor, cur_time);
+    MESH_PROBE_STOP(MESH_PROBE_DECIDE);
+
+    if (publish)
     {
-        // check if publication timer expired
-        if ((mesh_sensor_publish_lux_period != 0) && (cur_time - mesh_sensor_sent_lux_time >= mesh_sensor_publish_lux_period))
-        {
-            WICED_BT_TRACE("Publish needed for ALS \n");
-            pub_needed = WICED_TRUE;
-        }
-        // still need to send if publication timer has not expired, but triggers are configured, and value
-        // changed too much
-        if (!pub_needed && ((p_sensor->cadence.trigger_delta_up != 0) || (p_sensor->cadence.trigger_delta_down != 0)))
-        {
-            if (!p_sensor->cadence.trigger_type_percentage)
-            {
-                WICED_BT_TRACE("Native current ALS value:%d sent:%d delta:%d/%d\n",
-                        mesh_sensor_current_lux_value, mesh_sensor_sent_lux_value, p_sensor->cadence.trigger_delta_up, p_sensor->cadence.trigger_delta_down);
+        mesh_sensor_store_value(p_sensor, p_sensor->current_value);
+        p_sensor->sent_time = cur_time;
 
-                if (((p_sensor->cadence.trigger_delta_up != 0)   && (mesh_sensor_current_lux_value >= (mesh_sensor_sent_lux_value + p_sensor->cadence.trigger_delta_up))) ||
-                    ((p_sensor->cadence.trigger_delta_down != 0) && (mesh_sensor_current_lux_value <= (mesh_sensor_sent_lux_value - p_sensor->cadence.trigger_delta_down))))
-                {
-                    WICED_BT_TRACE("Publish needed native value for ALS\n");
-                    pub_needed = WICED_TRUE;
-                }
-            }
-            else
-            {
-                // need to calculate percentage of the increase or decrease.  The deltas are in 0.01%.
-                if ((p_sensor->cadence.trigger_delta_up != 0) && (mesh_sensor_current_lux_value > mesh_sensor_sent_lux_value))
-                {
-                    WICED_BT_TRACE("Delta up for ALS:%d\n", ((uint32_t)(mesh_sensor_current_lux_value - mesh_sensor_sent_lux_value) * 10000 / mesh_sensor_current_lux_value));
-                    if (((uint32_t)(mesh_sensor_current_lux_value - mesh_sensor_sent_lux_value) * 10000 / mesh_sensor_current_lux_value) > p_sensor->cadence.trigger_delta_up)
-                    {
-                        WICED_BT_TRACE("Publish needed percent delta up for ALS:%d\n", ((mesh_sensor_current_lux_value - mesh_sensor_sent_lux_value) * 10000 / mesh_sensor_current_lux_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if ((p_sensor->cadence.trigger_delta_down != 0) && (mesh_sensor_current_lux_value < mesh_sensor_sent_lux_value))
-                {
-                    WICED_BT_TRACE("Delta down for ALS:%d\n", ((uint32_t)(mesh_sensor_sent_lux_value - mesh_sensor_current_lux_value) * 10000 / mesh_sensor_current_lux_value));
-                    if (((uint32_t)(mesh_sensor_sent_lux_value - mesh_sensor_current_lux_value) * 10000 / mesh_sensor_current_lux_value) > p_sensor->cadence.trigger_delta_down)
-                    {
-                        WICED_BT_TRACE("Publish needed percent delta down for ALS:%d\n", ((mesh_sensor_sent_lux_value - mesh_sensor_current_lux_value) * 10000 / mesh_sensor_current_lux_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-            }
-        }
-        // may still need to send if fast publication is configured
-        if (!pub_needed && (mesh_sensor_fast_publish_lux_period != 0))
-        {
-            // check if fast publish period expired
-            if (cur_time - mesh_sensor_sent_lux_time >= mesh_sensor_fast_publish_lux_period)
-            {
-                // if cadence high is more than cadence low, to publish, the value should be in range
-                if (p_sensor->cadence.fast_cadence_high >= p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((mesh_sensor_current_lux_value >= p_sensor->cadence.fast_cadence_low) &&
-                        (mesh_sensor_current_lux_value <= p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Publish needed in range for ALS\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if (p_sensor->cadence.fast_cadence_high < p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((mesh_sensor_current_lux_value > p_sensor->cadence.fast_cadence_low) ||
-                        (mesh_sensor_current_lux_value < p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Publish needed out of range for ALS\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-            }
-        }
+        MESH_LOG_INFO(MESH_LOG_PUBLISH_VALUE, p_sensor->property_id, p_sensor->sent_value, p_sensor->sent_time);
+        mesh_sensor_publish(p_sensor);
+    }
 
-        if (pub_needed)
-        {
-            mesh_sensor_sent_lux_value  = mesh_sensor_current_lux_value;
-            mesh_sensor_sent_lux_time   = cur_time;
+    mesh_sensor_adapt(p_sensor, publish);
+    mesh_sensor_server_restart_timer(p_sensor);
+}
 
-            WICED_BT_TRACE("Publish value for ALS:%d lux, time:%d ms\n", mesh_sensor_sent_lux_value, mesh_sensor_sent_lux_time);
-            wiced_bt_mesh_model_sensor_server_data(MESH_ALS_SENSOR_ELEMENT_INDEX, WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL, NULL);
 
-        }
+/**
+ * Function         mesh_sensor_adapt_shift
+ *
+ *                  Compute the trigger polling shift of a sensor from the change of its value since
+ *                  the previous cadence check.  The interval doubles while the change, over twice
+ *                  the interval, stays well short of the trigger bound the value moves towards.  It
+ *                  drops back to the minimum interval when the change over one more interval would
+ *                  come close to the bound.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : Shift of the next polling interval
+ */
+uint8_t mesh_sensor_adapt_shift(mesh_sensor_t *p_sensor)
+{
+    int64_t change = (int64_t)p_sensor->current_value - p_sensor->adapt_value;
+    int64_t high = (int64_t)p_sensor->trigger.high - p_sensor->current_value;
+    int64_t low = (int64_t)p_sensor->current_value - p_sensor->trigger.low;
+    int64_t headroom;
 
-        mesh_sensor_server_restart_timer(MESH_ALS_SENSOR_ELEMENT_INDEX,p_sensor);
+    // Distance to the bound the value moves towards, to the nearer one when it holds still
+    if (change > 0)
+    {
+        headroom = high;
+    }
+    else if (change < 0)
+    {
+        headroom = low;
+        change = -change;
+    }
+    else
+    {
+        headroom = (low < high) ? low : high;
     }
+
+    if (change * MESH_SENSOR_ADAPTIVE_MARGIN >= headroom)
+    {
+        return 0;
+    }
+    if ((2 * change * MESH_SENSOR_ADAPTIVE_MARGIN < headroom) && (p_sensor->adapt_shift < MESH_SENSOR_ADAPTIVE_MAX_SHIFT))
+    {
+        return p_sensor->adapt_shift + 1;
+    }
+    return p_sensor->adapt_shift;
 }
 
 
 /**
- * Function         mesh_sensor_publish_temp_timer_callback
+ * Function         mesh_sensor_adapt
  *
- *                  Publication timer callback for temperature sensor.  Need to send data if publish
- *                  period expired, or if value has changed more than specified in the triggers, or
- *                  if value is in range of fast cadence values.
+ *                  Adapt the trigger polling interval of a sensor to the movement of its value at
+ *                  a cadence check.  A published value starts over at the minimum interval.
  *
- * @param[in] arg               : Callback timer parameter
+ * @param[in] p_sensor          : Sensor entry
+ * @param[in] published         : The value was published by this check
  * @return                      : None
  */
-void mesh_sensor_publish_temp_timer_callback(TIMER_PARAM_TYPE arg)
+void mesh_sensor_adapt(mesh_sensor_t *p_sensor, wiced_bool_t published)
 {
-    wiced_bt_mesh_event_t *p_event;
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = (wiced_bt_mesh_core_config_sensor_t *)arg;
-    wiced_bool_t pub_needed = WICED_FALSE;
-    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+    uint8_t shift = published ? 0 : mesh_sensor_adapt_shift(p_sensor);
+
+    p_sensor->adapt_value = p_sensor->current_value;
+    if (shift != p_sensor->adapt_shift)
+    {
+        MESH_LOG_DEBUG(MESH_LOG_ADAPT_INTERVAL, p_sensor->property_id, shift, p_sensor->current_value,
+                       p_sensor->trigger.low, p_sensor->trigger.high);
+        p_sensor->adapt_shift = shift;
+    }
+}
+
 
-    /* Read the temperature */
-    mesh_sensor_current_temp_value = sensor_get_temperature();
+/**
+ * Function         mesh_sensor_sample_timer_callback
+ *
+ *                  Sampling timer callback shared by all sensors.  Adds a sample to the sensor
+ *                  filter so that the cadence engine reads a value averaged over the interval,
+ *                  and keeps the read cache fresh for polling clients.  A sample which brings the
+ *                  value close to a trigger bound ends a lengthened polling interval with a cadence
+ *                  check right away.
+ *
+ * @param[in] arg               : Callback timer parameter, the sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_sample_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_sensor_t *p_sensor = (mesh_sensor_t *)arg;
 
-    if ((cur_time - mesh_sensor_sent_temp_time) < p_sensor->cadence.min_interval)
+    mesh_sensor_refresh(p_sensor, 0);
+    mesh_sched_start_timer(&p_sensor->sample_timer, p_sensor->sample_interval);
+    if ((0 != p_sensor->adapt_shift) && (0 == mesh_sensor_adapt_shift(p_sensor)))
     {
-        WICED_BT_TRACE("Time since last publish of temperature, time:%d ms interval:%d ms\n", (cur_time - mesh_sensor_sent_temp_time), p_sensor->cadence.min_interval);
-        wiced_start_timer(&mesh_sensor_cadence_temp_timer, p_sensor->cadence.min_interval - cur_time + mesh_sensor_sent_temp_time);
+        mesh_sensor_cadence_check(p_sensor);
     }
-    else
+}
+
+
+#if LOW_POWER_NODE
+/**
+ * Function         mesh_sensor_read_burst
+ *
+ *                  Read a sensor for a cadence check of a Low Power Node.  The node takes no filter
+ *                  samples between the friend polls, so the read feeds the filter MESH_LPN_FILTER_BURST
+ *                  samples back to back, and the filter follows a step of the reading within one check.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_read_burst(mesh_sensor_t *p_sensor)
+{
+    uint8_t i;
+
+    if (!mesh_sensors_started)
+    {
+        mesh_sensor_start();
+    }
+    for (i = 1; (i < MESH_LPN_FILTER_BURST) && (0 != p_sensor->p_driver->sample_interval); i++)
+    {
+        p_sensor->p_driver->read();
+    }
+    mesh_sensor_refresh(p_sensor, 0);
+}
+#endif
+
+
+/**
+ * Function         mesh_sensor_stop_sampling
+ *
+ *                  Stop the filter samples of a sensor.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_stop_sampling(mesh_sensor_t *p_sensor)
+{
+    mesh_sched_stop_timer(&p_sensor->sample_timer);
+}
+
+
+/**
+ * Function         mesh_sensor_history_timer_callback
+ *
+ *                  Close the history bin of every sensor.  A sensor which was not read during
+ *                  the bin, because no cadence is configured, is read once for the bin.  The
+ *                  Friend and replay protection counters are checked on the same timer.
+ *
+ * @param[in] arg               : Callback timer parameter, not used
+ * @return                      : None
+ */
+void mesh_sensor_history_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_sensor_t *p_sensor;
+
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
     {
-        // check if publication timer expired
-        if ((mesh_sensor_publish_temp_period != 0) && ((cur_time - mesh_sensor_sent_temp_time) >= mesh_sensor_publish_temp_period))
+        if (0 == p_sensor->history.samples)
         {
-            WICED_BT_TRACE("Publish needed for temperature sensor\n");
-            pub_needed = WICED_TRUE;
+            mesh_sensor_read(p_sensor, 0);
         }
-        // still need to send if publication timer has not expired, but triggers are configured, and value
-        // changed too much
-        if (!pub_needed && ((p_sensor->cadence.trigger_delta_up != 0) || (p_sensor->cadence.trigger_delta_down != 0)))
-        {
-            if (!p_sensor->cadence.trigger_type_percentage)
-            {
-                WICED_BT_TRACE("Native current value of for temperature:%d sent:%d delta:%d/%d\n",
-                        mesh_sensor_current_temp_value, mesh_sensor_sent_temp_value, p_sensor->cadence.trigger_delta_up, p_sensor->cadence.trigger_delta_down);
+        mesh_history_close_bin(&p_sensor->history);
+        mesh_sensor_update_columns(p_sensor);
+    }
 
-                if (((p_sensor->cadence.trigger_delta_up != 0)   && (mesh_sensor_current_temp_value >= (mesh_sensor_sent_temp_value + p_sensor->cadence.trigger_delta_up))) ||
-                    ((p_sensor->cadence.trigger_delta_down != 0) && (mesh_sensor_current_temp_value <= (mesh_sensor_sent_temp_value - p_sensor->cadence.trigger_delta_down))))
-                {
-                    WICED_BT_TRACE("Publish needed native value for temperature\n");
-                    pub_needed = WICED_TRUE;
-                }
-            }
-            else
+#if MESH_CAPACITY_SIM_COUNTERS
+    mesh_capacity_check();
+#endif
+
+    mesh_sched_start_timer(&mesh_sensor_history_timer, MESH_SENSOR_HISTORY_BIN_MS);
+}
+
+
+/**
+ * Function         mesh_sensor_publish
+ *
+ *                  Queue the value of a sensor for publishing.  If other sensors of the same
+ *                  element are not due yet, the value waits up to MESH_SENSOR_BATCH_WINDOW_MS
+ *                  for them so that all values go out in a single Sensor Status message.
+ *
+ * @param[in] p_sensor          : Sensor entry
+ * @return                      : None
+ */
+void mesh_sensor_publish(mesh_sensor_t *p_sensor)
+{
+    mesh_sensor_t *p_other;
+
+    p_sensor->pub_pending = WICED_TRUE;
+
+    for (p_other = mesh_sensors; (0 != MESH_SENSOR_BATCH_WINDOW_MS) && (p_other < &mesh_sensors[MESH_SENSOR_COUNT]); p_other++)
+    {
+        if ((p_other->element_idx == p_sensor->element_idx) && !p_other->pub_pending)
+        {
+            if (!mesh_sched_is_timer_in_use(&mesh_sensor_batch_timer))
             {
-                // need to calculate percentage of the increase or decrease.  The deltas are in 0.01%.
-                if ((p_sensor->cadence.trigger_delta_up != 0) && (mesh_sensor_current_temp_value > mesh_sensor_sent_temp_value))
-                {
-                    WICED_BT_TRACE("Delta up for temperature sensor:%d\n", ((uint32_t)(mesh_sensor_current_temp_value - mesh_sensor_sent_temp_value) * 10000 / mesh_sensor_current_temp_value));
-                    if (((uint32_t)(mesh_sensor_current_temp_value - mesh_sensor_sent_temp_value) * 10000 / mesh_sensor_current_temp_value) > p_sensor->cadence.trigger_delta_up)
-                    {
-                        WICED_BT_TRACE("Publish needed percent delta up for temperature:%d\n", ((mesh_sensor_current_temp_value - mesh_sensor_sent_temp_value) * 10000 / mesh_sensor_current_temp_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if ((p_sensor->cadence.trigger_delta_down != 0) && (mesh_sensor_current_temp_value < mesh_sensor_sent_temp_value))
-                {
-                    WICED_BT_TRACE("Delta down for temperature:%d\n", ((uint32_t)(mesh_sensor_sent_temp_value - mesh_sensor_current_temp_value) * 10000 / mesh_sensor_current_temp_value));
-                    if (((uint32_t)(mesh_sensor_sent_temp_value - mesh_sensor_current_temp_value) * 10000 / mesh_sensor_current_temp_value) > p_sensor->cadence.trigger_delta_down)
-                    {
-                        WICED_BT_TRACE("Pub needed percent delta down for temperature:%d\n", ((mesh_sensor_sent_temp_value - mesh_sensor_current_temp_value) * 10000 / mesh_sensor_current_temp_value));
-                        pub_needed = WICED_TRUE;
-                    }
-                }
+                mesh_sched_start_timer(&mesh_sensor_batch_timer, MESH_SENSOR_BATCH_WINDOW_MS);
             }
+            return;
+        }
+    }
+
+    // Every sensor of the element is due, no need to wait
+    mesh_sensor_batch_flush();
+}
+
+
+/**
+ * Function         mesh_sensor_batch_flush
+ *
+ *                  Publish all queued values.  When several sensors of an element are queued,
+ *                  the values of all sensors of the element are marshalled into one Sensor
+ *                  Status message; the sensors which were not due publish their last sample.
+ *
+ * @return                      : None
+ */
+void mesh_sensor_batch_flush(void)
+{
+    uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
+    mesh_sensor_t *p_sensor, *p_other;
+    uint8_t pending;
+
+    mesh_sched_stop_timer(&mesh_sensor_batch_timer);
+
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
+    {
+        if (!p_sensor->pub_pending)
+        {
+            continue;
         }
-        // may still need to send if fast publication is configured
-        if (!pub_needed && (mesh_sensor_fast_publish_temp_period != 0))
+
+        pending = 0;
+        for (p_other = p_sensor; p_other < &mesh_sensors[MESH_SENSOR_COUNT]; p_other++)
         {
-            // check if fast publish period expired
-            if (cur_time - mesh_sensor_sent_temp_time >= mesh_sensor_fast_publish_temp_period)
+            if ((p_other->element_idx == p_sensor->element_idx) && p_other->pub_pending)
             {
-                // if cadence high is more than cadence low, to publish, the value should be in range
-                if (p_sensor->cadence.fast_cadence_high >= p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((mesh_sensor_current_temp_value >= p_sensor->cadence.fast_cadence_low) &&
-                        (mesh_sensor_current_temp_value <= p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Publish needed in range for temperature\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
-                else if (p_sensor->cadence.fast_cadence_high < p_sensor->cadence.fast_cadence_low)
-                {
-                    if ((mesh_sensor_current_temp_value > p_sensor->cadence.fast_cadence_low) ||
-                        (mesh_sensor_current_temp_value < p_sensor->cadence.fast_cadence_high))
-                    {
-                        WICED_BT_TRACE("Publish needed out of range for temperature\n");
-                        pub_needed = WICED_TRUE;
-                    }
-                }
+                pending++;
             }
         }
 
-        if (pub_needed)
+        if (1 == pending)
         {
-            mesh_sensor_sent_temp_value  = mesh_sensor_current_temp_value;
-            mesh_sensor_sent_temp_time   = cur_time;
-
-            WICED_BT_TRACE("Publish temperature value:%d, time:%d ms\n", mesh_sensor_sent_temp_value, mesh_sensor_sent_temp_time);
-            wiced_bt_mesh_model_sensor_server_data(MESH_TEMP_SENSOR_ELEMENT_INDEX, WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE, NULL);
+            p_sensor->pub_pending = WICED_FALSE;
+            MESH_PROBE_START(MESH_PROBE_PUBLISH);
+            mesh_sensor_server_data(p_sensor->element_idx, p_sensor->property_id, NULL);
+            MESH_PROBE_STOP(MESH_PROBE_PUBLISH);
+            continue;
         }
 
-        mesh_sensor_server_restart_timer(MESH_TEMP_SENSOR_ELEMENT_INDEX,p_sensor);
+        // Property id 0 publishes all sensors of the element in one message
+        for (p_other = mesh_sensors; p_other < &mesh_sensors[MESH_SENSOR_COUNT]; p_other++)
+        {
+            if (p_other->element_idx != p_sensor->element_idx)
+            {
+                continue;
+            }
+            if (!p_other->pub_pending)
+            {
+                mesh_sensor_store_value(p_other, p_other->current_value);
+                p_other->sent_time = cur_time;
+            }
+            p_other->pub_pending = WICED_FALSE;
+        }
+        MESH_LOG_DEBUG(MESH_LOG_PUBLISH_BATCH, pending, p_sensor->element_idx);
+        MESH_PROBE_START(MESH_PROBE_PUBLISH);
+        mesh_sensor_server_data(p_sensor->element_idx, 0, NULL);
+        MESH_PROBE_STOP(MESH_PROBE_PUBLISH);
     }
 }
 
 
+/**
+ * Function         mesh_sensor_batch_timer_callback
+ *
+ *                  Batch window expired, publish the queued values
+ *
+ * @param[in] arg               : Not used
+ * @return                      : None
+ */
+void mesh_sensor_batch_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_sensor_batch_flush();
+}
+
+
 /**
  * Function         mesh_sensor_server_process_setting_changed
  *
@@ -699,7 +1360,7 @@ void mesh_sensor_publish_temp_timer_callback(TIMER_PARAM_TYPE arg)
  */
 void mesh_sensor_server_process_setting_changed(uint8_t element_idx, uint16_t property_id, uint16_t setting_property_id)
 {
-    WICED_BT_TRACE("Mesh sensor setting changed, property id:%x, setting property id:%x\n", property_id, setting_property_id);
+    MESH_LOG_INFO(MESH_LOG_SETTING_CHANGED, property_id, setting_property_id);
 }
 
 
@@ -718,57 +1379,36 @@ void mesh_sensor_server_status_changed(uint8_t element_idx, uint8_t *p_data, uin
     uint16_t property_id;
     uint16_t prop_value_len;
     uint32_t cur_time = wiced_bt_mesh_core_get_tick_count();
-    wiced_bt_mesh_core_config_sensor_t *p_sensor = NULL;
+    mesh_sensor_t *p_sensor = NULL;
+    uint32_t min_interval;
 
     STREAM_TO_UINT16(property_id, p_data);
     STREAM_TO_UINT16(prop_value_len, p_data);
 
-    if ((MESH_SENSOR_ALS_PAYLOAD_LENGTH <= length) && (0 == element_idx) && (property_id == MESH_ALS_SENSOR_PROPERTY_ID) &&
-                                                (prop_value_len == MESH_ALS_SENSOR_VALUE_LEN))
-    {
-        mesh_sensor_current_lux_value = p_data[0];
-        WICED_BT_TRACE("New ambient light value:%d lux\n", mesh_sensor_current_lux_value);
+    p_sensor = mesh_sensor_find(element_idx, property_id);
 
-        p_sensor = &mesh_config.elements[element_idx].sensors[0];
+    if ((NULL == p_sensor) || (0 == property_id) || (prop_value_len != p_sensor->p_config->prop_value_len) ||
+        ((uint32_t)MESH_SENSOR_PAYLOAD_LENGTH(prop_value_len) > length))
+    {
+        MESH_LOG_ERROR(MESH_LOG_INVALID_PARAMS, element_idx, property_id, prop_value_len);
+        return;
+    }
 
-        // Cannot send pubs more often than cadence.min_interval
-        if ((cur_time - mesh_sensor_sent_lux_time) < p_sensor->cadence.min_interval)
-        {
-            WICED_BT_TRACE("Not enough time since last ambient light value published\n");
+    MESH_LOG_DEBUG(MESH_LOG_NEW_VALUE, p_sensor->property_id, p_data[0]);
+    min_interval = p_sensor->p_config->cadence.min_interval;
 
-            // if timer is running, the value will be sent, when needed, otherwise, start the time.
-            wiced_start_timer(&mesh_sensor_cadence_als_timer, p_sensor->cadence.min_interval + mesh_sensor_sent_lux_time - cur_time);
-        }
-        else
-        {
-            // the timer callback function sends value change notification if it is appropriate
-            mesh_sensor_publish_als_timer_callback((TIMER_PARAM_TYPE)p_sensor);
-        }
-    }
-    else if ((MESH_SENSOR_TEMP_PAYLOAD_LENGTH <= length) && (0 == element_idx) && (property_id == MESH_TEMP_SENSOR_PROPERTY_ID) &&
-                                                     (prop_value_len == MESH_TEMP_SENSOR_VALUE_LEN))
+    // Cannot send pubs more often than cadence.min_interval
+    if ((cur_time - p_sensor->sent_time) < min_interval)
     {
-        mesh_sensor_current_temp_value = p_data[0];
-        WICED_BT_TRACE("New temperature value:%d.%d DegC\n", (mesh_sensor_sent_temp_value/2),(mesh_sensor_sent_temp_value%2)*5);
-        p_sensor = &mesh_config.elements[element_idx].sensors[0];
+        MESH_LOG_DEBUG(MESH_LOG_NOT_ENOUGH_TIME, p_sensor->property_id);
 
-        // Cannot send pubs more often than cadence.min_interval
-        if ((cur_time - mesh_sensor_sent_temp_time) < p_sensor->cadence.min_interval)
-        {
-            WICED_BT_TRACE("Not enough time since last temperature published\n");
-
-            // if timer is running, the value will be sent, when needed, otherwise, start the time.
-            wiced_start_timer(&mesh_sensor_cadence_temp_timer, p_sensor->cadence.min_interval + mesh_sensor_sent_temp_time - cur_time);
-        }
-        else
-        {
-            // the timer callback function sends value change notification if it is appropriate
-            mesh_sensor_publish_temp_timer_callback((TIMER_PARAM_TYPE)p_sensor);
-        }
+        // if timer is running, the value will be sent, when needed, otherwise, start the time.
+        mesh_sched_start_timer(&p_sensor->timer, min_interval + p_sensor->sent_time - cur_time);
     }
     else
     {
-        WICED_BT_TRACE("Mesh sensor server invalid params idx:%d prop:%04x len:%d\n", element_idx, property_id, prop_value_len);
+        // the timer callback function sends value change notification if it is appropriate
+        mesh_sensor_publish_timer_callback((TIMER_PARAM_TYPE)p_sensor);
     }
 }
 
@@ -811,11 +1451,11 @@ wiced_bool_t mesh_app_adv_config(uint8_t *device_name, uint16_t appearance)
     result = wiced_bt_mesh_set_raw_scan_response_data(num_elem, adv_elem);
     if(WICED_TRUE == result)
     {
-        WICED_BT_TRACE("Advertising in the name \"%s\"\n",wiced_bt_cfg_settings.device_name);
+        MESH_LOG_INFO(MESH_LOG_ADV_NAME);
     }
     else
     {
-        WICED_BT_TRACE("Failed to set scan response data \n");
+        MESH_LOG_ERROR(MESH_LOG_SCAN_RSP_FAILED);
     }
 
     return result;
@@ -837,29 +1477,55 @@ wiced_bool_t mesh_app_adv_config(uint8_t *device_name, uint16_t appearance)
  */
 wiced_bool_t mesh_app_notify_period_set(uint8_t element_idx, uint16_t company_id, uint16_t model_id, uint32_t period)
 {
+    mesh_sensor_t *p_sensor;
 
-    if (((element_idx != MESH_ALS_SENSOR_ELEMENT_INDEX ) && (element_idx != MESH_TEMP_SENSOR_ELEMENT_INDEX)) ||
+    if ((NULL == mesh_sensor_find(element_idx, 0)) ||
             (company_id != MESH_COMPANY_ID_BT_SIG) || (model_id != WICED_BT_MESH_CORE_MODEL_ID_SENSOR_SRV))
 
     {
         return WICED_FALSE;
     }
 
-    if(MESH_ALS_SENSOR_ELEMENT_INDEX == element_idx)
+    // The publication period belongs to the sensor server model, it applies to every property on the element
+    for (p_sensor = mesh_sensors; p_sensor < &mesh_sensors[MESH_SENSOR_COUNT]; p_sensor++)
     {
-        WICED_BT_TRACE("Ambient light sensor data send period:%d ms\n", period);
-        mesh_sensor_publish_lux_period = period;
+        if (p_sensor->element_idx == element_idx)
+        {
+            MESH_LOG_INFO(MESH_LOG_SEND_PERIOD, p_sensor->property_id, period);
+            p_sensor->publish_period = period;
+            p_sensor->adapt_shift = 0;
+            mesh_sensor_server_restart_timer(p_sensor);
+        }
     }
 
-    if(MESH_TEMP_SENSOR_ELEMENT_INDEX == element_idx)
-    {
-        WICED_BT_TRACE("Temperature sensor data send period:%d ms\n", period);
-        mesh_sensor_publish_temp_period = period;
-    }
+    return WICED_TRUE;
+}
 
-    mesh_sensor_server_restart_timer(element_idx,&mesh_config.elements[element_idx].sensors[0]);
 
-    return WICED_TRUE;
+/**
+ * Function         mesh_app_proc_rx_cmd
+ *
+ *                  Process the WICED HCI commands not handled by the mesh application library
+ *
+ * @param[in] opcode            : WICED HCI opcode
+ * @param[in] p_data            : Command parameters
+ * @param[in] length            : Length of the parameters
+ * @return                      : WICED_TRUE if the command was processed
+ */
+uint32_t mesh_app_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    if (mesh_capacity_hci_command(opcode, p_data, length))
+    {
+        return WICED_TRUE;
+    }
+#if MESH_PROBE_ENABLE
+    if (mesh_probe_hci_command(opcode, p_data, length))
+    {
+        return WICED_TRUE;
+    }
+#endif
+    MESH_LOG_DEBUG(MESH_LOG_UNKNOWN_HCI_COMMAND, opcode);
+    return WICED_FALSE;
 }
 
 
@@ -873,8 +1539,7 @@ wiced_bool_t mesh_app_notify_period_set(uint8_t element_idx, uint16_t company_id
  */
 void mesh_app_factory_reset(void)
 {
-    wiced_hal_delete_nvram(MESH_SENSOR_ALS_CADENCE_NVRAM_ID, NULL);
-    wiced_hal_delete_nvram(MESH_SENSOR_TEMP_CADENCE_NVRAM_ID, NULL);
+    mesh_store_erase();
 }
 
 /*END of FILE */
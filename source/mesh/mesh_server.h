@@ -45,11 +45,56 @@
 #include "wiced_bt_cfg.h"
 #include "wiced_bt_mesh_app.h"
 #include "wiced_timer.h"
+#include "mesh_sched.h"
+#include "mesh_history.h"
+#include "mesh_trigger.h"
+#include "sensors.h"
 
-void mesh_sensor_cadence_init_temp_timer();
-void mesh_sensor_cadence_init_als_timer();
-void mesh_sensor_init_value();
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+
+/*
+ * Driver and cadence state of one sensor property served by the hub. The
+ * cadence engine in mesh_server.c walks a table of these, so adding a sensor is
+ * a new driver and a new table entry rather than a new timer callback.
+ */
+typedef struct
+{
+    const sensor_driver_t               *p_driver;              // Sensor driver
+    uint32_t                            max_age;                // Age in msec up to which a reading answers a Sensor Get
+    uint8_t                             element_idx;            // Element the sensor property lives on, found in mesh_config
+    uint16_t                            property_id;            // Sensor property id of the driver
+    wiced_bt_mesh_core_config_sensor_t  *p_config;              // Sensor configuration in mesh_config
+    mesh_sched_timer_t                  timer;                  // Cadence timer on the sensor scheduler
+    mesh_sched_timer_t                  sample_timer;           // Filter sampling timer on the sensor scheduler
+    uint32_t                            sample_interval;        // Filter sample interval in msec, scaled with the polling interval
+    int32_t                             current_value;          // Last value read from the sensor
+    uint32_t                            read_time;              // Time stamp when current_value was read
+    uint32_t                            cache_hits;             // Reads answered with current_value
+    uint32_t                            cache_misses;           // Reads which went to the sensor hardware
+    int32_t                             sent_value;             // Last value published
+    uint32_t                            sent_time;              // Time stamp when value was published
+    mesh_trigger_t                      trigger;                // Trigger bounds around sent_value
+    uint32_t                            publish_period;         // Publish period in msec
+    uint32_t                            fast_publish_period;    // Publish period in msec when values are in fast cadence range
+    mesh_trigger_range_t                fast_range;             // Fast cadence range with its hysteresis bands
+    wiced_bool_t                        fast_active;            // Value is in the fast cadence range
+    uint32_t                            fast_hold_time;         // Time stamp when the value last agreed with fast_active
+    uint8_t                             adapt_shift;            // Trigger polling interval is min_interval << adapt_shift
+    int32_t                             adapt_value;            // Value at the previous cadence check
+    wiced_bool_t                        pub_pending;            // Value waits to be published with other sensors of the element
+    mesh_history_t                      history;                // Past readings served as Sensor Series columns
+} mesh_sensor_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_sensor_cadence_init_timers(void);
+void mesh_sensor_start_deferred(uint32_t boot_time);
 void mesh_sensor_server_init_model(wiced_bool_t is_provisioned);
+int32_t mesh_sensor_read_value(uint8_t sensor_idx);
+wiced_bool_t mesh_sensor_get_cache_stats(uint8_t element_idx, uint16_t property_id, uint32_t *p_hits, uint32_t *p_misses);
 wiced_bool_t mesh_app_adv_config(uint8_t *device_name, uint16_t appearance);
 
 #endif /* MESH_SERVER_H_ */
@@ -0,0 +1,309 @@
+/******************************************************************************
+* File Name:   mesh_store.c
+*
+* Description: This file has the implementation of the persistence of the
+*              sensor configuration. The cadence of every sensor property is
+*              kept in one versioned NVRAM record, which is written a while
+*              after a change and only when its content changed.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "wiced_bt_mesh_app.h"
+#include "wiced_bt_mesh_core.h"
+#include "mesh_cfg.h"
+#include "mesh_sched.h"
+#include "mesh_log.h"
+#include "mesh_store.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Cadence of each sensor as stored by earlier versions of the application
+#define MESH_STORE_LEGACY_ALS_NVRAM_ID          WICED_NVRAM_VSID_START
+#define MESH_STORE_LEGACY_TEMP_NVRAM_ID         (WICED_NVRAM_VSID_START + 24u)
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t    property_id;
+    uint16_t    nvram_id;
+} mesh_store_legacy_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static void mesh_store_commit_timer_callback(TIMER_PARAM_TYPE arg);
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static const mesh_store_legacy_t mesh_store_legacy[] =
+{
+    { WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_LIGHT_LEVEL, MESH_STORE_LEGACY_ALS_NVRAM_ID },
+    { WICED_BT_MESH_PROPERTY_PRESENT_AMBIENT_TEMPERATURE, MESH_STORE_LEGACY_TEMP_NVRAM_ID },
+};
+
+static mesh_sched_timer_t   mesh_store_commit_timer;
+static wiced_bool_t         mesh_store_dirty = WICED_FALSE;
+static mesh_store_record_t  mesh_store_image;              // Content of the record in NVRAM
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_store_find_config
+ *
+ *                  Find the configuration of a sensor property in mesh_config
+ *
+ * @param[in] property_id       : Sensor property id
+ * @return                      : Sensor configuration, NULL if the node does not serve the property
+ */
+static wiced_bt_mesh_core_config_sensor_t *mesh_store_find_config(uint16_t property_id)
+{
+    uint8_t e, i;
+
+    for (e = 0; e < mesh_config.elements_num; e++)
+    {
+        for (i = 0; i < mesh_config.elements[e].sensors_num; i++)
+        {
+            if (mesh_config.elements[e].sensors[i].property_id == property_id)
+            {
+                return &mesh_config.elements[e].sensors[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * Function         mesh_store_build
+ *
+ *                  Build the record from the current configuration of all sensor properties
+ *
+ * @param[out] p_record         : Record
+ * @return                      : None
+ */
+static void mesh_store_build(mesh_store_record_t *p_record)
+{
+    wiced_bt_mesh_core_config_sensor_t *p_config;
+    uint8_t e, i;
+
+    // Cleared as a whole, so that records of the same configuration compare equal
+    memset(p_record, 0, sizeof(*p_record));
+    p_record->version = MESH_STORE_VERSION;
+
+    for (e = 0; e < mesh_config.elements_num; e++)
+    {
+        for (i = 0; (i < mesh_config.elements[e].sensors_num) && (p_record->count < MESH_STORE_MAX_SENSORS); i++)
+        {
+            p_config = &mesh_config.elements[e].sensors[i];
+            p_record->sensors[p_record->count].property_id = p_config->property_id;
+            p_record->sensors[p_record->count].cadence = p_config->cadence;
+            p_record->count++;
+        }
+    }
+}
+
+
+/**
+ * Function         mesh_store_commit
+ *
+ *                  Write the record when the configuration differs from the record in NVRAM
+ *
+ * @return                      : WICED_SUCCESS when the record in NVRAM holds the configuration
+ */
+static wiced_result_t mesh_store_commit(void)
+{
+    mesh_store_record_t record;
+    wiced_result_t result = WICED_SUCCESS;
+
+    mesh_store_dirty = WICED_FALSE;
+    mesh_store_build(&record);
+    if (0 == memcmp(&record, &mesh_store_image, sizeof(record)))
+    {
+        MESH_LOG_DEBUG(MESH_LOG_STORE_UNCHANGED);
+        return WICED_SUCCESS;
+    }
+
+    wiced_hal_write_nvram(MESH_STORE_NVRAM_ID, sizeof(record), (uint8_t *)&record, &result);
+    MESH_LOG_INFO(MESH_LOG_STORE_COMMIT, record.count, result);
+    if (WICED_SUCCESS == result)
+    {
+        mesh_store_image = record;
+    }
+    return result;
+}
+
+
+/**
+ * Function         mesh_store_commit_timer_callback
+ *
+ *                  Write the changes collected since the first change
+ *
+ * @param[in] arg               : Not used
+ * @return                      : None
+ */
+void mesh_store_commit_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    mesh_store_commit();
+}
+
+
+/**
+ * Function         mesh_store_init
+ *
+ *                  Initialize the commit timer, the sensor scheduler has to be initialized
+ *
+ * @return                      : None
+ */
+void mesh_store_init(void)
+{
+    mesh_store_dirty = WICED_FALSE;
+    mesh_sched_init_timer(&mesh_store_commit_timer, &mesh_store_commit_timer_callback, 0);
+}
+
+
+/**
+ * Function         mesh_store_load
+ *
+ *                  Restore the configuration of the sensor properties from the record.  Without a
+ *                  record, the cadences stored one per NVRAM id by earlier versions are moved into
+ *                  a new record.  The earlier records are deleted only once the new record is
+ *                  written, so that a failed write loses nothing.
+ *
+ * @return                      : None
+ */
+void mesh_store_load(void)
+{
+    wiced_bt_mesh_core_config_sensor_t *p_config;
+    wiced_bt_mesh_sensor_config_cadence_t cadence;
+    wiced_result_t result = WICED_ERROR;
+    wiced_bool_t migrated = WICED_FALSE;
+    uint16_t len;
+    uint8_t i;
+
+    memset(&mesh_store_image, 0, sizeof(mesh_store_image));
+    len = wiced_hal_read_nvram(MESH_STORE_NVRAM_ID, sizeof(mesh_store_image), (uint8_t *)&mesh_store_image, &result);
+    if ((WICED_SUCCESS == result) && (sizeof(mesh_store_image) == len) &&
+        (MESH_STORE_VERSION == mesh_store_image.version) && (mesh_store_image.count <= MESH_STORE_MAX_SENSORS))
+    {
+        for (i = 0; i < mesh_store_image.count; i++)
+        {
+            p_config = mesh_store_find_config(mesh_store_image.sensors[i].property_id);
+            if (NULL != p_config)
+            {
+                p_config->cadence = mesh_store_image.sensors[i].cadence;
+            }
+        }
+        MESH_LOG_INFO(MESH_LOG_STORE_LOADED, mesh_store_image.count);
+        return;
+    }
+    memset(&mesh_store_image, 0, sizeof(mesh_store_image));
+
+    for (i = 0; i < sizeof(mesh_store_legacy) / sizeof(mesh_store_legacy[0]); i++)
+    {
+        p_config = mesh_store_find_config(mesh_store_legacy[i].property_id);
+        len = wiced_hal_read_nvram(mesh_store_legacy[i].nvram_id, sizeof(cadence), (uint8_t *)&cadence, &result);
+        if ((WICED_SUCCESS == result) && (sizeof(cadence) == len))
+        {
+            if (NULL != p_config)
+            {
+                p_config->cadence = cadence;
+            }
+            migrated = WICED_TRUE;
+        }
+    }
+    if (!migrated || (WICED_SUCCESS != mesh_store_commit()))
+    {
+        return;
+    }
+    MESH_LOG_INFO(MESH_LOG_STORE_MIGRATED);
+    for (i = 0; i < sizeof(mesh_store_legacy) / sizeof(mesh_store_legacy[0]); i++)
+    {
+        wiced_hal_delete_nvram(mesh_store_legacy[i].nvram_id, &result);
+    }
+}
+
+
+/**
+ * Function         mesh_store_mark_dirty
+ *
+ *                  Note a configuration change.  The record is written MESH_STORE_COMMIT_DELAY_MS
+ *                  after the first change, with all changes made until then.
+ *
+ * @return                      : None
+ */
+void mesh_store_mark_dirty(void)
+{
+    if (mesh_store_dirty)
+    {
+        return;
+    }
+    mesh_store_dirty = WICED_TRUE;
+    mesh_sched_start_timer(&mesh_store_commit_timer, MESH_STORE_COMMIT_DELAY_MS);
+}
+
+
+/**
+ * Function         mesh_store_erase
+ *
+ *                  Delete the record and the records of earlier versions, on factory reset
+ *
+ * @return                      : None
+ */
+void mesh_store_erase(void)
+{
+    uint8_t i;
+
+    mesh_sched_stop_timer(&mesh_store_commit_timer);
+    mesh_store_dirty = WICED_FALSE;
+    memset(&mesh_store_image, 0, sizeof(mesh_store_image));
+
+    wiced_hal_delete_nvram(MESH_STORE_NVRAM_ID, NULL);
+    for (i = 0; i < sizeof(mesh_store_legacy) / sizeof(mesh_store_legacy[0]); i++)
+    {
+        wiced_hal_delete_nvram(mesh_store_legacy[i].nvram_id, NULL);
+    }
+}
+
+
+/*END of FILE */
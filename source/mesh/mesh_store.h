@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name:   mesh_store.h
+*
+* Description: This file has the macros, structures and function prototypes
+*              of the persistence of the sensor configuration in one
+*              versioned NVRAM record.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_STORE_H_
+#define MESH_STORE_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "wiced_bt_mesh_models.h"
+#include "wiced_hal_nvram.h"
+#include "mesh_manifest.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// NVRAM id of the configuration record
+#define MESH_STORE_NVRAM_ID                     (WICED_NVRAM_VSID_START + 1u)
+
+// Layout version of the record, a record of another version is ignored
+#define MESH_STORE_VERSION                      1
+
+// Sensor properties the record has room for, one per sensor of the manifest.  A record written
+// for a manifest with another number of sensors has another length and is not loaded.
+#define MESH_STORE_MAX_SENSORS                  MESH_SENSOR_COUNT
+
+// A configuration change is written this many msec after the first change, so that
+// the changes of a bulk configuration are written together
+#ifndef MESH_STORE_COMMIT_DELAY_MS
+#define MESH_STORE_COMMIT_DELAY_MS              2000
+#endif
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t                                property_id;
+    wiced_bt_mesh_sensor_config_cadence_t   cadence;
+} mesh_store_sensor_t;
+
+// Configuration of all sensor properties of the node
+typedef struct
+{
+    uint8_t                 version;                            // MESH_STORE_VERSION
+    uint8_t                 count;                              // Number of sensors used
+    mesh_store_sensor_t     sensors[MESH_STORE_MAX_SENSORS];
+} mesh_store_record_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_store_init(void);
+void mesh_store_load(void);
+void mesh_store_mark_dirty(void);
+void mesh_store_erase(void);
+
+#endif /* MESH_STORE_H_ */
@@ -0,0 +1,331 @@
+/******************************************************************************
+* File Name:   mesh_stream.c
+*
+* Description: This file shows the implementation of the vendor sensor stream
+*              model. While a client has set a sample interval, every sensor
+*              is read at that interval and its readings are packed, as the
+*              difference to the reading before in a zigzag varint, into Data
+*              messages which fill one unsegmented access message.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "wiced_bt_mesh_core.h"
+#include "mesh_cfg.h"
+#include "mesh_manifest.h"
+#include "mesh_sched.h"
+#include "mesh_server.h"
+#include "mesh_log.h"
+#include "mesh_stream.h"
+
+#if MESH_SENSOR_STREAM
+
+// Fails to compile when a Data message cannot hold one sample of the largest encoding,
+// or the sensor position does not fit in the header
+typedef char mesh_stream_data_len_check[((MESH_STREAM_DATA_MAX_LEN >= 1 + MESH_STREAM_VARINT_MAX_LEN) &&
+    (MESH_SENSOR_COUNT <= MESH_STREAM_HDR_SENSOR_MASK + 1)) ? 1 : -1];
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+// Data message of one sensor being filled
+typedef struct
+{
+    uint8_t     data[MESH_STREAM_DATA_MAX_LEN];     // Header byte and the encoded samples
+    uint8_t     len;                                // Bytes used in data
+    uint8_t     samples;                            // Samples in data
+    uint8_t     seq;                                // Sequence number of the next message
+    int32_t     last_value;                         // Last sample, the next one is encoded as the difference
+} mesh_stream_buf_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static uint8_t mesh_stream_encode(uint8_t *p_data, int32_t value);
+static void mesh_stream_add(uint8_t sensor_idx, int32_t value);
+static void mesh_stream_send(uint8_t sensor_idx, wiced_bool_t held);
+static void mesh_stream_flush(void);
+static void mesh_stream_send_status(wiced_bt_mesh_event_t *p_event);
+static void mesh_stream_timer_callback(TIMER_PARAM_TYPE arg);
+
+/******************************************************************************
+ *                          Variables Definitions
+ ******************************************************************************/
+static mesh_stream_buf_t    mesh_stream_bufs[MESH_SENSOR_COUNT];
+static mesh_sched_timer_t   mesh_stream_timer;
+static uint16_t             mesh_stream_interval = 0;   // Sample interval in msec, 0 while stopped
+static uint8_t              mesh_stream_samples = 0;    // Most samples per Data message, 0 for as many as fit
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/**
+ * Function         mesh_stream_init
+ *
+ *                  Initialize the sample timer of the stream, which stays stopped until a client
+ *                  sets a sample interval
+ *
+ * @return                      : None
+ */
+void mesh_stream_init(void)
+{
+    memset(mesh_stream_bufs, 0, sizeof(mesh_stream_bufs));
+    mesh_stream_interval = 0;
+    mesh_stream_samples = 0;
+    mesh_sched_init_timer(&mesh_stream_timer, &mesh_stream_timer_callback, 0);
+}
+
+
+/**
+ * Function         mesh_stream_encode
+ *
+ *                  Zigzag encode a signed value into a varint
+ *
+ * @param[out] p_data           : MESH_STREAM_VARINT_MAX_LEN bytes for the varint
+ * @param[in] value             : Value to encode
+ * @return                      : Bytes written
+ */
+uint8_t mesh_stream_encode(uint8_t *p_data, int32_t value)
+{
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    uint8_t len = 0;
+
+    while (zigzag >= 0x80)
+    {
+        p_data[len++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    p_data[len++] = (uint8_t)zigzag;
+    return len;
+}
+
+
+/**
+ * Function         mesh_stream_add
+ *
+ *                  Pack a sample of a sensor into its Data message.  A sample which does not fit
+ *                  sends the message first and starts the next one.  The message is sent as soon
+ *                  as it holds the set number of samples, unless that is 0 for as many as fit.
+ *
+ * @param[in] sensor_idx        : Position of the sensor in mesh_manifest.h
+ * @param[in] value             : Sensor value
+ * @return                      : None
+ */
+void mesh_stream_add(uint8_t sensor_idx, int32_t value)
+{
+    mesh_stream_buf_t *p_buf = &mesh_stream_bufs[sensor_idx];
+    uint8_t varint[MESH_STREAM_VARINT_MAX_LEN];
+    uint8_t len;
+
+    len = mesh_stream_encode(varint, (0 == p_buf->samples) ? value : value - p_buf->last_value);
+    if ((0 != p_buf->samples) && (p_buf->len + len > MESH_STREAM_DATA_MAX_LEN))
+    {
+        mesh_stream_send(sensor_idx, WICED_TRUE);
+        len = mesh_stream_encode(varint, value);
+    }
+    if (0 == p_buf->samples)
+    {
+        p_buf->len = 1;     // Header, set when sent
+    }
+
+    memcpy(&p_buf->data[p_buf->len], varint, len);
+    p_buf->len += len;
+    p_buf->samples++;
+    p_buf->last_value = value;
+
+    if ((0 != mesh_stream_samples) && (p_buf->samples >= mesh_stream_samples))
+    {
+        mesh_stream_send(sensor_idx, WICED_FALSE);
+    }
+}
+
+
+/**
+ * Function         mesh_stream_send
+ *
+ *                  Publish the Data message of a sensor
+ *
+ * @param[in] sensor_idx        : Position of the sensor in mesh_manifest.h
+ * @param[in] held              : The last sample of the message was taken one sample interval ago
+ * @return                      : None
+ */
+void mesh_stream_send(uint8_t sensor_idx, wiced_bool_t held)
+{
+    mesh_stream_buf_t *p_buf = &mesh_stream_bufs[sensor_idx];
+    wiced_bt_mesh_event_t *p_event;
+
+    p_buf->data[0] = sensor_idx | (uint8_t)((p_buf->seq & MESH_STREAM_HDR_SEQ_MASK) << MESH_STREAM_HDR_SEQ_SHIFT) |
+                     (held ? MESH_STREAM_HDR_HELD : 0);
+    p_buf->seq++;
+
+    // Publication of the model, dropped while none is configured
+    p_event = wiced_bt_mesh_create_event(0, MESH_COMPANY_ID, MESH_STREAM_MODEL_ID, 0, 0);
+    if (NULL != p_event)
+    {
+        p_event->opcode = MESH_STREAM_OPCODE_DATA;
+        wiced_bt_mesh_core_send(p_event, p_buf->data, p_buf->len, NULL);
+    }
+    MESH_LOG_DEBUG(MESH_LOG_STREAM_DATA, sensor_idx, p_buf->samples, p_buf->len);
+    p_buf->samples = 0;
+    p_buf->len = 0;
+}
+
+
+/**
+ * Function         mesh_stream_flush
+ *
+ *                  Send the samples waiting in the Data message of every sensor
+ *
+ * @return                      : None
+ */
+void mesh_stream_flush(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < MESH_SENSOR_COUNT; i++)
+    {
+        if (0 != mesh_stream_bufs[i].samples)
+        {
+            mesh_stream_send(i, WICED_FALSE);
+        }
+    }
+}
+
+
+/**
+ * Function         mesh_stream_timer_callback
+ *
+ *                  Read every sensor into its Data message and wait for the next sample
+ *
+ * @param[in] arg               : Not used
+ * @return                      : None
+ */
+void mesh_stream_timer_callback(TIMER_PARAM_TYPE arg)
+{
+    uint8_t i;
+
+    mesh_sched_start_timer(&mesh_stream_timer, mesh_stream_interval);
+    for (i = 0; i < MESH_SENSOR_COUNT; i++)
+    {
+        mesh_stream_add(i, mesh_sensor_read_value(i));
+    }
+}
+
+
+/**
+ * Function         mesh_stream_send_status
+ *
+ *                  Reply with the sample interval and the samples per Data message
+ *
+ * @param[in] p_event           : Received message, released here
+ * @return                      : None
+ */
+void mesh_stream_send_status(wiced_bt_mesh_event_t *p_event)
+{
+    uint8_t status[MESH_STREAM_STATUS_LEN];
+
+    status[0] = (uint8_t)mesh_stream_interval;
+    status[1] = (uint8_t)(mesh_stream_interval >> 8);
+    status[2] = mesh_stream_samples;
+
+    p_event = wiced_bt_mesh_create_reply_event(p_event);
+    if (NULL != p_event)
+    {
+        p_event->opcode = MESH_STREAM_OPCODE_STATUS;
+        wiced_bt_mesh_core_send(p_event, status, sizeof(status), NULL);
+    }
+}
+
+
+/**
+ * Function         mesh_stream_message_handler
+ *
+ *                  Process the messages of the vendor stream model.  Waiting samples are sent
+ *                  before the interval changes, so that the samples of a message are always
+ *                  one interval apart.  An interval below MESH_STREAM_MIN_INTERVAL_MS is raised
+ *                  to it, and the Status reports the interval applied.
+ *
+ * @param[in] p_event           : Received message, model_id 0xFFFF asks whether the opcode is ours
+ * @param[in] p_data            : Message parameters
+ * @param[in] data_len          : Length of the parameters
+ * @return                      : WICED_TRUE if the message belongs to the model
+ */
+wiced_bool_t mesh_stream_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    if ((MESH_COMPANY_ID != p_event->company_id) ||
+        ((MESH_STREAM_OPCODE_GET != p_event->opcode) && (MESH_STREAM_OPCODE_SET != p_event->opcode)))
+    {
+        return WICED_FALSE;
+    }
+    if (0xFFFF == p_event->model_id)
+    {
+        return WICED_TRUE;
+    }
+
+    if (MESH_STREAM_OPCODE_SET == p_event->opcode)
+    {
+        if (MESH_STREAM_STATUS_LEN != data_len)
+        {
+            MESH_LOG_WARN(MESH_LOG_STREAM_INVALID, p_event->opcode, data_len);
+            wiced_bt_mesh_release_event(p_event);
+            return WICED_TRUE;
+        }
+        mesh_stream_flush();
+        mesh_stream_interval = (uint16_t)(p_data[0] | (p_data[1] << 8));
+        if ((0 != mesh_stream_interval) && (mesh_stream_interval < MESH_STREAM_MIN_INTERVAL_MS))
+        {
+            mesh_stream_interval = MESH_STREAM_MIN_INTERVAL_MS;
+        }
+        mesh_stream_samples = p_data[2];
+        if (0 != mesh_stream_interval)
+        {
+            mesh_sched_start_timer(&mesh_stream_timer, mesh_stream_interval);
+        }
+        else
+        {
+            mesh_sched_stop_timer(&mesh_stream_timer);
+        }
+        MESH_LOG_INFO(MESH_LOG_STREAM_SET, mesh_stream_interval, mesh_stream_samples);
+    }
+    mesh_stream_send_status(p_event);
+    return WICED_TRUE;
+}
+
+#endif /* MESH_SENSOR_STREAM */
+
+
+/*END of FILE */
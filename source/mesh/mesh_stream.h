@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name:   mesh_stream.h
+*
+* Description: This file is the header of the vendor sensor stream model,
+*              which packs consecutive readings of a sensor into one access
+*              message.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_STREAM_H_
+#define MESH_STREAM_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "wiced_bt_mesh_core.h"
+#include "mesh_cfg.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Vendor model of the sensor stream, under the company identifier of the node
+#define MESH_STREAM_MODEL_ID                    0x0001
+
+/*
+ * Vendor opcodes, sent as the 3-byte opcode 0xC0 | opcode followed by MESH_COMPANY_ID.
+ *
+ * Get          : no parameters, answered with a Status
+ * Set          : sample interval in msec (uint16), most samples per Data message (uint8, 0 for
+ *                as many as fit), answered with a Status. An interval of 0 stops the stream, an
+ *                interval below MESH_STREAM_MIN_INTERVAL_MS is raised to it.
+ * Status       : sample interval in msec (uint16) applied, most samples per Data message (uint8)
+ * Data         : published, one header byte and the samples of one sensor, see below
+ */
+#define MESH_STREAM_OPCODE_GET                  0x01
+#define MESH_STREAM_OPCODE_SET                  0x02
+#define MESH_STREAM_OPCODE_STATUS               0x03
+#define MESH_STREAM_OPCODE_DATA                 0x04
+
+#define MESH_STREAM_OPCODE_LEN                  3
+#define MESH_STREAM_STATUS_LEN                  3
+
+/*
+ * Data header byte: bits 0-3 position of the sensor in mesh_manifest.h, bits 4-6 sequence number
+ * of the sensor's Data messages modulo 8, bit 7 set when the message was held back by one sample
+ * interval because the sample taken then did not fit.  The header is followed by the first sample
+ * of the message, then the difference of each sample to the one before, each zigzag encoded (0, -1,
+ * 1, -2, ... map to 0, 1, 2, 3, ...) into a little endian base-128 varint whose bytes but the last
+ * have bit 7 set.  The samples are sensor values in the units of the sensor property, taken one
+ * sample interval apart; the last one is taken when the message is sent.
+ */
+#define MESH_STREAM_HDR_SENSOR_MASK             0x0F
+#define MESH_STREAM_HDR_SEQ_SHIFT               4
+#define MESH_STREAM_HDR_SEQ_MASK                0x07
+#define MESH_STREAM_HDR_HELD                    0x80
+
+#define MESH_STREAM_VARINT_MAX_LEN              5
+
+// Parameters of a Data message which fit in the access payload
+#define MESH_STREAM_DATA_MAX_LEN                (MESH_STREAM_MAX_ACCESS_LEN - MESH_STREAM_OPCODE_LEN)
+
+// Model entry of the element serving the stream
+#define MESH_MODEL_STREAM_SERVER \
+    { MESH_COMPANY_ID, MESH_STREAM_MODEL_ID, mesh_stream_message_handler, NULL, NULL }
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_stream_init(void);
+wiced_bool_t mesh_stream_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+#endif /* MESH_STREAM_H_ */
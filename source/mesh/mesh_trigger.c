@@ -0,0 +1,272 @@
+/******************************************************************************
+* File Name:   mesh_trigger.c
+*
+* Description: This file shows the trigger bounds of the sensor cadence. The
+*              trigger deltas are turned into absolute bounds when the
+*              cadence is set and when a value is published, so that checking
+*              a reading takes two comparisons and no division.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "mesh_trigger.h"
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+static int64_t mesh_trigger_div_floor(int64_t num, int64_t den);
+static int64_t mesh_trigger_div_ceil(int64_t num, int64_t den);
+static int64_t mesh_trigger_percent_high(int64_t sent, uint32_t delta);
+static int32_t mesh_trigger_clamp(int64_t value);
+static int64_t mesh_trigger_band(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t bound, wiced_bool_t up,
+                                 uint8_t hysteresis);
+
+/******************************************************************************
+*                                Function Definitions
+******************************************************************************/
+
+/* Division rounded towards minus infinity, den is positive */
+int64_t mesh_trigger_div_floor(int64_t num, int64_t den)
+{
+    int64_t quot = num / den;
+
+    if ((quot * den != num) && (num < 0))
+    {
+        quot--;
+    }
+    return quot;
+}
+
+
+/* Division rounded towards plus infinity, den is positive */
+int64_t mesh_trigger_div_ceil(int64_t num, int64_t den)
+{
+    return -mesh_trigger_div_floor(-num, den);
+}
+
+
+/**
+ * Function         mesh_trigger_percent_high
+ *
+ *                  Lowest value which has risen from sent by more than delta 0.01 % of
+ *                  itself.  The change of a value v, in whole 0.01 % of |v|, exceeds the
+ *                  delta when |v - sent| * 10000 >= (delta + 1) * |v|.  A change of sign
+ *                  exceeds any delta below 100 %, and is taken to exceed larger deltas too.
+ *                  The lower bound is the same computation with the signs swapped.
+ *
+ * @param[in] sent              : Last published value
+ * @param[in] delta             : Trigger delta in 0.01 %
+ * @return                      : Upper bound, INT64_MAX if no value exceeds the delta
+ */
+int64_t mesh_trigger_percent_high(int64_t sent, uint32_t delta)
+{
+    int64_t scale = MESH_TRIGGER_PERCENT_SCALE;
+    int64_t room  = scale - 1 - delta;
+    int64_t high;
+
+    // From a negative value, v * (scale + 1 + delta) >= sent * scale for v up to 0
+    if (sent < 0)
+    {
+        return mesh_trigger_div_ceil(sent * scale, scale + 1 + delta);
+    }
+
+    // From a positive value, v * room >= sent * scale.  A delta of 100 % or more is never
+    // exceeded, except by any rise from 0 at exactly 99.99 %.
+    if (room <= 0)
+    {
+        return ((0 == room) && (0 == sent)) ? 1 : INT64_MAX;
+    }
+    high = mesh_trigger_div_ceil(sent * scale, room);
+    return (high > sent) ? high : sent + 1;
+}
+
+
+/* Narrow a bound to the value range, a bound out of range is never reached */
+int32_t mesh_trigger_clamp(int64_t value)
+{
+    if (value > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return (int32_t)value;
+}
+
+
+/**
+ * Function         mesh_trigger_update
+ *
+ *                  Compute the trigger bounds around the last published value.  Called
+ *                  when the cadence is set and whenever the published value changes.
+ *
+ * @param[out] p_trigger        : Trigger bounds
+ * @param[in] p_cadence         : Sensor cadence
+ * @param[in] sent              : Last published value
+ * @return                      : None
+ */
+void mesh_trigger_update(mesh_trigger_t *p_trigger, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t sent)
+{
+    p_trigger->high = INT32_MAX;
+    p_trigger->low  = INT32_MIN;
+
+    if (!p_cadence->trigger_type_percentage)
+    {
+        // Publish when the value reaches sent + delta up or sent - delta down
+        if (0 != p_cadence->trigger_delta_up)
+        {
+            p_trigger->high = mesh_trigger_clamp((int64_t)sent + p_cadence->trigger_delta_up);
+        }
+        if (0 != p_cadence->trigger_delta_down)
+        {
+            p_trigger->low = mesh_trigger_clamp((int64_t)sent - p_cadence->trigger_delta_down);
+        }
+        return;
+    }
+
+    // Percentages are relative to the value, a fall is a rise of the negated values
+    if (0 != p_cadence->trigger_delta_up)
+    {
+        p_trigger->high = mesh_trigger_clamp(mesh_trigger_percent_high(sent, p_cadence->trigger_delta_up));
+    }
+    if (0 != p_cadence->trigger_delta_down)
+    {
+        p_trigger->low = mesh_trigger_clamp(-mesh_trigger_percent_high(-(int64_t)sent, p_cadence->trigger_delta_down));
+    }
+}
+
+
+/**
+ * Function         mesh_trigger_band
+ *
+ *                  Hysteresis band at a fast cadence bound, the given percentage of the trigger
+ *                  delta a value published at the bound would have in the given direction,
+ *                  rounded up so that a delta of one step still gives a band.  A disabled delta
+ *                  gives no band.
+ *
+ * @param[in] p_cadence         : Sensor cadence
+ * @param[in] bound             : Fast cadence bound
+ * @param[in] up                : Band above the bound, else below it
+ * @param[in] hysteresis        : Band in percent of the trigger delta
+ * @return                      : Band width
+ */
+int64_t mesh_trigger_band(const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t bound, wiced_bool_t up,
+                          uint8_t hysteresis)
+{
+    mesh_trigger_t trigger;
+
+    mesh_trigger_update(&trigger, p_cadence, bound);
+    if (up)
+    {
+        return (INT32_MAX == trigger.high) ? 0 : mesh_trigger_div_ceil(((int64_t)trigger.high - bound) * hysteresis, 100);
+    }
+    return (INT32_MIN == trigger.low) ? 0 : mesh_trigger_div_ceil(((int64_t)bound - trigger.low) * hysteresis, 100);
+}
+
+
+/**
+ * Function         mesh_trigger_range_update
+ *
+ *                  Compute the enter bounds of the fast cadence range.  Called when the cadence
+ *                  is set.  A value rising into the range at low, or falling into it at high, has
+ *                  to pass the bound by the band of the trigger delta it moves along to enter the
+ *                  range, so that a value wandering about a bound does not.  A bound at the end of
+ *                  the value range has no band, the values at the end would never enter.  With
+ *                  no hysteresis, the enter bounds are the fast cadence bounds.  When the range is
+ *                  narrower than its two bands, the bands would cross and no value would enter, so
+ *                  both enter bounds are moved to the middle of the range instead.
+ *
+ * @param[out] p_range          : Fast cadence range
+ * @param[in] p_cadence         : Sensor cadence
+ * @param[in] low               : Fast cadence low, native value
+ * @param[in] high              : Fast cadence high, native value
+ * @param[in] min               : Lowest value of the property
+ * @param[in] max               : Highest value of the property
+ * @param[in] hysteresis        : Bands in percent of the trigger deltas
+ * @return                      : None
+ */
+void mesh_trigger_range_update(mesh_trigger_range_t *p_range, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,
+                               int32_t low, int32_t high, int32_t min, int32_t max, uint8_t hysteresis)
+{
+    p_range->low        = low;
+    p_range->high       = high;
+    p_range->enter_low  = low;
+    p_range->enter_high = high;
+    if (low > min)
+    {
+        p_range->enter_low = mesh_trigger_clamp(low + mesh_trigger_band(p_cadence, low, WICED_TRUE, hysteresis));
+    }
+    if (high < max)
+    {
+        p_range->enter_high = mesh_trigger_clamp(high - mesh_trigger_band(p_cadence, high, WICED_FALSE, hysteresis));
+    }
+    p_range->outside    = (high < low);
+    if (!p_range->outside && (p_range->enter_low > p_range->enter_high))
+    {
+        p_range->enter_low  = (int32_t)(((int64_t)low + high) / 2);
+        p_range->enter_high = p_range->enter_low;
+    }
+}
+
+
+/**
+ * Function         mesh_trigger_in_range
+ *
+ *                  Check a value against the fast cadence range, with the bounds which apply
+ *                  to a value last found in or out of the range.  The fast cadence bounds
+ *                  belong to a range with high at or above low, and not to a range outside.
+ *
+ * @param[in] p_range           : Fast cadence range
+ * @param[in] value             : Sensor value
+ * @param[in] in_range          : The previous value was in range
+ * @return                      : WICED_TRUE if the value is in range
+ */
+wiced_bool_t mesh_trigger_in_range(const mesh_trigger_range_t *p_range, int32_t value, wiced_bool_t in_range)
+{
+    int32_t low  = in_range ? p_range->low : p_range->enter_low;
+    int32_t high = in_range ? p_range->high : p_range->enter_high;
+
+    if (p_range->outside)
+    {
+        return (value > low) || (value < high);
+    }
+    return (value >= low) && (value <= high);
+}
+
+
+/*END of FILE */
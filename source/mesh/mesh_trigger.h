@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name:   mesh_trigger.h
+*
+* Description: This file is the public interface of mesh_trigger.c, the
+*              precomputed trigger bounds of the sensor cadence.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MESH_TRIGGER_H_
+#define MESH_TRIGGER_H_
+
+#include "stdint.h"
+#include "wiced.h"
+#include "wiced_bt_mesh_models.h"
+
+/******************************************************************************
+ *                             Macros
+ ******************************************************************************/
+// Percentage trigger deltas are in 0.01 %
+#define MESH_TRIGGER_PERCENT_SCALE              10000
+
+// A value exceeds a trigger delta, two comparisons against the precomputed bounds
+#define MESH_TRIGGER_CROSSED(p_trigger, value)  (((value) >= (p_trigger)->high) || ((value) <= (p_trigger)->low))
+
+/******************************************************************************
+ *                              Structures
+ ******************************************************************************/
+/*
+ * Trigger deltas of a sensor cadence turned into absolute bounds around the last
+ * published value.  A value at or above high, or at or below low, exceeds a
+ * delta and is published.  A disabled bound is INT32_MAX or INT32_MIN, which
+ * no property value reaches.
+ */
+typedef struct
+{
+    int32_t     low;
+    int32_t     high;
+} mesh_trigger_t;
+
+/*
+ * Fast cadence range of a sensor cadence with a hysteresis band inside each
+ * bound.  A value enters the range when it is inside the enter bounds, and
+ * stays in it while it is inside the fast cadence bounds.  For a range with
+ * high below low, a value is in range above low or below high.
+ */
+typedef struct
+{
+    int32_t         low;
+    int32_t         high;
+    int32_t         enter_low;
+    int32_t         enter_high;
+    wiced_bool_t    outside;
+} mesh_trigger_range_t;
+
+/******************************************************************************
+ *                          Function Prototypes
+ ******************************************************************************/
+void mesh_trigger_update(mesh_trigger_t *p_trigger, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence, int32_t sent);
+void mesh_trigger_range_update(mesh_trigger_range_t *p_range, const wiced_bt_mesh_sensor_config_cadence_t *p_cadence,
+                               int32_t low, int32_t high, int32_t min, int32_t max, uint8_t hysteresis);
+wiced_bool_t mesh_trigger_in_range(const mesh_trigger_range_t *p_range, int32_t value, wiced_bool_t in_range);
+
+#endif /* MESH_TRIGGER_H_ */